@@ -0,0 +1,348 @@
+/*
+ *  action_storage.c
+ *  ObjectAL
+ *
+ *  Microbenchmark of OALActionManager's per-tick cost with many concurrent
+ *  actions, comparing the old storage with the slot storage.
+ *
+ *  - nested: The old layout. A target list searched linearly on add, a list
+ *            of actions per target searched linearly on remove, and four
+ *            messages per action per tick (elapsed get and set, duration,
+ *            updateCompletion:).
+ *  - slots:  Struct of arrays indexed by slot. Each action remembers its slot,
+ *            removal moves the last slot into the hole, and the tick calls one
+ *            pre-resolved update function per action.
+ *
+ *  Objective-C messages are stood in for by calls through function pointers
+ *  that the compiler can't inline. Every tick, kChurn actions finish and
+ *  kChurn new ones start, as happens with lots of short fades.
+ *
+ *  This is a model of the two layouts in plain C, not OALActionManager
+ *  itself: it leaves out the manager's lock, the snapshot that step: takes
+ *  so that updates run outside of it, and the Objective-C runtime. Use it to
+ *  compare the storage and dispatch patterns, and profile the real manager
+ *  (with Instruments) for absolute numbers.
+ *
+ *  Build and run (Linux or macOS):
+ *      cc -O2 action_storage.c -o action_storage
+ *      ./action_storage
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define kActionCount 10000
+#define kActionsPerTarget 4
+#define kTargetCount (kActionCount / kActionsPerTarget)
+#define kChurn 100
+#define kTicks 2000
+#define kTickTime (1.0f / 120.0f)
+
+typedef struct
+{
+	float value;
+} FakeTarget;
+
+typedef struct FakeAction FakeAction;
+
+typedef struct
+{
+	float (*getElapsed)(FakeAction*);
+	void (*setElapsed)(FakeAction*, float);
+	float (*getDuration)(FakeAction*);
+	void (*update)(FakeAction*, float);
+} FakeClass;
+
+struct FakeAction
+{
+	const FakeClass* isa;
+	FakeTarget* target;
+	float elapsed;
+	float duration;
+	float startValue;
+	float delta;
+	long managerIndex;
+};
+
+static FakeTarget g_targets[kTargetCount];
+static FakeAction g_actions[kActionCount + kChurn * kTicks];
+static int g_nextAction;
+
+
+/* Fake Messages */
+
+static __attribute__((noinline)) float getElapsed(FakeAction* action)
+{
+	return action->elapsed;
+}
+
+static __attribute__((noinline)) void setElapsed(FakeAction* action, float elapsed)
+{
+	action->elapsed = elapsed;
+}
+
+static __attribute__((noinline)) float getDuration(FakeAction* action)
+{
+	return action->duration;
+}
+
+static __attribute__((noinline)) void update(FakeAction* action, float proportionComplete)
+{
+	action->target->value = action->startValue + action->delta * proportionComplete;
+}
+
+static const FakeClass g_propertyActionClass = {getElapsed, setElapsed, getDuration, update};
+
+static FakeAction* newAction(unsigned int* seed)
+{
+	FakeAction* action = &g_actions[g_nextAction++];
+	*seed = *seed * 1103515245u + 12345u;
+	action->isa = &g_propertyActionClass;
+	action->target = &g_targets[(*seed >> 8) % kTargetCount];
+	action->elapsed = 0;
+	action->duration = 1.0f + (float)((*seed >> 16) % 1000) * 0.01f;
+	action->startValue = 0;
+	action->delta = 1;
+	action->managerIndex = -1;
+	return action;
+}
+
+
+/* Nested Storage */
+
+typedef struct
+{
+	FakeAction** actions;
+	int count;
+	int capacity;
+} ActionList;
+
+typedef struct
+{
+	FakeTarget** targets;
+	ActionList* targetActions;
+	int count;
+} NestedStorage;
+
+static void listAdd(ActionList* list, FakeAction* action)
+{
+	if(list->count == list->capacity)
+	{
+		list->capacity = list->capacity > 0 ? list->capacity * 2 : 5;
+		list->actions = realloc(list->actions, (size_t)list->capacity * sizeof(*list->actions));
+	}
+	list->actions[list->count++] = action;
+}
+
+static void nestedAdd(NestedStorage* storage, FakeAction* action)
+{
+	int index = -1;
+	for(int i = 0; i < storage->count; i++)
+	{
+		if(storage->targets[i] == action->target)
+		{
+			index = i;
+			break;
+		}
+	}
+	if(index < 0)
+	{
+		index = storage->count++;
+		storage->targets[index] = action->target;
+		memset(&storage->targetActions[index], 0, sizeof(ActionList));
+	}
+	listAdd(&storage->targetActions[index], action);
+}
+
+static void nestedRemove(NestedStorage* storage, FakeAction* action)
+{
+	for(int i = 0; i < storage->count; i++)
+	{
+		if(storage->targets[i] != action->target)
+		{
+			continue;
+		}
+		ActionList* list = &storage->targetActions[i];
+		for(int j = 0; j < list->count; j++)
+		{
+			if(list->actions[j] == action)
+			{
+				memmove(&list->actions[j], &list->actions[j + 1], (size_t)(list->count - j - 1) * sizeof(*list->actions));
+				list->count--;
+				break;
+			}
+		}
+		if(0 == list->count)
+		{
+			free(list->actions);
+			memmove(&storage->targets[i], &storage->targets[i + 1], (size_t)(storage->count - i - 1) * sizeof(*storage->targets));
+			memmove(&storage->targetActions[i], &storage->targetActions[i + 1], (size_t)(storage->count - i - 1) * sizeof(*storage->targetActions));
+			storage->count--;
+		}
+		return;
+	}
+}
+
+static void nestedTick(NestedStorage* storage, float elapsedTime)
+{
+	for(int i = 0; i < storage->count; i++)
+	{
+		ActionList* list = &storage->targetActions[i];
+		for(int j = 0; j < list->count; j++)
+		{
+			FakeAction* action = list->actions[j];
+			action->isa->setElapsed(action, action->isa->getElapsed(action) + elapsedTime);
+			float proportionComplete = action->isa->getElapsed(action) / action->isa->getDuration(action);
+			action->isa->update(action, proportionComplete < 1.0f ? proportionComplete : 1.0f);
+		}
+	}
+}
+
+
+/* Slot Storage */
+
+typedef struct
+{
+	FakeAction** actions;
+	void (**updates)(FakeAction*, float);
+	float* elapsed;
+	float* duration;
+	int count;
+} SlotStorage;
+
+static void slotAdd(SlotStorage* storage, FakeAction* action)
+{
+	int index = storage->count++;
+	storage->actions[index] = action;
+	storage->updates[index] = action->isa->update;
+	storage->elapsed[index] = action->elapsed;
+	storage->duration[index] = action->duration;
+	action->managerIndex = index;
+}
+
+static void slotRemove(SlotStorage* storage, FakeAction* action)
+{
+	long index = action->managerIndex;
+	int last = --storage->count;
+	action->managerIndex = -1;
+	if(index != last)
+	{
+		storage->actions[index] = storage->actions[last];
+		storage->updates[index] = storage->updates[last];
+		storage->elapsed[index] = storage->elapsed[last];
+		storage->duration[index] = storage->duration[last];
+		storage->actions[index]->managerIndex = index;
+	}
+}
+
+static void slotTick(SlotStorage* storage, float elapsedTime)
+{
+	int count = storage->count;
+	for(int i = 0; i < count; i++)
+	{
+		storage->elapsed[i] += elapsedTime;
+		float proportionComplete = storage->elapsed[i] / storage->duration[i];
+		storage->updates[i](storage->actions[i], proportionComplete < 1.0f ? proportionComplete : 1.0f);
+	}
+}
+
+
+/* Benchmark */
+
+static double nowSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Both runs start and stop the same actions in the same order. */
+static FakeAction* g_running[kActionCount];
+
+static double runNested(void)
+{
+	NestedStorage storage = {0};
+	storage.targets = calloc(kTargetCount, sizeof(*storage.targets));
+	storage.targetActions = calloc(kTargetCount, sizeof(*storage.targetActions));
+	unsigned int seed = 1;
+	g_nextAction = 0;
+
+	for(int i = 0; i < kActionCount; i++)
+	{
+		g_running[i] = newAction(&seed);
+		nestedAdd(&storage, g_running[i]);
+	}
+
+	double start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		for(int i = 0; i < kChurn; i++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			int victim = (int)((seed >> 8) % kActionCount);
+			nestedRemove(&storage, g_running[victim]);
+			g_running[victim] = newAction(&seed);
+			nestedAdd(&storage, g_running[victim]);
+		}
+		nestedTick(&storage, kTickTime);
+	}
+	double elapsed = nowSeconds() - start;
+
+	for(int i = 0; i < storage.count; i++)
+	{
+		free(storage.targetActions[i].actions);
+	}
+	free(storage.targets);
+	free(storage.targetActions);
+	return elapsed * 1e6 / kTicks;
+}
+
+static double runSlots(void)
+{
+	SlotStorage storage = {0};
+	storage.actions = calloc(kActionCount, sizeof(*storage.actions));
+	storage.updates = calloc(kActionCount, sizeof(*storage.updates));
+	storage.elapsed = calloc(kActionCount, sizeof(*storage.elapsed));
+	storage.duration = calloc(kActionCount, sizeof(*storage.duration));
+	unsigned int seed = 1;
+	g_nextAction = 0;
+
+	for(int i = 0; i < kActionCount; i++)
+	{
+		g_running[i] = newAction(&seed);
+		slotAdd(&storage, g_running[i]);
+	}
+
+	double start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		for(int i = 0; i < kChurn; i++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			int victim = (int)((seed >> 8) % kActionCount);
+			slotRemove(&storage, g_running[victim]);
+			g_running[victim] = newAction(&seed);
+			slotAdd(&storage, g_running[victim]);
+		}
+		slotTick(&storage, kTickTime);
+	}
+	double elapsed = nowSeconds() - start;
+
+	free(storage.actions);
+	free(storage.updates);
+	free(storage.elapsed);
+	free(storage.duration);
+	return elapsed * 1e6 / kTicks;
+}
+
+int main(void)
+{
+	printf("%d actions on %d targets, %d started and stopped per tick\n", kActionCount, kTargetCount, kChurn);
+	printf("%-8s%12.1f us per tick\n", "nested", runNested());
+	printf("%-8s%12.1f us per tick\n", "slots", runSlots());
+	return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ *  crossfade.c
+ *  ObjectAL
+ *
+ *  Checks OALCrossfade's curve (equal power, exact end frame, same output
+ *  whatever the block size), compares it against the old way of fading
+ *  music (two linear gain fades stepped at the action manager's 30 Hz tick),
+ *  then measures what mixing a stereo fade costs.
+ *
+ *  Build and run (Linux or macOS):
+ *      cc -O2 -I../ObjectAL/Support crossfade.c ../ObjectAL/Support/OALCrossfade.c -lm -o crossfade
+ *      ./crossfade
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "OALCrossfade.h"
+
+#define kFrequency 44100
+#define kFadeFrames kFrequency
+#define kChannels 2
+#define kActionTickRate 30
+#define kBenchSeconds 2
+
+static int g_failed = 0;
+
+static void check(int condition, const char* what)
+{
+	if(!condition)
+	{
+		printf("FAILED: %s\n", what);
+		g_failed = 1;
+	}
+}
+
+static double nowSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double toDecibels(double power)
+{
+	return 10.0 * log10(power);
+}
+
+
+/* Semantics */
+
+/* Mix a whole fade of constant full scale audio, in blocks of the given size. */
+static void mixInBlocks(int16_t* output, const int16_t* outgoing, const int16_t* incoming, int frames, int blockFrames)
+{
+	OALCrossfade fade;
+	OALCrossfadeInit(&fade, kFadeFrames);
+	for(int frame = 0; frame < frames; frame += blockFrames)
+	{
+		int count = frames - frame < blockFrames ? frames - frame : blockFrames;
+		OALCrossfadeMixInt16(&fade,
+							 outgoing + frame * kChannels,
+							 incoming + frame * kChannels,
+							 output + frame * kChannels,
+							 count,
+							 kChannels);
+	}
+}
+
+static void checkSemantics(void)
+{
+	int frames = kFadeFrames + 1000;
+	size_t samples = (size_t)frames * kChannels;
+	int16_t* outgoing = malloc(samples * sizeof(int16_t));
+	int16_t* incoming = malloc(samples * sizeof(int16_t));
+	int16_t* reference = malloc(samples * sizeof(int16_t));
+	int16_t* output = malloc(samples * sizeof(int16_t));
+	for(size_t i = 0; i < samples; i++)
+	{
+		outgoing[i] = 20000;
+		incoming[i] = -20000;
+	}
+
+	/* Gains stay on the equal power curve between exact points. */
+	OALCrossfade fade;
+	OALCrossfadeInit(&fade, kFadeFrames);
+	float outGain = 1, inGain = 0;
+	double worstPower = 0;
+	for(int frame = 0; frame < kFadeFrames; frame++)
+	{
+		int16_t a = 10000, b = 10000, mixed;
+		OALCrossfadeMixInt16(&fade, &a, NULL, &mixed, 1, 1);
+		outGain = (float)mixed / 10000.0f;
+		fade.position--;
+		OALCrossfadeMixInt16(&fade, NULL, &b, &mixed, 1, 1);
+		inGain = (float)mixed / 10000.0f;
+		double error = fabs(1.0 - (double)(outGain * outGain + inGain * inGain));
+		if(error > worstPower)
+		{
+			worstPower = error;
+		}
+	}
+	check(worstPower < 1e-3, "equal power");
+	check(OALCrossfadeFinished(&fade), "finished");
+
+	/* Block size doesn't change the result. */
+	mixInBlocks(reference, outgoing, incoming, frames, frames);
+	static const int blockSizes[] = {1, 7, 100, 4096};
+	for(size_t i = 0; i < sizeof(blockSizes) / sizeof(*blockSizes); i++)
+	{
+		mixInBlocks(output, outgoing, incoming, frames, blockSizes[i]);
+		check(0 == memcmp(output, reference, samples * sizeof(int16_t)), "same output for any block size");
+	}
+
+	/* Ends on the exact frame. */
+	check(reference[0] == 20000, "starts on outgoing");
+	check(reference[(kFadeFrames - 1) * kChannels] != -20000, "still fading on the last frame");
+	check(reference[kFadeFrames * kChannels] == -20000, "incoming only after the fade");
+
+	/* In place, and with the outgoing audio run out. */
+	memcpy(output, incoming, samples * sizeof(int16_t));
+	OALCrossfadeInit(&fade, kFadeFrames);
+	OALCrossfadeMixInt16(&fade, NULL, output, output, frames, kChannels);
+	check(output[0] == 0 && output[kFadeFrames * kChannels] == -20000, "in place without outgoing");
+
+	free(outgoing);
+	free(incoming);
+	free(reference);
+	free(output);
+}
+
+
+/* Against the old fade */
+
+static void compareWithSteppedFade(void)
+{
+	/* Two linear fades, with the gains only changing once per action tick. */
+	int framesPerTick = kFrequency / kActionTickRate;
+	double steppedDip = 1.0;
+	double steppedJump = 0;
+	double previous = 1.0;
+	for(int frame = 0; frame <= kFadeFrames; frame++)
+	{
+		double t = (double)(frame - frame % framesPerTick) / kFadeFrames;
+		double outGain = 1.0 - t;
+		double inGain = t;
+		double power = outGain * outGain + inGain * inGain;
+		if(power < steppedDip)
+		{
+			steppedDip = power;
+		}
+		if(fabs(outGain - previous) > steppedJump)
+		{
+			steppedJump = fabs(outGain - previous);
+		}
+		previous = outGain;
+	}
+
+	OALCrossfade fade;
+	OALCrossfadeInit(&fade, kFadeFrames);
+	double fadeDip = 1.0;
+	double fadeJump = 0;
+	float previousGain = 1.0f;
+	for(int frame = 0; frame <= kFadeFrames; frame++)
+	{
+		float outGain, inGain;
+		OALCrossfadeGains(&fade, frame, &outGain, &inGain);
+		double power = (double)(outGain * outGain + inGain * inGain);
+		if(power < fadeDip)
+		{
+			fadeDip = power;
+		}
+		if(fabs(outGain - previousGain) > fadeJump)
+		{
+			fadeJump = fabs(outGain - previousGain);
+		}
+		previousGain = outGain;
+	}
+
+	printf("1 second fade at %d Hz, uncorrelated music\n", kFrequency);
+	printf("%-22s%14s%22s\n", "", "worst dip", "biggest gain step");
+	printf("%-22s%11.2f dB%22.5f\n", "linear, 30 Hz steps", toDecibels(steppedDip), steppedJump);
+	printf("%-22s%11.2f dB%22.5f\n", "equal power, in-stream", toDecibels(fadeDip), fadeJump);
+	check(fadeDip > 0.999, "no dip");
+	check(fadeJump < steppedJump / 100, "smooth steps");
+}
+
+
+/* Speed */
+
+static double benchmark(void)
+{
+	int blockFrames = 4096;
+	size_t samples = (size_t)blockFrames * kChannels;
+	int16_t* outgoing = malloc(samples * sizeof(int16_t));
+	int16_t* incoming = malloc(samples * sizeof(int16_t));
+	int16_t* output = malloc(samples * sizeof(int16_t));
+	unsigned int seed = 1;
+	for(size_t i = 0; i < samples; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		outgoing[i] = (int16_t)((seed >> 8) & 0xffff);
+		incoming[i] = (int16_t)((seed >> 12) & 0xffff);
+	}
+
+	int64_t totalFrames = (int64_t)kBenchSeconds * 100 * kFrequency;
+	OALCrossfade fade;
+	OALCrossfadeInit(&fade, totalFrames);
+	double start = nowSeconds();
+	for(int64_t frame = 0; frame < totalFrames; frame += blockFrames)
+	{
+		OALCrossfadeMixInt16(&fade, outgoing, incoming, output, blockFrames, kChannels);
+	}
+	double elapsed = nowSeconds() - start;
+
+	free(outgoing);
+	free(incoming);
+	free(output);
+
+	/* Nanoseconds per stereo frame. */
+	return elapsed * 1e9 / (double)totalFrames;
+}
+
+int main(void)
+{
+	checkSemantics();
+	compareWithSteppedFade();
+
+	double cost = benchmark();
+	printf("mixing: %.2f ns per stereo frame (%.4f%% of one core in real time)\n",
+		   cost,
+		   cost * kFrequency / 1e7);
+
+	if(g_failed)
+	{
+		printf("FAILED\n");
+	}
+	return g_failed;
+}
@@ -0,0 +1,228 @@
+/*
+ *  ease_batch.c
+ *  ObjectAL
+ *
+ *  Checks the error bound of ease_batch_evaluate() against the exact curves
+ *  (computed in double precision), and compares its speed to the libm ease
+ *  functions used by OALEaseAction.
+ *
+ *  - scalar: One call through a function pointer per value, as
+ *            OALEaseAction.updateCompletion: does.
+ *  - batch:  ease_batch_evaluate() over the whole array.
+ *
+ *  Build and run (Linux or macOS). Add -mavx or build for ARM to try the
+ *  other code paths:
+ *      cc -O2 -I../ObjectAL/Support ease_batch.c ../ObjectAL/Support/ease_batch.c -lm -o ease_batch
+ *      ./ease_batch
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ease_batch.h"
+
+#define kValueCount 10000
+#define kPasses 2000
+
+typedef float (*EaseFunctionPtr)(float);
+
+
+/* Reference Curves (same as OALAction.m) */
+
+static float easeFunction_sineIn(float x)
+{
+	return 1.0f - cosf(x * (float)M_PI_2);
+}
+
+static float easeFunction_sineOut(float x)
+{
+	return sinf(x * (float)M_PI_2);
+}
+
+static float easeFunction_sineInOut(float x)
+{
+	return -0.5f * (cosf(x * (float)M_PI) - 1);
+}
+
+static float easeFunction_exponentIn(float x)
+{
+	if(x == 0)
+	{
+		return 0;
+	}
+	return powf(2, 10 * (x - 1));
+}
+
+static float easeFunction_exponentOut(float x)
+{
+	if(x == 1)
+	{
+		return 1;
+	}
+	return -powf(2, -10 * x) + 1;
+}
+
+static float easeFunction_exponentInOut(float x)
+{
+	if(x < 0.5)
+	{
+		if(x == 0)
+		{
+			return 0;
+		}
+		return powf(2, (12 * (x - 0.86f))) * 10;
+	}
+	if(x == 1)
+	{
+		return 1;
+	}
+	return -powf(2, (-12 * (x - 0.4165f))) + 1;
+}
+
+static EaseFunctionPtr g_easeFunctions[kEaseBatchShapeCount][kEaseBatchPhaseCount] =
+{
+	{
+		easeFunction_sineIn,
+		easeFunction_sineOut,
+		easeFunction_sineInOut,
+	},
+	{
+		easeFunction_exponentIn,
+		easeFunction_exponentOut,
+		easeFunction_exponentInOut,
+	},
+};
+
+static double exactCurve(int shape, int phase, double x)
+{
+	if(kEaseBatchShapeSine == shape)
+	{
+		switch(phase)
+		{
+			case kEaseBatchPhaseIn:
+				return 1.0 - cos(x * M_PI_2);
+			case kEaseBatchPhaseOut:
+				return sin(x * M_PI_2);
+			default:
+				return 0.5 - 0.5 * cos(x * M_PI);
+		}
+	}
+	if(x <= 0)
+	{
+		return 0;
+	}
+	if(x >= 1)
+	{
+		return 1;
+	}
+	switch(phase)
+	{
+		case kEaseBatchPhaseIn:
+			return pow(2, 10 * (x - 1));
+		case kEaseBatchPhaseOut:
+			return 1 - pow(2, -10 * x);
+		default:
+			return x < 0.5 ? pow(2, 12 * (x - 0.86)) * 10 : 1 - pow(2, -12 * (x - 0.4165));
+	}
+}
+
+static const char* g_curveNames[kEaseBatchShapeCount][kEaseBatchPhaseCount] =
+{
+	{"sine in", "sine out", "sine in-out"},
+	{"expo in", "expo out", "expo in-out"},
+};
+
+
+/* Benchmark */
+
+static double nowSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float g_input[kValueCount];
+static float g_output[kValueCount];
+static volatile float g_sink;
+
+int main(void)
+{
+	int failed = 0;
+
+	printf("%-12s%14s%14s%12s%12s\n", "curve", "batch err", "scalar err", "scalar ns", "batch ns");
+	for(int shape = 0; shape < kEaseBatchShapeCount; shape++)
+	{
+		for(int phase = 0; phase < kEaseBatchPhaseCount; phase++)
+		{
+			EaseFunctionPtr function = g_easeFunctions[shape][phase];
+
+			/* Accuracy, over a fine sweep of 0.0 - 1.0. */
+			double maxError = 0;
+			double maxScalarError = 0;
+			for(int i = 0; i < kValueCount; i++)
+			{
+				g_input[i] = (float)i / (float)(kValueCount - 1);
+			}
+			ease_batch_evaluate(shape, phase, g_input, g_output, kValueCount);
+			for(int i = 0; i < kValueCount; i++)
+			{
+				double expected = exactCurve(shape, phase, g_input[i]);
+				double error = fabs((double)g_output[i] - expected);
+				double scalarError = fabs((double)function(g_input[i]) - expected);
+				if(error > maxError)
+				{
+					maxError = error;
+				}
+				if(scalarError > maxScalarError)
+				{
+					maxScalarError = scalarError;
+				}
+			}
+
+			/* Speed, on shuffled progress values. */
+			unsigned int seed = 1;
+			for(int i = 0; i < kValueCount; i++)
+			{
+				seed = seed * 1103515245u + 12345u;
+				g_input[i] = (float)((seed >> 8) % 10000) / 10000.0f;
+			}
+
+			double start = nowSeconds();
+			for(int pass = 0; pass < kPasses; pass++)
+			{
+				EaseFunctionPtr volatile call = function;
+				float sum = 0;
+				for(int i = 0; i < kValueCount; i++)
+				{
+					sum += call(g_input[i]);
+				}
+				g_sink = sum;
+			}
+			double scalarTime = (nowSeconds() - start) * 1e9 / ((double)kPasses * kValueCount);
+
+			start = nowSeconds();
+			for(int pass = 0; pass < kPasses; pass++)
+			{
+				ease_batch_evaluate(shape, phase, g_input, g_output, kValueCount);
+				g_sink = g_output[pass % kValueCount];
+			}
+			double batchTime = (nowSeconds() - start) * 1e9 / ((double)kPasses * kValueCount);
+
+			printf("%-12s%14.2e%14.2e%12.2f%12.2f\n", g_curveNames[shape][phase], maxError, maxScalarError, scalarTime, batchTime);
+
+			if(maxError > 5e-7)
+			{
+				failed = 1;
+			}
+		}
+	}
+
+	if(failed)
+	{
+		printf("FAILED: error bound exceeded\n");
+	}
+	return failed;
+}
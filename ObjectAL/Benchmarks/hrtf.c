@@ -0,0 +1,279 @@
+/*
+ *  hrtf.c
+ *  ObjectAL
+ *
+ *  Measures what HRTF costs per voice in OpenAL Soft, against its plain
+ *  (panned) stereo mix, by rendering the same scene through a loopback
+ *  device with ALC_HRTF_SOFT off and then on. These are the two modes that
+ *  ALDevice's setHRTFMode:specifier: switches between.
+ *
+ *  Apple's OpenAL has neither ALC_SOFT_loopback nor ALC_SOFT_HRTF, so this
+ *  needs OpenAL Soft.
+ *
+ *  Build and run (Linux):
+ *      cc -O2 hrtf.c -lopenal -lm -o hrtf
+ *      ./hrtf
+ *
+ *  Build and run (macOS, with Homebrew's openal-soft):
+ *      cc -O2 -I$(brew --prefix openal-soft)/include hrtf.c -L$(brew --prefix openal-soft)/lib -lopenal -lm -o hrtf
+ *      ./hrtf
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#define kFrequency 48000
+#define kRenderFrames 480
+#define kBufferFrames kFrequency
+#define kMaxVoices 64
+#define kBenchSeconds 2
+
+static LPALCLOOPBACKOPENDEVICESOFT alcLoopbackOpenDeviceSOFT_;
+static LPALCISRENDERFORMATSUPPORTEDSOFT alcIsRenderFormatSupportedSOFT_;
+static LPALCRENDERSAMPLESSOFT alcRenderSamplesSOFT_;
+
+static float g_output[kRenderFrames * 2];
+static int g_failed = 0;
+
+static void check(int condition, const char* what)
+{
+	if(!condition)
+	{
+		printf("FAILED: %s\n", what);
+		g_failed = 1;
+	}
+}
+
+static double nowSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+/* Scene */
+
+typedef struct
+{
+	ALCcontext* context;
+	ALuint buffer;
+	ALuint sources[kMaxVoices];
+	int hrtf;
+} Scene;
+
+/* Create a context with HRTF forced on or off. Returns 0 if the device
+ * couldn't give us what we asked for. */
+static int openScene(Scene* scene, ALCdevice* device, int hrtf)
+{
+	ALCint attributes[] =
+	{
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+		ALC_FREQUENCY, kFrequency,
+		ALC_HRTF_SOFT, hrtf ? ALC_TRUE : ALC_FALSE,
+		0
+	};
+	memset(scene, 0, sizeof(*scene));
+	scene->context = alcCreateContext(device, attributes);
+	if(NULL == scene->context)
+	{
+		return 0;
+	}
+	alcMakeContextCurrent(scene->context);
+	alcGetIntegerv(device, ALC_HRTF_SOFT, 1, &scene->hrtf);
+	if(scene->hrtf != hrtf)
+	{
+		alcMakeContextCurrent(NULL);
+		alcDestroyContext(scene->context);
+		return 0;
+	}
+
+	/* A second of noise, so that no voice is cheaper than another. */
+	float* samples = malloc(sizeof(float) * kBufferFrames);
+	unsigned int seed = 1;
+	for(int i = 0; i < kBufferFrames; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		samples[i] = (float)((seed >> 9) & 0x7fff) / 16384.0f - 1.0f;
+	}
+	alGenBuffers(1, &scene->buffer);
+	alBufferData(scene->buffer, AL_FORMAT_MONO_FLOAT32, samples, sizeof(float) * kBufferFrames, kFrequency);
+	free(samples);
+
+	alGenSources(kMaxVoices, scene->sources);
+	for(int i = 0; i < kMaxVoices; i++)
+	{
+		alSourcei(scene->sources[i], AL_BUFFER, (ALint)scene->buffer);
+		alSourcei(scene->sources[i], AL_LOOPING, AL_TRUE);
+		alSourcef(scene->sources[i], AL_GAIN, 0.0f);
+	}
+	return AL_NO_ERROR == alGetError();
+}
+
+static void closeScene(Scene* scene)
+{
+	alSourceStopv(kMaxVoices, scene->sources);
+	alDeleteSources(kMaxVoices, scene->sources);
+	alDeleteBuffers(1, &scene->buffer);
+	alcMakeContextCurrent(NULL);
+	alcDestroyContext(scene->context);
+}
+
+/* Place the voices around the listener, moving a little each block so that
+ * the HRTF mixer has to keep fading between filters. */
+static void placeVoices(Scene* scene, int voiceCount, int block)
+{
+	for(int i = 0; i < voiceCount; i++)
+	{
+		float angle = (float)(2.0 * M_PI * i / voiceCount) + 0.01f * (float)block;
+		alSource3f(scene->sources[i], AL_POSITION, sinf(angle) * 4.0f, 0.5f, -cosf(angle) * 4.0f);
+	}
+}
+
+static void playVoices(Scene* scene, int voiceCount)
+{
+	alSourceStopv(kMaxVoices, scene->sources);
+	for(int i = 0; i < voiceCount; i++)
+	{
+		alSourcef(scene->sources[i], AL_GAIN, 1.0f / (float)voiceCount);
+	}
+	placeVoices(scene, voiceCount, 0);
+	if(voiceCount > 0)
+	{
+		alSourcePlayv(voiceCount, scene->sources);
+	}
+}
+
+
+/* Semantics */
+
+static void checkSemantics(ALCdevice* device)
+{
+	Scene scene;
+	if(!openScene(&scene, device, 1))
+	{
+		return;
+	}
+
+	/* One voice hard left. Panning and HRTF both favour the left ear, but
+	 * HRTF also delays and filters the right one, so it isn't just quieter. */
+	playVoices(&scene, 1);
+	alSource3f(scene.sources[0], AL_POSITION, -4.0f, 0.0f, 0.0f);
+	double left = 0, right = 0;
+	for(int block = 0; block < 20; block++)
+	{
+		alcRenderSamplesSOFT_(device, g_output, kRenderFrames);
+		for(int i = 0; i < kRenderFrames; i++)
+		{
+			left += g_output[i * 2] * g_output[i * 2];
+			right += g_output[i * 2 + 1] * g_output[i * 2 + 1];
+		}
+	}
+	check(left > 0, "HRTF output isn't silent");
+	check(left > right * 2, "source on the left is louder in the left ear");
+
+	closeScene(&scene);
+}
+
+
+/* Speed */
+
+/* Seconds spent rendering kBenchSeconds of audio with this many voices. */
+static double renderTime(ALCdevice* device, Scene* scene, int voiceCount)
+{
+	playVoices(scene, voiceCount);
+	int blocks = kBenchSeconds * kFrequency / kRenderFrames;
+	double start = nowSeconds();
+	for(int block = 0; block < blocks; block++)
+	{
+		placeVoices(scene, voiceCount, block);
+		alcRenderSamplesSOFT_(device, g_output, kRenderFrames);
+	}
+	return nowSeconds() - start;
+}
+
+/* Nanoseconds per voice per output frame, with the cost of an empty mix taken out. */
+static double benchmark(ALCdevice* device, Scene* scene, int voiceCount)
+{
+	double empty = renderTime(device, scene, 0);
+	double full = renderTime(device, scene, voiceCount);
+	return (full - empty) * 1e9 / ((double)voiceCount * kBenchSeconds * kFrequency);
+}
+
+int main(void)
+{
+	if(!alcIsExtensionPresent(NULL, "ALC_SOFT_loopback"))
+	{
+		printf("ALC_SOFT_loopback isn't available. This needs OpenAL Soft.\n");
+		return 1;
+	}
+	alcLoopbackOpenDeviceSOFT_ = (LPALCLOOPBACKOPENDEVICESOFT)alcGetProcAddress(NULL, "alcLoopbackOpenDeviceSOFT");
+	alcIsRenderFormatSupportedSOFT_ = (LPALCISRENDERFORMATSUPPORTEDSOFT)alcGetProcAddress(NULL, "alcIsRenderFormatSupportedSOFT");
+	alcRenderSamplesSOFT_ = (LPALCRENDERSAMPLESSOFT)alcGetProcAddress(NULL, "alcRenderSamplesSOFT");
+
+	ALCdevice* device = alcLoopbackOpenDeviceSOFT_(NULL);
+	if(NULL == device ||
+	   !alcIsRenderFormatSupportedSOFT_(device, kFrequency, ALC_STEREO_SOFT, ALC_FLOAT_SOFT))
+	{
+		printf("Couldn't open a %d Hz float stereo loopback device.\n", kFrequency);
+		return 1;
+	}
+	if(!alcIsExtensionPresent(device, "ALC_SOFT_HRTF"))
+	{
+		printf("ALC_SOFT_HRTF isn't available.\n");
+		alcCloseDevice(device);
+		return 1;
+	}
+
+	checkSemantics(device);
+
+	static const int voiceCounts[] = {16, 64};
+	double costs[2][sizeof(voiceCounts) / sizeof(*voiceCounts)];
+	for(int hrtf = 0; hrtf <= 1; hrtf++)
+	{
+		Scene scene;
+		if(!openScene(&scene, device, hrtf))
+		{
+			printf("Couldn't create a context with HRTF %s (no HRTF data set installed?)\n", hrtf ? "on" : "off");
+			alcCloseDevice(device);
+			return 1;
+		}
+		for(size_t i = 0; i < sizeof(voiceCounts) / sizeof(*voiceCounts); i++)
+		{
+			costs[hrtf][i] = benchmark(device, &scene, voiceCounts[i]);
+		}
+		closeScene(&scene);
+	}
+
+	printf("%d Hz stereo output, %d frame blocks, moving mono voices\n", kFrequency, kRenderFrames);
+	printf("%-8s%8s%16s%22s\n", "mode", "voices", "ns/voice/frame", "voices per core (RT)");
+	for(int hrtf = 0; hrtf <= 1; hrtf++)
+	{
+		for(size_t i = 0; i < sizeof(voiceCounts) / sizeof(*voiceCounts); i++)
+		{
+			printf("%-8s%8d%16.2f%22.0f\n",
+				   hrtf ? "hrtf" : "panned",
+				   voiceCounts[i],
+				   costs[hrtf][i],
+				   1e9 / (costs[hrtf][i] * kFrequency));
+		}
+	}
+	size_t last = sizeof(voiceCounts) / sizeof(*voiceCounts) - 1;
+	printf("HRTF costs %.1fx plain panning per voice\n", costs[1][last] / costs[0][last]);
+
+	alcCloseDevice(device);
+
+	if(g_failed)
+	{
+		printf("FAILED\n");
+	}
+	return g_failed;
+}
@@ -0,0 +1,109 @@
+/*
+ *  offline_render.m
+ *  ObjectAL
+ *
+ *  Renders the same scripted scene twice on fresh offline devices and checks
+ *  that both renders mix to exactly the same samples (ALDevice's
+ *  lastRenderChecksum). The scene has the things that used to depend on the
+ *  wall clock: starts scheduled on sample times that don't line up with the
+ *  render blocks, fades run by the action manager, and culling. It then
+ *  reports how much faster than realtime the scene renders.
+ *
+ *  Loopback devices need OpenAL Soft, installed in place of OpenAL.framework
+ *  (Apple's OpenAL has no ALC_SOFT_loopback). Build it as a macOS command line
+ *  tool with the ObjectAL sources and run it.
+ */
+
+#import <Foundation/Foundation.h>
+#import "ObjectAL.h"
+
+#define kFrequency 48000
+#define kVoices 32
+#define kSeconds 4.0f
+
+static int g_failed = 0;
+
+static void check(int condition, const char* what)
+{
+	if(!condition)
+	{
+		printf("FAILED: %s\n", what);
+		g_failed = 1;
+	}
+}
+
+/** One second of noise, the same every time. */
+static ALBuffer* noiseBuffer(void)
+{
+	ALsizei size = kFrequency * sizeof(int16_t);
+	int16_t* samples = malloc((size_t)size);
+	unsigned int seed = 1;
+	for(int i = 0; i < kFrequency; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		samples[i] = (int16_t)((seed >> 8) & 0xffff);
+	}
+	return [ALBuffer bufferWithName:@"noise" data:samples size:size format:AL_FORMAT_MONO16 frequency:kFrequency];
+}
+
+/** Set up the scene on a fresh offline device and render it. */
+static uint64_t renderScene(NSTimeInterval* renderTime)
+{
+	uint64_t checksum = 0;
+	@autoreleasepool
+	{
+		ALDevice* device = [ALDevice offlineDeviceWithFrequency:kFrequency];
+		ALContext* context = [ALContext contextOnDevice:device attributes:nil];
+		check(nil != context, "offline context");
+		[OpenALManager sharedInstance].currentContext = context;
+		context.cullingEnabled = YES;
+
+		ALBuffer* buffer = noiseBuffer();
+		NSMutableArray* sources = [NSMutableArray arrayWithCapacity:kVoices];
+		for(int i = 0; i < kVoices; i++)
+		{
+			ALSource* source = [ALSource sourceOnContext:context];
+			float angle = 2.0f * (float)M_PI * (float)i / kVoices;
+			source.position = alpoint(sinf(angle) * (2.0f + i), 0, -cosf(angle) * (2.0f + i));
+			source.gain = 1.0f / kVoices;
+
+			// Starts spread out on odd sample times, fading away at different rates.
+			[source play:buffer loop:YES atSampleTime:(int64_t)i * 4801];
+			[source fadeTo:0 duration:1.0f + 0.1f * i target:nil selector:nil];
+			[sources addObject:source];
+		}
+
+		check([device renderToWAVFile:nil duration:kSeconds], "render");
+		checksum = device.lastRenderChecksum;
+		*renderTime = device.lastRenderTime;
+
+		for(ALSource* source in sources)
+		{
+			[source stop];
+		}
+		[OpenALManager sharedInstance].currentContext = nil;
+	}
+	return checksum;
+}
+
+int main(void)
+{
+	@autoreleasepool
+	{
+		NSTimeInterval first = 0;
+		NSTimeInterval second = 0;
+		uint64_t firstChecksum = renderScene(&first);
+		uint64_t secondChecksum = renderScene(&second);
+		check(firstChecksum == secondChecksum, "two renders of the same scene are identical");
+
+		printf("%d voices, %.0f seconds at %d Hz: checksum %016llx\n",
+			   kVoices, kSeconds, kFrequency, (unsigned long long)firstChecksum);
+		printf("rendered at %.1fx realtime\n", kSeconds / MIN(first, second));
+	}
+
+	if(g_failed)
+	{
+		printf("FAILED\n");
+	}
+	return g_failed;
+}
@@ -0,0 +1,270 @@
+/*
+ *  software_mixer.c
+ *  ObjectAL
+ *
+ *  Checks OALSoftwareMixer's voice semantics (panning, distance attenuation,
+ *  pitch, looping, buffer queues), then measures what one voice costs to mix,
+ *  so that voice budgets can be worked out for any machine.
+ *
+ *  - mono:    Mono buffer at the output rate, pitch 1 (the copy path).
+ *  - 3d:      Mono buffer, pitched and moving around the listener.
+ *  - stereo:  Stereo buffer at a different rate (always resampled).
+ *
+ *  Build and run (Linux or macOS). Add -mavx or build for ARM to try the
+ *  other code paths:
+ *      cc -O2 -I../ObjectAL/Support software_mixer.c ../ObjectAL/Support/OALSoftwareMixer.c -lm -o software_mixer
+ *      ./software_mixer
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "OALSoftwareMixer.h"
+
+#define kFrequency 48000
+#define kBufferFrames 48000
+#define kRenderFrames 480
+#define kBenchSeconds 2
+
+static const float kOrigin[3] = {0, 0, 0};
+static const float kAt[3] = {0, 0, -1};
+static const float kUp[3] = {0, 1, 0};
+
+static float g_output[kRenderFrames * 2];
+static int g_failed = 0;
+
+static void check(int condition, const char* what)
+{
+	if(!condition)
+	{
+		printf("FAILED: %s\n", what);
+		g_failed = 1;
+	}
+}
+
+static int near(float a, float b)
+{
+	return fabsf(a - b) < 1e-4f;
+}
+
+static double nowSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+/* Semantics */
+
+static void checkSemantics(void)
+{
+	/* A ramp, so that every frame is recognizable. */
+	float ramp[1000];
+	for(int i = 0; i < 1000; i++)
+	{
+		ramp[i] = (float)i / 1000.0f;
+	}
+	OALMixerBuffer* rampBuffer = OALMixerBufferCreate(ramp, 1000, 1, kOALMixerSampleFloat32, kFrequency);
+	OALMixerBuffer* shortBuffer = OALMixerBufferCreate(ramp, 100, 1, kOALMixerSampleFloat32, kFrequency);
+	int16_t ones[200];
+	for(int i = 0; i < 200; i++)
+	{
+		ones[i] = 16384;
+	}
+	OALMixerBuffer* stereoBuffer = OALMixerBufferCreate(ones, 100, 2, kOALMixerSampleInt16, kFrequency);
+	float halves[100];
+	for(int i = 0; i < 100; i++)
+	{
+		halves[i] = 0.5f;
+	}
+	OALMixerBuffer* halfBuffer = OALMixerBufferCreate(halves, 100, 1, kOALMixerSampleFloat32, kFrequency);
+
+	OALSoftwareMixer* mixer = OALSoftwareMixerCreate(kFrequency, 4);
+	OALSoftwareMixerSetListener(mixer, kOrigin, kAt, kUp, 1.0f);
+	int32_t voice = OALSoftwareMixerCreateVoice(mixer);
+
+	/* Centered: equal power on both sides. */
+	OALSoftwareMixerSetRelative(mixer, voice, true);
+	OALSoftwareMixerSetBuffer(mixer, voice, rampBuffer);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, kRenderFrames);
+	check(near(g_output[20], ramp[10] * 0.70710678f) && near(g_output[21], ramp[10] * 0.70710678f), "centered voice");
+	check(near((float)OALSoftwareMixerGetOffset(mixer, voice), kRenderFrames), "offset");
+
+	/* Runs off the end and stops. */
+	OALSoftwareMixerRender(mixer, g_output, kRenderFrames);
+	OALSoftwareMixerRender(mixer, g_output, kRenderFrames);
+	check(kOALMixerStateStopped == OALSoftwareMixerGetState(mixer, voice), "stops at end");
+	check(0 == g_output[(1000 - 2 * kRenderFrames) * 2] && 0 == g_output[kRenderFrames * 2 - 1], "silent after end");
+	check(near(g_output[(999 - 2 * kRenderFrames) * 2], ramp[999] * 0.70710678f), "plays last frame");
+
+	/* Pitch 2 plays every other frame. */
+	OALSoftwareMixerSetPitch(mixer, voice, 2.0f);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 100);
+	check(near(g_output[2 * 30], ramp[60] * 0.70710678f), "pitch 2");
+	OALSoftwareMixerSetPitch(mixer, voice, 1.0f);
+
+	/* Looping wraps around. */
+	OALSoftwareMixerStop(mixer, voice);
+	OALSoftwareMixerSetBuffer(mixer, voice, shortBuffer);
+	OALSoftwareMixerSetLooping(mixer, voice, true);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 250);
+	check(kOALMixerStatePlaying == OALSoftwareMixerGetState(mixer, voice), "looping keeps playing");
+	check(near(g_output[2 * 230], ramp[30] * 0.70710678f), "looping wraps");
+	check(0 == OALSoftwareMixerBuffersProcessed(mixer, voice), "looping processes nothing");
+	OALSoftwareMixerSetLooping(mixer, voice, false);
+
+	/* Queue: the second buffer follows the first without a gap. */
+	OALSoftwareMixerStop(mixer, voice);
+	OALSoftwareMixerSetBuffer(mixer, voice, NULL);
+	OALSoftwareMixerQueueBuffer(mixer, voice, shortBuffer);
+	OALSoftwareMixerQueueBuffer(mixer, voice, rampBuffer);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 150);
+	check(near(g_output[2 * 149], ramp[49] * 0.70710678f), "queue continues");
+	check(1 == OALSoftwareMixerBuffersProcessed(mixer, voice), "one buffer processed");
+	const OALMixerBuffer* unqueued = NULL;
+	check(1 == OALSoftwareMixerUnqueueBuffers(mixer, voice, &unqueued, 4) && unqueued == shortBuffer, "unqueue");
+	check(near((float)OALSoftwareMixerGetOffset(mixer, voice), 50), "offset after unqueue");
+
+	/* At half pitch, a buffer's last frame blends into the next buffer's first,
+	 * or into silence if nothing follows. */
+	OALSoftwareMixerStop(mixer, voice);
+	OALSoftwareMixerSetBuffer(mixer, voice, NULL);
+	OALSoftwareMixerQueueBuffer(mixer, voice, shortBuffer);
+	OALSoftwareMixerQueueBuffer(mixer, voice, halfBuffer);
+	OALSoftwareMixerSetPitch(mixer, voice, 0.5f);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 250);
+	check(near(g_output[2 * 199], (ramp[99] + 0.5f) * 0.5f * 0.70710678f), "blends into next buffer");
+	OALSoftwareMixerStop(mixer, voice);
+	OALSoftwareMixerSetBuffer(mixer, voice, halfBuffer);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 250);
+	check(near(g_output[2 * 199], 0.25f * 0.70710678f), "blends into silence");
+	OALSoftwareMixerSetPitch(mixer, voice, 1.0f);
+
+	/* Hard right, at twice the reference distance. Inverse clamped halves the gain.
+	 * The first block after play starts on its target gains, so there's no ramp. */
+	OALSoftwareMixerStop(mixer, voice);
+	OALSoftwareMixerSetBuffer(mixer, voice, rampBuffer);
+	OALSoftwareMixerSetRelative(mixer, voice, false);
+	OALSoftwareMixerSetPosition(mixer, voice, 2, 0, 0);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 100);
+	check(near(g_output[2 * 50], 0) && near(g_output[2 * 50 + 1], ramp[50] * 0.5f), "distance and pan");
+
+	/* Stereo isn't panned, and int16 is scaled to -1.0 - 1.0. */
+	OALSoftwareMixerDestroyVoice(mixer, voice);
+	voice = OALSoftwareMixerCreateVoice(mixer);
+	OALSoftwareMixerSetPosition(mixer, voice, 100, 0, 0);
+	OALSoftwareMixerSetBuffer(mixer, voice, stereoBuffer);
+	OALSoftwareMixerPlay(mixer, voice);
+	OALSoftwareMixerRender(mixer, g_output, 50);
+	check(near(g_output[10], 0.5f) && near(g_output[11], 0.5f), "stereo");
+
+	OALSoftwareMixerDestroy(mixer);
+	OALMixerBufferDestroy(rampBuffer);
+	OALMixerBufferDestroy(shortBuffer);
+	OALMixerBufferDestroy(stereoBuffer);
+	OALMixerBufferDestroy(halfBuffer);
+}
+
+
+/* Speed */
+
+typedef enum
+{
+	kSceneMono,
+	kScene3D,
+	kSceneStereo,
+} Scene;
+
+static double benchmark(Scene scene, int voiceCount, const OALMixerBuffer* mono, const OALMixerBuffer* stereo)
+{
+	OALSoftwareMixer* mixer = OALSoftwareMixerCreate(kFrequency, (size_t)voiceCount);
+	OALSoftwareMixerSetListener(mixer, kOrigin, kAt, kUp, 1.0f);
+	int32_t* voices = malloc(sizeof(*voices) * (size_t)voiceCount);
+	for(int i = 0; i < voiceCount; i++)
+	{
+		voices[i] = OALSoftwareMixerCreateVoice(mixer);
+		OALSoftwareMixerSetBuffer(mixer, voices[i], kSceneStereo == scene ? stereo : mono);
+		OALSoftwareMixerSetLooping(mixer, voices[i], true);
+		OALSoftwareMixerSetGain(mixer, voices[i], 1.0f / (float)voiceCount);
+		if(kScene3D == scene)
+		{
+			OALSoftwareMixerSetPitch(mixer, voices[i], 0.9f + 0.2f * (float)i / (float)voiceCount);
+		}
+		else if(kSceneStereo == scene)
+		{
+			OALSoftwareMixerSetPitch(mixer, voices[i], 1.0f);
+		}
+		OALSoftwareMixerPlay(mixer, voices[i]);
+	}
+
+	int blocks = kBenchSeconds * kFrequency / kRenderFrames;
+	double start = nowSeconds();
+	for(int block = 0; block < blocks; block++)
+	{
+		if(kScene3D == scene)
+		{
+			/* Move everything once per block, as a game would once per frame. */
+			for(int i = 0; i < voiceCount; i++)
+			{
+				float angle = (float)(block + i) * 0.01f;
+				OALSoftwareMixerSetPosition(mixer, voices[i], 10 * cosf(angle), 0, 10 * sinf(angle));
+			}
+		}
+		OALSoftwareMixerRender(mixer, g_output, kRenderFrames);
+	}
+	double elapsed = nowSeconds() - start;
+
+	OALSoftwareMixerDestroy(mixer);
+	free(voices);
+
+	/* Nanoseconds per voice per output frame. */
+	return elapsed * 1e9 / ((double)blocks * kRenderFrames * voiceCount);
+}
+
+int main(void)
+{
+	checkSemantics();
+
+	float* noise = malloc(sizeof(*noise) * kBufferFrames * 2);
+	unsigned int seed = 1;
+	for(int i = 0; i < kBufferFrames * 2; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		noise[i] = (float)((seed >> 8) % 20000) / 10000.0f - 1.0f;
+	}
+	OALMixerBuffer* mono = OALMixerBufferCreate(noise, kBufferFrames, 1, kOALMixerSampleFloat32, kFrequency);
+	OALMixerBuffer* stereo = OALMixerBufferCreate(noise, kBufferFrames, 2, kOALMixerSampleFloat32, 44100);
+
+	static const char* names[] = {"mono", "3d", "stereo"};
+	static const int voiceCounts[] = {16, 64, 256};
+	printf("%d Hz output, %d frame blocks\n", kFrequency, kRenderFrames);
+	printf("%-8s%8s%16s%22s\n", "scene", "voices", "ns/voice/frame", "voices per core (RT)");
+	for(int scene = kSceneMono; scene <= kSceneStereo; scene++)
+	{
+		for(size_t i = 0; i < sizeof(voiceCounts) / sizeof(*voiceCounts); i++)
+		{
+			double cost = benchmark((Scene)scene, voiceCounts[i], mono, stereo);
+			printf("%-8s%8d%16.2f%22.0f\n", names[scene], voiceCounts[i], cost, 1e9 / (cost * kFrequency));
+		}
+	}
+
+	OALMixerBufferDestroy(mono);
+	OALMixerBufferDestroy(stereo);
+	free(noise);
+	if(g_failed)
+	{
+		printf("FAILED\n");
+	}
+	return g_failed;
+}
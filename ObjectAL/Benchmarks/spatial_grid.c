@@ -0,0 +1,261 @@
+/*
+ *  spatial_grid.c
+ *  ObjectAL
+ *
+ *  Checks OALSpatialGrid's radius and nearest queries against a linear scan,
+ *  and compares their speed, with many emitters scattered over a large world
+ *  and a few hundred of them moving every tick.
+ *
+ *  - scan: Look at every emitter, as ALContext's culling pass does without
+ *          a culling radius.
+ *  - grid: OALSpatialGrid queries.
+ *
+ *  Build and run (Linux or macOS):
+ *      cc -O2 -I../ObjectAL/Support spatial_grid.c ../ObjectAL/Support/OALSpatialGrid.c -lm -o spatial_grid
+ *      ./spatial_grid
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "OALSpatialGrid.h"
+
+#define kEmitterCount 10000
+#define kWorldSize 2000.0f
+#define kQueryRadius 100.0f
+#define kNearestCount 32
+#define kMovesPerTick 500
+#define kTicks 1000
+
+typedef struct
+{
+	float x, y, z;
+	int32_t handle;
+} Emitter;
+
+static Emitter g_emitters[kEmitterCount];
+static void* g_found[kEmitterCount];
+static void* g_expected[kEmitterCount];
+static float g_distances[kEmitterCount];
+
+static unsigned int g_seed = 1;
+
+static float randomCoordinate(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return ((float)((g_seed >> 8) % 100000) / 100000.0f - 0.5f) * kWorldSize;
+}
+
+static float distanceSquared(const Emitter* emitter, float x, float y, float z)
+{
+	float dx = emitter->x - x;
+	float dy = emitter->y - y;
+	float dz = emitter->z - z;
+	return dx*dx + dy*dy + dz*dz;
+}
+
+
+/* Linear Scan */
+
+static size_t scanRadius(float x, float y, float z, float radius, void** items)
+{
+	size_t found = 0;
+	for(int i = 0; i < kEmitterCount; i++)
+	{
+		if(distanceSquared(&g_emitters[i], x, y, z) <= radius * radius)
+		{
+			items[found++] = &g_emitters[i];
+		}
+	}
+	return found;
+}
+
+static size_t scanNearest(float x, float y, float z, void** items, size_t count)
+{
+	/* Insertion into a sorted list of the best so far. */
+	size_t found = 0;
+	for(int i = 0; i < kEmitterCount; i++)
+	{
+		float distance = distanceSquared(&g_emitters[i], x, y, z);
+		if(found == count && distance >= g_distances[found - 1])
+		{
+			continue;
+		}
+		size_t j = found < count ? found++ : count - 1;
+		while(j > 0 && g_distances[j - 1] > distance)
+		{
+			g_distances[j] = g_distances[j - 1];
+			items[j] = items[j - 1];
+			j--;
+		}
+		g_distances[j] = distance;
+		items[j] = &g_emitters[i];
+	}
+	return found;
+}
+
+
+/* Benchmark */
+
+static double nowSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int comparePointers(const void* a, const void* b)
+{
+	const char* pa = *(void* const*)a;
+	const char* pb = *(void* const*)b;
+	return pa < pb ? -1 : pa > pb;
+}
+
+/* Jump a few emitters to anywhere in the world, so that cells empty out
+ * and new ones fill up. */
+static void teleportSome(OALSpatialGrid* grid)
+{
+	for(int i = 0; i < kMovesPerTick / 5; i++)
+	{
+		g_seed = g_seed * 1103515245u + 12345u;
+		Emitter* emitter = &g_emitters[(g_seed >> 8) % kEmitterCount];
+		emitter->x = randomCoordinate();
+		emitter->z = randomCoordinate();
+		OALSpatialGridMove(grid, emitter->handle, emitter->x, emitter->y, emitter->z);
+	}
+}
+
+static void moveSome(OALSpatialGrid* grid)
+{
+	for(int i = 0; i < kMovesPerTick; i++)
+	{
+		g_seed = g_seed * 1103515245u + 12345u;
+		Emitter* emitter = &g_emitters[(g_seed >> 8) % kEmitterCount];
+		emitter->x += randomCoordinate() * 0.01f;
+		emitter->y += randomCoordinate() * 0.01f;
+		emitter->z += randomCoordinate() * 0.01f;
+		if(NULL != grid)
+		{
+			OALSpatialGridMove(grid, emitter->handle, emitter->x, emitter->y, emitter->z);
+		}
+	}
+}
+
+int main(void)
+{
+	int failed = 0;
+	OALSpatialGrid* grid = OALSpatialGridCreate(kQueryRadius);
+
+	for(int i = 0; i < kEmitterCount; i++)
+	{
+		Emitter* emitter = &g_emitters[i];
+		emitter->x = randomCoordinate();
+		emitter->y = randomCoordinate() * 0.1f;
+		emitter->z = randomCoordinate();
+		emitter->handle = OALSpatialGridInsert(grid, emitter, emitter->x, emitter->y, emitter->z);
+	}
+
+	/* Correctness, including after removals, reinsertions and cells emptying out. */
+	for(int i = 0; i < kEmitterCount; i += 7)
+	{
+		OALSpatialGridRemove(grid, g_emitters[i].handle);
+		g_emitters[i].handle = OALSpatialGridInsert(grid, &g_emitters[i], g_emitters[i].x, g_emitters[i].y, g_emitters[i].z);
+	}
+	for(int check = 0; check < 200; check++)
+	{
+		moveSome(grid);
+		teleportSome(grid);
+		float x = randomCoordinate();
+		float y = 0;
+		float z = randomCoordinate();
+		float radius = check % 10 == 0 ? kWorldSize : kQueryRadius;
+
+		size_t expected = scanRadius(x, y, z, radius, g_expected);
+		size_t found = OALSpatialGridQueryRadius(grid, x, y, z, radius, g_found, kEmitterCount);
+		qsort(g_expected, expected, sizeof(void*), comparePointers);
+		qsort(g_found, found, sizeof(void*), comparePointers);
+		if(found != expected || 0 != memcmp(g_found, g_expected, found * sizeof(void*)))
+		{
+			printf("FAILED: radius query found %zu, expected %zu\n", found, expected);
+			failed = 1;
+		}
+
+		expected = scanNearest(x, y, z, g_expected, kNearestCount);
+		found = OALSpatialGridQueryNearest(grid, x, y, z, INFINITY, g_found, kNearestCount);
+		if(found != expected)
+		{
+			printf("FAILED: nearest query found %zu, expected %zu\n", found, expected);
+			failed = 1;
+		}
+		for(size_t i = 0; i < found && i < expected; i++)
+		{
+			/* Compare distances, since ties may come back in either order. */
+			if(distanceSquared(g_found[i], x, y, z) != distanceSquared(g_expected[i], x, y, z))
+			{
+				printf("FAILED: nearest query result %zu is wrong\n", i);
+				failed = 1;
+				break;
+			}
+		}
+	}
+
+	/* Speed. Moving costs the scan nothing, so time it on its own. */
+	volatile size_t sink = 0;
+	double start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		moveSome(NULL);
+	}
+	double scanMoveTime = (nowSeconds() - start) * 1e6 / kTicks;
+
+	start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		moveSome(grid);
+	}
+	double gridMoveTime = (nowSeconds() - start) * 1e6 / kTicks;
+
+	start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		sink += scanRadius(0, 0, 0, kQueryRadius, g_found);
+	}
+	double scanRadiusTime = (nowSeconds() - start) * 1e6 / kTicks;
+
+	start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		sink += OALSpatialGridQueryRadius(grid, 0, 0, 0, kQueryRadius, g_found, kEmitterCount);
+	}
+	double gridRadiusTime = (nowSeconds() - start) * 1e6 / kTicks;
+
+	start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		sink += scanNearest(0, 0, 0, g_found, kNearestCount);
+	}
+	double scanNearestTime = (nowSeconds() - start) * 1e6 / kTicks;
+
+	start = nowSeconds();
+	for(int tick = 0; tick < kTicks; tick++)
+	{
+		sink += OALSpatialGridQueryNearest(grid, 0, 0, 0, INFINITY, g_found, kNearestCount);
+	}
+	double gridNearestTime = (nowSeconds() - start) * 1e6 / kTicks;
+
+	printf("%d emitters, %d moving per tick\n", kEmitterCount, kMovesPerTick);
+	printf("%-18s%12s%12s\n", "query", "scan us", "grid us");
+	printf("%-18s%12.1f%12.1f\n", "move 500", scanMoveTime, gridMoveTime);
+	printf("%-18s%12.1f%12.1f\n", "within radius", scanRadiusTime, gridRadiusTime);
+	printf("%-18s%12.1f%12.1f\n", "nearest 32", scanNearestTime, gridNearestTime);
+
+	OALSpatialGridDestroy(grid);
+	if(failed)
+	{
+		printf("FAILED\n");
+	}
+	return failed;
+}
@@ -7,6 +7,7 @@
 //
 
 #import "OALAction.h"
+#import "ARCSafe_MemMgmt.h"
 
 /** \cond */
 @interface OALAction ()
@@ -19,5 +20,52 @@
 
 @property(nonatomic,readwrite,assign) bool runningInManager;
 
+@property(nonatomic,readwrite,assign) NSInteger managerIndex;
+
+@property(nonatomic,readwrite,assign) uint32_t armGeneration;
+
+/** Stop this action after it has run to the end, unless it was started or
+ * re-armed since the manager saw it finish.
+ *
+ * @param generation The armGeneration the manager saw.
+ */
+- (void) finishGeneration:(uint32_t) generation;
+
+@end
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+/** Check that an action is still running and hasn't been re-armed since the
+ * manager took a step, without sending it any messages.
+ *
+ * @param action The action to check.
+ * @param generation The armGeneration the manager saw.
+ * @return TRUE if the action is running and still on that generation.
+ */
+bool OALActionIsRunningGeneration(as_unsafe_unretained OALAction* action, uint32_t generation);
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+
+@interface OALPropertyAction ()
+
+@property(nonatomic,readwrite,assign) float delta;
+
+- (void) applyValue:(float) value;
+
+/** Look up a direct setter for propertyKey on the target, so that
+ * applyValue: doesn't have to box the value and go through KVC.
+ *
+ * @param target The target to look up the setter on.
+ */
+- (void) resolveSetterForTarget:(id) target;
+
+@end
+
+@interface OALEaseAction ()
+
+- (OALAction*) action;
+
+- (OALEaseShape) shape;
+
+- (OALEasePhase) phase;
+
 @end
 /** \endcond */
@@ -125,6 +125,14 @@
 	
 	/** If TRUE, this action is running via OALActionManager. */
 	bool runningInManager_;
+
+	/** This action's slot in OALActionManager, or -1 if it isn't being stepped. */
+	NSInteger managerIndex_;
+
+	/** Incremented every time this action is started or re-armed, so that the
+	 * manager can tell a finished run from a newer one.
+	 */
+	uint32_t armGeneration_;
 }
 
 
@@ -262,6 +270,69 @@ COCOS2D_SUBCLASS_HEADER(OALAction, CCActionInterval);
 @end
 
 
+#pragma mark -
+#pragma mark OALRampAction
+
+/**
+ * A reusable property action that ramps a property on a fixed target, and
+ * notifies a callback when it reaches the end. <br>
+ * Unlike a sequence of OALPropertyAction and OALCallAction, a ramp is allocated
+ * once and then re-armed in place by rampFrom:to:duration:callTarget:selector:.
+ * If it's still running, its slot in OALActionManager is reused as well.
+ */
+@interface OALRampAction: OALPropertyAction
+{
+	/** The object to notify when the ramp completes. WEAK REFERENCE. */
+	id callTarget_;
+
+	/** The selector to call on callTarget_ when the ramp completes. */
+	SEL selector_;
+}
+
+
+#pragma mark Object Management
+
+/** Create a new ramp.
+ *
+ * @param target The object whose property will be ramped. WEAK REFERENCE.
+ * @param propertyKey The property to ramp.
+ * @return A new ramp.
+ */
++ (id) rampWithTarget:(id) target propertyKey:(NSString*) propertyKey;
+
+/** Initialize a ramp.
+ *
+ * @param target The object whose property will be ramped. WEAK REFERENCE.
+ * @param propertyKey The property to ramp.
+ * @return The initialized ramp.
+ */
+- (id) initWithTarget:(id) target propertyKey:(NSString*) propertyKey;
+
+
+#pragma mark Functions
+
+/** Start (or restart) ramping the property. Any ramp in progress is
+ * abandoned without calling its callback.
+ *
+ * @param startValue The value to start from. If NAN, use the property's current value.
+ * @param endValue The value to end at.
+ * @param duration The duration of the ramp in seconds.
+ * @param callTarget The object to notify when the ramp completes (nil = no notification).
+ * @param selector The selector to call on callTarget. It takes one parameter: the ramp's target.
+ */
+- (void) rampFrom:(float) startValue
+			   to:(float) endValue
+		 duration:(float) duration
+	   callTarget:(id) callTarget
+		 selector:(SEL) selector;
+
+/** Stop the ramp where it is, without calling its callback.
+ */
+- (void) cancel;
+
+@end
+
+
 #pragma mark -
 #pragma mark OALEaseAction
 
@@ -56,6 +56,7 @@
 	if(nil != (self = [super init]))
 	{
 		self.duration = duration;
+		managerIndex_ = -1;
 	}
 	return self;
 }
@@ -65,9 +66,33 @@
 
 @synthesize target = _target;
 @synthesize duration = duration_;
-@synthesize elapsed = elapsed_;
 @synthesize running = running_;
 @synthesize runningInManager = runningInManager_;
+@synthesize managerIndex = managerIndex_;
+@synthesize armGeneration = armGeneration_;
+
+- (float) elapsed
+{
+	// While the manager is stepping this action, it holds the current value.
+	if(managerIndex_ >= 0)
+	{
+		float elapsed = [[OALActionManager sharedInstance] elapsedForAction:self];
+		if(!isnan(elapsed))
+		{
+			return elapsed;
+		}
+	}
+	return elapsed_;
+}
+
+- (void) setElapsed:(float) elapsed
+{
+	elapsed_ = elapsed;
+	if(managerIndex_ >= 0)
+	{
+		[[OALActionManager sharedInstance] setElapsed:elapsed forAction:self];
+	}
+}
 
 
 #pragma mark Functions
@@ -100,6 +125,7 @@
 
 - (void) startAction
 {
+	armGeneration_++;
 	self.running = YES;
 	self.elapsed = 0;
 }
@@ -120,6 +146,20 @@
 	}
 }
 
+- (void) finishGeneration:(uint32_t) generation
+{
+	if(self.running && generation == armGeneration_)
+	{
+		[self stopAction];
+	}
+}
+
+bool OALActionIsRunningGeneration(as_unsafe_unretained OALAction* action, uint32_t generation)
+{
+	return __atomic_load_n(&action->running_, __ATOMIC_ACQUIRE) &&
+		   __atomic_load_n(&action->armGeneration_, __ATOMIC_ACQUIRE) == generation;
+}
+
 @end
 
 
@@ -205,12 +245,28 @@
 #pragma mark -
 #pragma mark OALPropertyAction
 
-@interface OALPropertyAction ()
+/** Direct pointer to a setter that takes a float. */
+typedef void (*OALFloatSetterFunc)(id, SEL, float);
 
-@property(nonatomic,readwrite,assign) float delta;
+/** Direct pointer to a setter that takes a double. */
+typedef void (*OALDoubleSetterFunc)(id, SEL, double);
+
+@interface OALPropertyAction ()
 
 @property(nonatomic,readwrite,retain) NSString* propertyKey;
 
+/** The target's setter for propertyKey, or NULL to fall back to KVC. */
+@property(nonatomic,readwrite,assign) SEL setterSelector;
+
+/** The setter's implementation, if it takes a float. */
+@property(nonatomic,readwrite,assign) OALFloatSetterFunc floatSetter;
+
+/** The setter's implementation, if it takes a double. */
+@property(nonatomic,readwrite,assign) OALDoubleSetterFunc doubleSetter;
+
+/** The class the setter was looked up on, or Nil if it hasn't been looked up. */
+@property(nonatomic,readwrite,assign) Class setterClass;
+
 @end
 
 @implementation OALPropertyAction
@@ -225,6 +281,14 @@
 
 @synthesize propertyKey = _propertyKey;
 
+@synthesize setterSelector = _setterSelector;
+
+@synthesize floatSetter = _floatSetter;
+
+@synthesize doubleSetter = _doubleSetter;
+
+@synthesize setterClass = _setterClass;
+
 
 #pragma mark Object Management
 
@@ -285,12 +349,262 @@
     }
 
 	self.delta = self.endValue - self.startValue;
+
+	[self resolveSetterForTarget:target];
+}
+
+- (void) resolveSetterForTarget:(id) target
+{
+	// Reused actions (such as OALRampAction) usually run on the same kind of target.
+	Class targetClass = object_getClass(target);
+	if(Nil != targetClass && targetClass == self.setterClass)
+	{
+		return;
+	}
+	self.setterClass = targetClass;
+
+	self.setterSelector = NULL;
+	self.floatSetter = NULL;
+	self.doubleSetter = NULL;
+
+	NSString* key = self.propertyKey;
+	if([key length] == 0 || [key rangeOfString:@"."].location != NSNotFound)
+	{
+		// Key paths have to go through KVC.
+		return;
+	}
+
+	NSString* setterName = [NSString stringWithFormat:@"set%@%@:",
+							[[key substringToIndex:1] uppercaseString],
+							[key substringFromIndex:1]];
+	SEL selector = NSSelectorFromString(setterName);
+	if(![target respondsToSelector:selector])
+	{
+		return;
+	}
+
+	NSMethodSignature* signature = [target methodSignatureForSelector:selector];
+	if([signature numberOfArguments] != 3)
+	{
+		return;
+	}
+
+	const char* argType = [signature getArgumentTypeAtIndex:2];
+	if(0 == strcmp(argType, @encode(float)))
+	{
+		self.floatSetter = (OALFloatSetterFunc)[target methodForSelector:selector];
+		self.setterSelector = selector;
+	}
+	else if(0 == strcmp(argType, @encode(double)))
+	{
+		self.doubleSetter = (OALDoubleSetterFunc)[target methodForSelector:selector];
+		self.setterSelector = selector;
+	}
 }
 
 - (void) updateCompletion:(float) proportionComplete
 {
-    float value = self.startValue + self.delta * proportionComplete;
-    [self.target setValue:[NSNumber numberWithFloat:value] forKey:self.propertyKey];
+	[self applyValue:_startValue + _delta * proportionComplete];
+}
+
+- (void) applyValue:(float) value
+{
+	if(NULL != _floatSetter)
+	{
+		_floatSetter(self.target, _setterSelector, value);
+	}
+	else if(NULL != _doubleSetter)
+	{
+		_doubleSetter(self.target, _setterSelector, value);
+	}
+	else
+	{
+		[self.target setValue:[NSNumber numberWithFloat:value] forKey:self.propertyKey];
+	}
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALRampAction
+
+@interface OALRampAction ()
+
+/** The lock that re-arming and finishing a ramp happen under. This is the
+ * action manager's, since the manager re-arms the ramp.
+ */
+- (id) rampLock;
+
+/** Stop the ramp, taking its callback if it ran to completion.
+ *
+ * @return The target to notify, or nil.
+ */
+- (id) takeCallTargetAndStop;
+
+/** Call the completion callback, if any. */
+- (void) notifyCompleted;
+
+/** Call the completion selector on a target taken from the ramp.
+ *
+ * @param callTarget The target to call, or nil.
+ */
+- (void) notifyTarget:(id) callTarget;
+
+@end
+
+@implementation OALRampAction
+
+#pragma mark Object Management
+
++ (id) rampWithTarget:(id) target propertyKey:(NSString*) propertyKey
+{
+	return as_autorelease([[self alloc] initWithTarget:target propertyKey:propertyKey]);
+}
+
+- (id) initWithTarget:(id) target propertyKey:(NSString*) propertyKey
+{
+	if(nil != (self = [super initWithDuration:0 propertyKey:propertyKey endValue:0]))
+	{
+		self.target = target;
+	}
+	return self;
+}
+
+
+#pragma mark Functions
+
+- (void) rampFrom:(float) startValue
+			   to:(float) endValue
+		 duration:(float) duration
+	   callTarget:(id) callTarget
+		 selector:(SEL) selector
+{
+	id target = self.target;
+	if(isnan(startValue))
+	{
+		startValue = [[target valueForKey:self.propertyKey] floatValue];
+	}
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	if(duration > 0)
+	{
+		[self resolveSetterForTarget:target];
+
+		OPTIONALLY_SYNCHRONIZED([self rampLock])
+		{
+			// Swapped along with the re-arm, so that a step finishing the
+			// previous ramp can't call the new callback.
+			callTarget_ = callTarget;
+			selector_ = selector;
+			self.startValue = startValue;
+			self.endValue = endValue;
+			self.delta = endValue - startValue;
+			self.duration = duration;
+			[[OALActionManager sharedInstance] rearmOrStartAction:self];
+		}
+		[self updateCompletion:0];
+		return;
+	}
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+
+	[self cancel];
+
+	callTarget_ = callTarget;
+	selector_ = selector;
+	self.startValue = startValue;
+	self.endValue = endValue;
+
+	if(duration <= 0)
+	{
+		// Nothing to ramp. Jump straight to the end.
+		[self resolveSetterForTarget:target];
+		[self applyValue:endValue];
+		[self notifyCompleted];
+		return;
+	}
+
+	self.duration = duration;
+	[self runWithTarget:target];
+}
+
+- (void) cancel
+{
+	OPTIONALLY_SYNCHRONIZED([self rampLock])
+	{
+		if(self.running)
+		{
+			callTarget_ = nil;
+			[super stopAction];
+		}
+	}
+}
+
+- (void) stopAction
+{
+	id callTarget = nil;
+	OPTIONALLY_SYNCHRONIZED([self rampLock])
+	{
+		callTarget = [self takeCallTargetAndStop];
+	}
+	[self notifyTarget:callTarget];
+}
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+- (void) finishGeneration:(uint32_t) generation
+{
+	id callTarget = nil;
+	OPTIONALLY_SYNCHRONIZED([self rampLock])
+	{
+		// rampFrom:to: re-arms under the same lock, so a ramp restarted since
+		// this step was taken is left running.
+		if(!self.running || generation != self.armGeneration)
+		{
+			return;
+		}
+		callTarget = [self takeCallTargetAndStop];
+	}
+	[self notifyTarget:callTarget];
+}
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+
+- (id) rampLock
+{
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	return [OALActionManager sharedInstance];
+#else
+	return self;
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+}
+
+- (id) takeCallTargetAndStop
+{
+	id callTarget = nil;
+	if(self.running && self.elapsed >= self.duration)
+	{
+		callTarget = callTarget_;
+		callTarget_ = nil;
+	}
+	[super stopAction];
+	return callTarget;
+}
+
+- (void) notifyCompleted
+{
+	id callTarget = callTarget_;
+	callTarget_ = nil;
+	[self notifyTarget:callTarget];
+}
+
+- (void) notifyTarget:(id) callTarget
+{
+	if(nil != callTarget && NULL != selector_)
+	{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
+		[callTarget performSelector:selector_ withObject:self.target];
+#pragma clang diagnostic pop
+	}
 }
 
 @end
@@ -329,7 +643,7 @@ static float easeFunction_exponentOut(float x)
     {
         return 1;
     }
-    return powf(-2, -10 * x) + 1;
+    return -powf(2, -10 * x) + 1;
 }
 
 static float easeFunction_exponentInOut(float x)
@@ -346,7 +660,7 @@ static float easeFunction_exponentInOut(float x)
     {
         return 1;
     }
-    return powf(-2, (-12 * (x - 0.4165f))) + 1;
+    return -powf(2, (-12 * (x - 0.4165f))) + 1;
 }
 
 
@@ -368,6 +682,8 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
 
 @property(nonatomic, readwrite, retain) OALAction* action;
 @property(nonatomic, readwrite, assign) EaseFunctionPtr easeFunction;
+@property(nonatomic, readwrite, assign) OALEaseShape shape;
+@property(nonatomic, readwrite, assign) OALEasePhase phase;
 
 @end
 
@@ -375,6 +691,8 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
 
 @synthesize action = action_;
 @synthesize easeFunction = easeFunction_;
+@synthesize shape = shape_;
+@synthesize phase = phase_;
 
 + (EaseFunctionPtr) easeFunctionForShape:(OALEaseShape) shape
                                    phase:(OALEasePhase) phase
@@ -398,6 +716,8 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
     if((self = [super initWithDuration:action.duration]))
     {
         self.easeFunction = [[self class] easeFunctionForShape:shape phase:phase];
+        self.shape = shape;
+        self.phase = phase;
         self.action = action;
     }
     return self;
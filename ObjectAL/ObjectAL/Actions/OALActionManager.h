@@ -37,19 +37,125 @@
 #if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
 
 
+/** Direct pointer to an action's updateCompletion: implementation. */
+typedef void (*OALActionUpdateFunc)(id, SEL, float);
+
+/** \cond */
+/** (INTERNAL USE) One action's update, taken under the manager's lock during a step
+ * and applied after the lock is released.
+ */
+typedef struct
+{
+	/** The action. The slot arrays own it, and hold on to it until the step is done. */
+	CFTypeRef action;
+	/** The object whose update function gets called. */
+	CFTypeRef receiver;
+	OALActionUpdateFunc update;
+	float progress;
+	/** If true, the action reached its end and gets stopped after the update. */
+	bool finished;
+	/** The action's armGeneration when the step was taken. */
+	uint32_t generation;
+} OALActionStepEntry;
+/** \endcond */
+
+
+#pragma mark OALActionScheduling
+
+/** Determines what drives the action manager's steps.
+ */
+typedef enum
+{
+	/** Actions are stepped by a timer on the run loop of the thread that started the first action (default). */
+	OALActionSchedulingRunLoop,
+	/** Actions are stepped on a dedicated high priority thread, which sleeps while no actions are running. */
+	OALActionSchedulingThread,
+	/** Actions are only stepped when you call step: from your own loop. */
+	OALActionSchedulingManual,
+} OALActionScheduling;
+
+
 #pragma mark OALActionManager
 
 /**
- * Manages all ObjectAL actions.
+ * Manages all ObjectAL actions. <br><br>
+ *
+ * By default, actions are stepped by a run loop timer every kActionStepInterval seconds.
+ * For smoother fades you can instead step them from a dedicated thread at a higher
+ * rate (120-250 Hz works well), or drive them yourself from your engine's loop
+ * using manual scheduling and step:. <br><br>
+ *
+ * Timed steps follow OALClockNow(), so OALClockSetTimeScale() slows down or
+ * pauses all actions at once, and a virtual clock makes them deterministic. <br><br>
+ *
+ * Note: With OALActionSchedulingThread, actions (including OALCallAction) run on the
+ * scheduler thread, so OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS must be enabled. <br><br>
+ *
+ * The manager's lock is never held while actions update their targets or call
+ * their completion callbacks, so those are free to take their own locks
+ * (sources, buses, channels) in any order.
  */
 @interface OALActionManager : NSObject
 {
-	/** All targets that have actions running on them (id). */
-	NSMutableArray* targets;
-	
-	/** Parallel array to "targets", maintaining a list of all actions per target (NSMutableArray*) */
-	NSMutableArray* targetActions;
-	
+	/* Running actions are kept as a struct of arrays, indexed by slot.
+	 * Each action remembers its slot (managerIndex), so it can be removed in O(1)
+	 * by moving the last slot into its place.
+	 */
+
+	/** The running actions (OALAction*, retained). */
+	CFTypeRef* slotActions;
+
+	/** updateCompletion: implementation of each running action, resolved when it was added. */
+	OALActionUpdateFunc* slotUpdates;
+
+	/** Time elapsed for each running action, in seconds. */
+	float* slotElapsed;
+
+	/** Duration of each running action, in seconds. */
+	float* slotDuration;
+
+	/** The object whose update function gets called (OALAction*, not retained).
+	 * For an ease action, this is the action being eased.
+	 */
+	CFTypeRef* slotReceivers;
+
+	/** Ease curve applied before calling the update function, or -1 for none. */
+	int8_t* slotEase;
+
+	/** armGeneration of each running action, as of when it was added or last re-armed. */
+	uint32_t* slotGeneration;
+
+	/** Scratch space: progress of each running action during a step. */
+	float* slotProgress;
+
+	/** Scratch space: eased slots grouped by curve during a step. */
+	NSUInteger* easeOrder;
+
+	/** Scratch space: progress values of a curve group during a step. */
+	float* easeValues;
+
+	/** Scratch space: updates to apply once the lock is released. A step takes
+	 * ownership of it (setting it to NULL) while it runs.
+	 */
+	OALActionStepEntry* stepEntries;
+
+	/** Number of entries allocated in stepEntries. */
+	NSUInteger stepEntriesCapacity;
+
+	/** Number of steps that are updating actions outside of the lock. */
+	NSUInteger stepsInFlight;
+
+	/** Actions removed from the slots while a step was in flight. They are
+	 * released once no step is using them any more (OALAction*).
+	 */
+	NSMutableArray* actionsToRelease;
+
+	/** Number of running actions. */
+	NSUInteger slotCount;
+
+	/** Number of slots allocated. */
+	NSUInteger slotCapacity;
+
 	/** All actions that are to be added on the next pass (OALAction*) */
 	NSMutableArray* actionsToAdd;
 	
@@ -59,11 +165,47 @@
 	/** The timer which we use to update the actions. */
 	NSTimer* stepTimer;
 	
-	/** The last time that was recorded. */
-	uint64_t lastTimestamp;
+	/** The OALClockNow() time of the last timed step, or negative after a break in timing. */
+	double lastTimestamp;
+
+	/** What drives the steps. */
+	OALActionScheduling scheduling;
+
+	/** Time between steps, in seconds. */
+	NSTimeInterval tickInterval;
+
+	/** The thread which updates the actions in OALActionSchedulingThread mode. */
+	NSThread* stepThread;
+
+	/** Wakes the step thread when actions are started. */
+	dispatch_semaphore_t wakeSignal;
+
+	/** Signaled by the step thread once it has finished. */
+	dispatch_semaphore_t stoppedSignal;
+
+	/** Whether the step thread should keep running. */
+	volatile bool stepThreadRunning;
+
+	/** True while stopStepThread is waiting on stoppedSignal. */
+	bool stepThreadJoinPending;
 }
 
 
+#pragma mark Properties
+
+/** What drives the action steps. Changing this while actions are running
+ * hands them over to the new scheduler without interrupting them. <br>
+ * Default value: OALActionSchedulingRunLoop
+ */
+@property(nonatomic,readwrite,assign) OALActionScheduling scheduling;
+
+/** Time between steps, in seconds (1.0/tickInterval is the tick rate).
+ * Ignored in OALActionSchedulingManual mode. <br>
+ * Default value: kActionStepInterval
+ */
+@property(nonatomic,readwrite,assign) NSTimeInterval tickInterval;
+
+
 #pragma mark Object Management
 
 /** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
@@ -80,6 +222,19 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALActionManager);
  */
 - (void) stopAllActions;
 
+/** Advance all running actions by the specified amount of time.
+ * Use this to drive the actions from your own loop in OALActionSchedulingManual mode.
+ *
+ * @param elapsedTime The time elapsed since the last step, in seconds.
+ */
+- (void) step:(float) elapsedTime;
+
+/** Advance all running actions by the time elapsed on OALClockNow() since the last timed step.
+ * With a virtual clock (see OALClock.h) and manual scheduling, tests and offline
+ * renders can move the clock forward and then call this to run actions deterministically.
+ */
+- (void) stepWithClock;
+
 
 #pragma mark Internal Use
 
@@ -95,6 +250,29 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALActionManager);
  * @param action The action that is stopping.
  */
 - (void) notifyActionStopped:(OALAction*) action;
+
+/** (INTERNAL USE) Get the time elapsed for a running action.
+ *
+ * @param action The action.
+ * @return The time elapsed, or NAN if the action isn't being stepped by the manager yet.
+ */
+- (float) elapsedForAction:(OALAction*) action;
+
+/** (INTERNAL USE) Set the time elapsed for a running action.
+ *
+ * @param elapsed The time elapsed.
+ * @param action The action.
+ */
+- (void) setElapsed:(float) elapsed forAction:(OALAction*) action;
+
+/** (INTERNAL USE) Restart an action from the beginning, rewinding it in the slot
+ * it already holds or queueing it if it has none. The check and the restart happen
+ * under the manager's lock, so a step can't slip in between them. Used by
+ * OALRampAction to re-arm.
+ *
+ * @param action The action.
+ */
+- (void) rearmOrStartAction:(OALAction*) action;
 /** \endcond */
 
 @end
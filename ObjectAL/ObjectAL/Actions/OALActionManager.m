@@ -28,10 +28,11 @@
 //
 
 #import "OALActionManager.h"
-#import "mach_timing.h"
+#import "OALClock.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
-#import "NSMutableArray+WeakReferences.h"
+#import "OALAction+Private.h"
+#import "ease_batch.h"
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 #import <UIKit/UIKit.h>
 #endif
@@ -49,6 +50,52 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OALActionManager);
 /** Resets the time delta in cases where proper time delta calculations become impossible.
  */
 - (void) doResetTimeDelta:(NSNotification*) notification;
+
+/** Called by the step timer in OALActionSchedulingRunLoop mode.
+ */
+- (void) onStepTimer:(NSTimer*) timer;
+
+/** Start the run loop timer. Must be called while synchronized.
+ */
+- (void) startStepTimer;
+
+/** Start the step thread. Must be called while synchronized.
+ */
+- (void) startStepThread;
+
+/** Stop the step thread and wait for it to finish. When called from the step
+ * thread itself (from an action), it returns straight away and the thread exits
+ * once the current step is done.
+ * Must NOT be called while synchronized, since the step thread needs the lock to finish its step.
+ */
+- (void) stopStepThread;
+
+/** Main loop of the step thread.
+ */
+- (void) stepThreadMain:(id) object;
+
+/** Append an action to the slot arrays. Must be called while synchronized.
+ */
+- (void) addSlot:(OALAction*) action;
+
+/** Remove a slot by moving the last slot into its place. Must be called while synchronized.
+ */
+- (void) removeSlot:(NSInteger) index;
+
+/** Replace the progress of all eased slots with their eased values, one curve at a time.
+ * Must be called while synchronized.
+ *
+ * @param easeCounts The number of slots using each curve.
+ */
+- (void) easeSlots:(NSUInteger*) easeCounts;
+
+/** Check whether an action is still at or past its end. An action may have
+ * wound its elapsed time back while it was being updated (a looping envelope).
+ *
+ * @param action The action to check.
+ * @return TRUE if the action has run to its end, or isn't in a slot any more.
+ */
+- (bool) actionReachedEnd:(OALAction*) action;
 /** \endcond */
 
 @end
@@ -66,10 +113,14 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 {
 	if(nil != (self = [super init]))
 	{
-		targets = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:50];
-		targetActions = [[NSMutableArray alloc] initWithCapacity:50];
 		actionsToAdd = [[NSMutableArray alloc] initWithCapacity:100];
 		actionsToRemove = [[NSMutableArray alloc] initWithCapacity:100];
+		actionsToRelease = [[NSMutableArray alloc] initWithCapacity:100];
+		wakeSignal = dispatch_semaphore_create(0);
+		stoppedSignal = dispatch_semaphore_create(0);
+		scheduling = OALActionSchedulingRunLoop;
+		tickInterval = kActionStepInterval;
+		lastTimestamp = -1;
 
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 		[[NSNotificationCenter defaultCenter] addObserver:self
@@ -92,17 +143,115 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 - (void) dealloc
 {
 	[[NSNotificationCenter defaultCenter] removeObserver:self];
-	as_release(targets);
-	as_release(targetActions);
+	[self stopStepThread];
+	[stepTimer invalidate];
+	as_release(stepThread);
+	while(slotCount > 0)
+	{
+		[self removeSlot:(NSInteger)slotCount - 1];
+	}
+	free(slotActions);
+	free(slotUpdates);
+	free(slotElapsed);
+	free(slotDuration);
+	free(slotReceivers);
+	free(slotEase);
+	free(slotGeneration);
+	free(slotProgress);
+	free(easeOrder);
+	free(easeValues);
+	free(stepEntries);
 	as_release(actionsToAdd);
 	as_release(actionsToRemove);
+	as_release(actionsToRelease);
+#if !__has_feature(objc_arc)
+	dispatch_release(wakeSignal);
+	dispatch_release(stoppedSignal);
+#endif
 	as_superdealloc();
 }
 
 - (void) doResetTimeDelta:(NSNotification*) notification
 {
     #pragma unused(notification)
-	lastTimestamp = 0;
+	lastTimestamp = -1;
+}
+
+
+#pragma mark Properties
+
+- (OALActionScheduling) scheduling
+{
+	return scheduling;
+}
+
+- (void) setScheduling:(OALActionScheduling) value
+{
+	bool wasThreaded = NO;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value == scheduling)
+		{
+			return;
+		}
+		wasThreaded = OALActionSchedulingThread == scheduling;
+		[stepTimer invalidate];
+		stepTimer = nil;
+		scheduling = value;
+	}
+
+	// The step thread may be waiting on the lock, so stop it outside of it.
+	if(wasThreaded)
+	{
+		[self stopStepThread];
+	}
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// The switch is a break in timing, so the next step counts from zero.
+		lastTimestamp = -1;
+		switch(scheduling)
+		{
+			case OALActionSchedulingRunLoop:
+				if(slotCount > 0 || [actionsToAdd count] > 0)
+				{
+					[self startStepTimer];
+				}
+				break;
+			case OALActionSchedulingThread:
+				[self startStepThread];
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+- (NSTimeInterval) tickInterval
+{
+	return tickInterval;
+}
+
+- (void) setTickInterval:(NSTimeInterval) value
+{
+	if(value <= 0)
+	{
+		OAL_LOG_ERROR(@"%@: Invalid tick interval %f", self, value);
+		return;
+	}
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		tickInterval = value;
+
+		// Reschedule the timer so that the new interval takes effect immediately.
+		if(nil != stepTimer)
+		{
+			[stepTimer invalidate];
+			stepTimer = nil;
+			[self startStepTimer];
+		}
+	}
 }
 
 
@@ -110,106 +259,453 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 
 - (void) stopAllActions
 {
+	NSMutableArray* actions;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		for(NSMutableArray* actions in targetActions)
+		actions = [NSMutableArray arrayWithArray:actionsToAdd];
+		for(NSUInteger i = 0; i < slotCount; i++)
 		{
-			[actions makeObjectsPerformSelector:@selector(stopAction)];
+			[actions addObject:(as_bridge OALAction*)slotActions[i]];
 		}
-		
-		[actionsToAdd makeObjectsPerformSelector:@selector(stopAction)];
 	}
+
+	// Stopping calls completion callbacks, so do it outside of the lock.
+	[actions makeObjectsPerformSelector:@selector(stopAction)];
 }
 
 
 #pragma mark Timer Interface
 
-- (void) step:(NSTimer*) timer
+- (void) startStepTimer
+{
+	stepTimer = [NSTimer scheduledTimerWithTimeInterval:tickInterval
+												 target:self
+											   selector:@selector(onStepTimer:)
+											   userInfo:nil
+												repeats:YES];
+}
+
+- (void) onStepTimer:(NSTimer*) timer
 {
     #pragma unused(timer)
+	[self stepWithClock];
+}
+
+- (void) stepWithClock
+{
+	float elapsedTime = 0;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		// Get the time elapsed and update timestamp.
+		// If there was a break in timing (lastTimestamp < 0), assume 0 time has elapsed.
+		double currentTime = OALClockNow();
+		if(lastTimestamp >= 0)
+		{
+			elapsedTime = (float)(currentTime - lastTimestamp);
+		}
+		lastTimestamp = currentTime;
+	}
+
+	[self step:elapsedTime];
+}
+
+- (void) step:(float) elapsedTime
+{
+	OALActionStepEntry* entries = NULL;
+	NSUInteger entriesCapacity = 0;
+	NSUInteger count = 0;
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// Remove stopped actions first, so that an action which was stopped and
+		// restarted since the last step gets re-added fresh.
+		for(OALAction* action in actionsToRemove)
+		{
+			[self removeSlot:action.managerIndex];
+		}
+		[actionsToRemove removeAllObjects];
+
 		// Add new actions
 		for(OALAction* action in actionsToAdd)
 		{
 			// But only if they haven't been stopped already
-			if(action.running)
+			if(action.running && action.managerIndex < 0)
 			{
-				NSUInteger index = [targets indexOfObject:action.target];
-				if(NSNotFound == index)
-				{
-					// Since this target has no running actions yet, add the support
-					// structure to keep track of it.
-					index = [targets count];
-					[targets addObject:action.target];
-					[targetActions addObject:[NSMutableArray arrayWithCapacity:5]];
-				}
-
-				// Get the list of actions operating on this target and add the new action.
-				NSMutableArray* actions = [targetActions objectAtIndex:index];
-				[actions addObject:action];
+				[self addSlot:action];
 			}
 		}
 		// All actions have been added.  Clear the "add" list.
 		[actionsToAdd removeAllObjects];
-		
 
-		// Remove stopped actions
-		for(OALAction* action in actionsToRemove)
+		// If there are no more actions running, stop the master timer.
+		if(0 == slotCount)
+		{
+			[stepTimer invalidate];
+			stepTimer = nil;
+			return;
+		}
+
+		// Work out the progress of all remaining actions. The slot arrays can't
+		// change while we're in here, since stops and starts only get queued.
+		count = slotCount;
+		NSUInteger easeCounts[kEaseBatchShapeCount * kEaseBatchPhaseCount] = {0};
+		bool anyEased = NO;
+		for(NSUInteger i = 0; i < count; i++)
 		{
-			NSUInteger index = [targets indexOfObject:action.target];
-			if(NSNotFound != index)
+			slotElapsed[i] += elapsedTime;
+			float proportionComplete = slotElapsed[i] / slotDuration[i];
+			slotProgress[i] = proportionComplete < 1.0f ? proportionComplete : 1.0f;
+			if(slotEase[i] >= 0)
 			{
-				// Remove the action.
-				NSMutableArray* actions = [targetActions objectAtIndex:index];
-				[actions removeObject:action];
-				if([actions count] == 0)
-				{
-					// If there are no more actions for this target, stop tracking it.
-					[targets removeObjectAtIndex:index];
-					[targetActions removeObjectAtIndex:index];
-					
-					// If there are no more actions running, stop the master timer.
-					if([targets count] == 0)
-					{
-						[stepTimer invalidate];
-						stepTimer = nil;
-						break;
-					}
-				}
+				easeCounts[slotEase[i]]++;
+				anyEased = YES;
 			}
 		}
-		[actionsToRemove removeAllObjects];
-		
-		// Get the time elapsed and update timestamp.
-		// If there was a break in timing (lastTimestamp == 0), assume 0 time has elapsed.
-		uint64_t currentTime = mach_absolute_time();
-		float elapsedTime = 0;
-		if(lastTimestamp > 0)
+
+		if(anyEased)
 		{
-			elapsedTime = (float)mach_absolute_difference_seconds(currentTime, lastTimestamp);
+			[self easeSlots:easeCounts];
 		}
-		lastTimestamp = currentTime;
 
-		// Update all remaining actions, if any
-		for(NSMutableArray* actions in targetActions)
+		// Updates call property setters, and stops call completion callbacks,
+		// both of which take other locks. Take a snapshot so that they can run
+		// after the lock is released.
+		entries = stepEntries;
+		entriesCapacity = stepEntriesCapacity;
+		stepEntries = NULL;
+		stepEntriesCapacity = 0;
+		if(entriesCapacity < count)
+		{
+			entriesCapacity = count > slotCapacity ? count : slotCapacity;
+			entries = (OALActionStepEntry*)realloc(entries, entriesCapacity * sizeof(*entries));
+		}
+		for(NSUInteger i = 0; i < count; i++)
+		{
+			OALActionStepEntry* entry = &entries[i];
+			entry->action = slotActions[i];
+			entry->receiver = slotReceivers[i];
+			entry->update = slotUpdates[i];
+			entry->progress = slotProgress[i];
+			entry->finished = slotElapsed[i] / slotDuration[i] >= 1.0f;
+			entry->generation = slotGeneration[i];
+		}
+
+		// Until this step is done, removeSlot: holds on to what it removes.
+		stepsInFlight++;
+	}
+
+	for(NSUInteger i = 0; i < count; i++)
+	{
+		OALActionStepEntry* entry = &entries[i];
+		as_unsafe_unretained OALAction* action = (as_bridge OALAction*)entry->action;
+
+		// Skip actions that were stopped or restarted since the snapshot.
+		if(OALActionIsRunningGeneration(action, entry->generation))
 		{
-			for(OALAction* action in actions)
+			entry->update((as_bridge id)entry->receiver, @selector(updateCompletion:), entry->progress);
+			if(entry->finished && [self actionReachedEnd:action])
 			{
-				action.elapsed += elapsedTime;
-				float proportionComplete = action.elapsed / action.duration;
-				if(proportionComplete < 1.0f)
-				{
-					[action updateCompletion:proportionComplete];
-				}
-				else
-				{
-					[action updateCompletion:1.0f];
-					[action stopAction];
-				}
+				[action finishGeneration:entry->generation];
 			}
 		}
 	}
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(0 == --stepsInFlight)
+		{
+			[actionsToRelease removeAllObjects];
+		}
+
+		// Hand the scratch space back, unless another step already did.
+		if(NULL == stepEntries)
+		{
+			stepEntries = entries;
+			stepEntriesCapacity = entriesCapacity;
+			entries = NULL;
+		}
+	}
+	free(entries);
+}
+
+- (void) easeSlots:(NSUInteger*) easeCounts
+{
+	// Bucket the eased slots by curve, so that each curve is one contiguous run.
+	NSUInteger groupStart[kEaseBatchShapeCount * kEaseBatchPhaseCount];
+	NSUInteger groupEnd[kEaseBatchShapeCount * kEaseBatchPhaseCount];
+	NSUInteger offset = 0;
+	for(int group = 0; group < kEaseBatchShapeCount * kEaseBatchPhaseCount; group++)
+	{
+		groupStart[group] = groupEnd[group] = offset;
+		offset += easeCounts[group];
+	}
+	for(NSUInteger i = 0; i < slotCount; i++)
+	{
+		int group = slotEase[i];
+		if(group >= 0)
+		{
+			NSUInteger position = groupEnd[group]++;
+			easeOrder[position] = i;
+			easeValues[position] = slotProgress[i];
+		}
+	}
+
+	// Evaluate each curve in one pass and scatter the results back.
+	for(int group = 0; group < kEaseBatchShapeCount * kEaseBatchPhaseCount; group++)
+	{
+		NSUInteger start = groupStart[group];
+		NSUInteger end = groupEnd[group];
+		if(start == end)
+		{
+			continue;
+		}
+		ease_batch_evaluate(group / kEaseBatchPhaseCount,
+							group % kEaseBatchPhaseCount,
+							easeValues + start,
+							easeValues + start,
+							end - start);
+		for(NSUInteger position = start; position < end; position++)
+		{
+			slotProgress[easeOrder[position]] = easeValues[position];
+		}
+	}
+}
+
+
+#pragma mark Slot Storage
+
+- (void) addSlot:(OALAction*) action
+{
+	if(slotCount == slotCapacity)
+	{
+		NSUInteger capacity = slotCapacity > 0 ? slotCapacity * 2 : 64;
+		slotActions = (CFTypeRef*)realloc(slotActions, capacity * sizeof(*slotActions));
+		slotUpdates = (OALActionUpdateFunc*)realloc(slotUpdates, capacity * sizeof(*slotUpdates));
+		slotElapsed = (float*)realloc(slotElapsed, capacity * sizeof(*slotElapsed));
+		slotDuration = (float*)realloc(slotDuration, capacity * sizeof(*slotDuration));
+		slotReceivers = (CFTypeRef*)realloc(slotReceivers, capacity * sizeof(*slotReceivers));
+		slotEase = (int8_t*)realloc(slotEase, capacity * sizeof(*slotEase));
+		slotGeneration = (uint32_t*)realloc(slotGeneration, capacity * sizeof(*slotGeneration));
+		slotProgress = (float*)realloc(slotProgress, capacity * sizeof(*slotProgress));
+		easeOrder = (NSUInteger*)realloc(easeOrder, capacity * sizeof(*easeOrder));
+		easeValues = (float*)realloc(easeValues, capacity * sizeof(*easeValues));
+		slotCapacity = capacity;
+	}
+
+	NSUInteger index = slotCount++;
+	slotActions[index] = CFRetain((as_bridge CFTypeRef)action);
+	slotUpdates[index] = (OALActionUpdateFunc)[action methodForSelector:@selector(updateCompletion:)];
+	slotReceivers[index] = slotActions[index];
+	slotEase[index] = -1;
+	slotGeneration[index] = action.armGeneration;
+	slotElapsed[index] = action.elapsed;
+	slotDuration[index] = action.duration;
+
+	// Ease actions get their curve evaluated in batches, and the manager then
+	// updates the eased action directly. Subclasses that override
+	// updateCompletion: are left alone.
+	if([action isKindOfClass:[OALEaseAction class]] &&
+	   slotUpdates[index] == (OALActionUpdateFunc)[OALEaseAction instanceMethodForSelector:@selector(updateCompletion:)])
+	{
+		OALEaseAction* easeAction = (OALEaseAction*)action;
+		OALAction* easedAction = easeAction.action;
+		if(nil != easedAction)
+		{
+			slotReceivers[index] = (as_bridge CFTypeRef)easedAction;
+			slotUpdates[index] = (OALActionUpdateFunc)[easedAction methodForSelector:@selector(updateCompletion:)];
+			slotEase[index] = (int8_t)(easeAction.shape * kEaseBatchPhaseCount + easeAction.phase);
+		}
+	}
+	action.managerIndex = (NSInteger)index;
+}
+
+- (void) removeSlot:(NSInteger) index
+{
+	if(index < 0 || (NSUInteger)index >= slotCount)
+	{
+		return;
+	}
+
+	OALAction* action = (as_bridge OALAction*)slotActions[index];
+	action.managerIndex = -1;
+	action.elapsed = slotElapsed[index];
+
+	// Move the last slot into the hole.
+	NSUInteger last = --slotCount;
+	if((NSUInteger)index != last)
+	{
+		slotActions[index] = slotActions[last];
+		slotUpdates[index] = slotUpdates[last];
+		slotElapsed[index] = slotElapsed[last];
+		slotDuration[index] = slotDuration[last];
+		slotReceivers[index] = slotReceivers[last];
+		slotEase[index] = slotEase[last];
+		slotGeneration[index] = slotGeneration[last];
+		((as_bridge OALAction*)slotActions[index]).managerIndex = (NSInteger)index;
+	}
+	slotActions[last] = NULL;
+
+	// A step may still be updating it outside of the lock.
+	if(stepsInFlight > 0)
+	{
+		[actionsToRelease addObject:action];
+	}
+	CFRelease((as_bridge CFTypeRef)action);
+}
+
+- (float) elapsedForAction:(OALAction*) action
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSInteger index = action.managerIndex;
+		if(index >= 0 && (NSUInteger)index < slotCount && slotActions[index] == (as_bridge CFTypeRef)action)
+		{
+			return slotElapsed[index];
+		}
+	}
+	return NAN;
+}
+
+- (bool) actionReachedEnd:(OALAction*) action
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSInteger index = action.managerIndex;
+		if(index >= 0 && (NSUInteger)index < slotCount && slotActions[index] == (as_bridge CFTypeRef)action)
+		{
+			return slotElapsed[index] / slotDuration[index] >= 1.0f;
+		}
+	}
+	return YES;
+}
+
+- (void) setElapsed:(float) elapsed forAction:(OALAction*) action
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSInteger index = action.managerIndex;
+		if(index >= 0 && (NSUInteger)index < slotCount && slotActions[index] == (as_bridge CFTypeRef)action)
+		{
+			slotElapsed[index] = elapsed;
+		}
+	}
+}
+
+- (void) rearmOrStartAction:(OALAction*) action
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[actionsToRemove removeObjectIdenticalTo:action];
+
+		NSInteger index = action.managerIndex;
+		bool hasSlot = index >= 0 && (NSUInteger)index < slotCount && slotActions[index] == (as_bridge CFTypeRef)action;
+		if(!hasSlot && NSNotFound == [actionsToAdd indexOfObjectIdenticalTo:action])
+		{
+			[self notifyActionStarted:action];
+		}
+
+		action.elapsed = 0;
+		action.armGeneration++;
+		action.running = YES;
+		action.runningInManager = YES;
+		if(hasSlot)
+		{
+			slotDuration[index] = action.duration;
+			slotGeneration[index] = action.armGeneration;
+		}
+	}
+}
+
+
+#pragma mark Step Thread
+
+- (void) startStepThread
+{
+	if(stepThreadRunning)
+	{
+		return;
+	}
+
+	stepThreadRunning = YES;
+	as_release(stepThread);
+	stepThread = [[NSThread alloc] initWithTarget:self selector:@selector(stepThreadMain:) object:nil];
+	[stepThread setName:@"ObjectAL Action Scheduler"];
+	[stepThread setThreadPriority:0.9];
+	[stepThread start];
+	OAL_LOG_DEBUG(@"%@: Started step thread", self);
+}
+
+- (void) stopStepThread
+{
+	bool wait = NO;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(!stepThreadRunning)
+		{
+			return;
+		}
+		stepThreadRunning = NO;
+
+		// The step thread can't wait for itself. It only signals stoppedSignal
+		// when someone is waiting, so that the count never goes stale.
+		wait = [NSThread currentThread] != stepThread;
+		stepThreadJoinPending = wait;
+	}
+
+	dispatch_semaphore_signal(wakeSignal);
+	if(wait)
+	{
+		dispatch_semaphore_wait(stoppedSignal, DISPATCH_TIME_FOREVER);
+	}
+	OAL_LOG_DEBUG(@"%@: Stopped step thread", self);
+}
+
+- (void) stepThreadMain:(id) object
+{
+	#pragma unused(object)
+	NSThread* thisThread = [NSThread currentThread];
+
+	// If this thread was stopped from within a step and a new one started
+	// since, stepThread has moved on and this one just exits.
+	while(stepThreadRunning && thisThread == stepThread)
+	{
+		as_autoreleasepool_start(pool);
+
+		bool idle = YES;
+		OPTIONALLY_SYNCHRONIZED(self)
+		{
+			idle = 0 == slotCount && [actionsToAdd count] == 0;
+		}
+
+		if(idle)
+		{
+			// Nothing to do, so sleep until notifyActionStarted: wakes us up.
+			dispatch_semaphore_wait(wakeSignal, DISPATCH_TIME_FOREVER);
+		}
+		else
+		{
+			double tickStart = OALClockMonotonicSeconds();
+			[self stepWithClock];
+
+			// Sleep for whatever is left of this tick.
+			double remaining = tickInterval - (OALClockMonotonicSeconds() - tickStart);
+			if(remaining > 0)
+			{
+				dispatch_semaphore_wait(wakeSignal, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(remaining * NSEC_PER_SEC)));
+			}
+		}
+
+		as_autoreleasepool_end(pool);
+	}
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(stepThreadJoinPending && thisThread == stepThread)
+		{
+			stepThreadJoinPending = NO;
+			dispatch_semaphore_signal(stoppedSignal);
+		}
+	}
 }
 
 
@@ -222,16 +718,22 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 		[actionsToAdd addObject:action];
 		
 		// Start the timer if it hasn't been started yet and there are actions to perform.
-		if([targets count] == 0 && [actionsToAdd count] == 1)
+		if(0 == slotCount && [actionsToAdd count] == 1)
 		{
-			stepTimer = [NSTimer scheduledTimerWithTimeInterval:kActionStepInterval
-														 target:self
-													   selector:@selector(step:)
-													   userInfo:nil
-														repeats:YES];
+			switch(scheduling)
+			{
+				case OALActionSchedulingRunLoop:
+					[self startStepTimer];
+					break;
+				case OALActionSchedulingThread:
+					dispatch_semaphore_signal(wakeSignal);
+					break;
+				default:
+					break;
+			}
 
 			// Reset timestamp since we have been off for awhile.
-			lastTimestamp = 0;
+			lastTimestamp = -1;
 		}
 	}
 }
@@ -0,0 +1,193 @@
+//
+//  OALEnvelope.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALAction.h"
+
+
+#pragma mark OALEnvelopeCurve
+
+/** The curve a segment of an envelope follows, from one breakpoint to the next.
+ */
+typedef enum
+{
+	/** Straight line to the next breakpoint. */
+	kOALEnvelopeCurveLinear,
+	/** Keep this breakpoint's value until the next breakpoint. */
+	kOALEnvelopeCurveHold,
+	/** Sine ease in (see OALEaseAction). */
+	kOALEnvelopeCurveSineIn,
+	/** Sine ease out. */
+	kOALEnvelopeCurveSineOut,
+	/** Sine ease in and out. */
+	kOALEnvelopeCurveSineInOut,
+	/** Exponential ease in. */
+	kOALEnvelopeCurveExponentialIn,
+	/** Exponential ease out. */
+	kOALEnvelopeCurveExponentialOut,
+	/** Exponential ease in and out. */
+	kOALEnvelopeCurveExponentialInOut,
+} OALEnvelopeCurve;
+
+
+#pragma mark OALBreakpoint
+
+/** A point in an envelope.
+ */
+typedef struct
+{
+	/** Time of this breakpoint from the start of the envelope, in seconds. */
+	float time;
+	/** Value at this breakpoint. */
+	float value;
+	/** Curve followed from this breakpoint to the next one. */
+	OALEnvelopeCurve curve;
+} OALBreakpoint;
+
+/** Make a breakpoint.
+ *
+ * @param time Time from the start of the envelope, in seconds.
+ * @param value Value at this time.
+ * @param curve Curve to follow to the next breakpoint.
+ * @return The breakpoint.
+ */
+static inline OALBreakpoint OALBreakpointMake(float time, float value, OALEnvelopeCurve curve)
+{
+	OALBreakpoint breakpoint = {time, value, curve};
+	return breakpoint;
+}
+
+
+#pragma mark -
+#pragma mark OALEnvelope
+
+/**
+ * A series of breakpoints describing how a value changes over time. <br><br>
+ *
+ * Envelopes are immutable, so one envelope can be shared by any number of
+ * OALEnvelopeActions running on different targets at the same time.
+ */
+@interface OALEnvelope: NSObject
+{
+	/** The breakpoints, sorted by time. */
+	OALBreakpoint* breakpoints_;
+	/** The number of breakpoints. */
+	NSUInteger count_;
+	/** Ease function for each breakpoint's curve, or NULL for linear and hold. */
+	EaseFunctionPtr* curveFunctions_;
+}
+
+/** The number of breakpoints. */
+@property(nonatomic,readonly,assign) NSUInteger count;
+
+/** The breakpoints, sorted by time. */
+@property(nonatomic,readonly,assign) const OALBreakpoint* breakpoints;
+
+/** The time of the last breakpoint, in seconds. */
+@property(nonatomic,readonly,assign) float duration;
+
+/** Create an envelope.
+ *
+ * @param breakpoints The breakpoints, sorted by time. They will be copied.
+ * @param count The number of breakpoints (at least 1).
+ * @return A new envelope, or nil if the breakpoints are not in order.
+ */
++ (id) envelopeWithBreakpoints:(const OALBreakpoint*) breakpoints count:(NSUInteger) count;
+
+/** Initialize an envelope.
+ *
+ * @param breakpoints The breakpoints, sorted by time. They will be copied.
+ * @param count The number of breakpoints (at least 1).
+ * @return The initialized envelope, or nil if the breakpoints are not in order.
+ */
+- (id) initWithBreakpoints:(const OALBreakpoint*) breakpoints count:(NSUInteger) count;
+
+/** Get the envelope's value at a point in time. <br>
+ * Envelopes are usually read moving forward in time, so the search for the
+ * current segment starts where the last one ended. That makes sequential
+ * reads O(1) amortized.
+ *
+ * @param time The time from the start of the envelope, in seconds.
+ *             Values before the start or after the end are held at the first or last value.
+ * @param cursor Where the search starts and where the segment found is stored.
+ *               Each reader keeps its own cursor (start at 0).
+ * @return The value at that time.
+ */
+- (float) valueAtTime:(float) time cursor:(NSUInteger*) cursor;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALEnvelopeAction
+
+/**
+ * Drives a property of the target through an envelope. <br><br>
+ *
+ * Builds complex automation (for example a gain or pitch curve) as a single action,
+ * rather than a sequence of property actions.
+ */
+@interface OALEnvelopeAction: OALPropertyAction
+{
+	/** The envelope to follow. */
+	OALEnvelope* envelope_;
+	/** The segment of the envelope that was last evaluated. */
+	NSUInteger cursor_;
+	/** If true, the envelope starts over when it reaches the end. */
+	bool loops_;
+}
+
+/** The envelope to follow. */
+@property(nonatomic,readonly,retain) OALEnvelope* envelope;
+
+/** If true, the envelope starts over when it reaches the end, and the action runs until stopped.
+ * Looping is not available when using cocos2d actions.
+ */
+@property(nonatomic,readonly,assign) bool loops;
+
+/** Create an action.
+ *
+ * @param envelope The envelope to follow.
+ * @param propertyKey The property to modify.
+ * @param loops If true, repeat the envelope until the action is stopped.
+ * @return A new action.
+ */
++ (id) actionWithEnvelope:(OALEnvelope*) envelope
+			  propertyKey:(NSString*) propertyKey
+					loops:(bool) loops;
+
+/** Initialize an action.
+ *
+ * @param envelope The envelope to follow.
+ * @param propertyKey The property to modify.
+ * @param loops If true, repeat the envelope until the action is stopped.
+ * @return The initialized action.
+ */
+- (id) initWithEnvelope:(OALEnvelope*) envelope
+			propertyKey:(NSString*) propertyKey
+				  loops:(bool) loops;
+
+@end
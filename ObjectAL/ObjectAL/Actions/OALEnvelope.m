@@ -0,0 +1,236 @@
+//
+//  OALEnvelope.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALEnvelope.h"
+#import "OALAction+Private.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+
+
+#pragma mark OALEnvelope
+
+@implementation OALEnvelope
+
+#pragma mark Object Management
+
++ (id) envelopeWithBreakpoints:(const OALBreakpoint*) breakpoints count:(NSUInteger) count
+{
+	return as_autorelease([[self alloc] initWithBreakpoints:breakpoints count:count]);
+}
+
+- (id) initWithBreakpoints:(const OALBreakpoint*) breakpoints count:(NSUInteger) count
+{
+	if(nil != (self = [super init]))
+	{
+		if(0 == count || NULL == breakpoints)
+		{
+			OAL_LOG_ERROR(@"%@: Envelope needs at least one breakpoint", self);
+			goto initFailed;
+		}
+		for(NSUInteger i = 1; i < count; i++)
+		{
+			if(breakpoints[i].time < breakpoints[i-1].time)
+			{
+				OAL_LOG_ERROR(@"%@: Breakpoint %lu (%f) comes before the one preceding it (%f)",
+							  self, (unsigned long)i, breakpoints[i].time, breakpoints[i-1].time);
+				goto initFailed;
+			}
+		}
+
+		count_ = count;
+		breakpoints_ = (OALBreakpoint*)malloc(count * sizeof(*breakpoints_));
+		memcpy(breakpoints_, breakpoints, count * sizeof(*breakpoints_));
+
+		curveFunctions_ = (EaseFunctionPtr*)calloc(count, sizeof(*curveFunctions_));
+		for(NSUInteger i = 0; i < count; i++)
+		{
+			OALEnvelopeCurve curve = breakpoints_[i].curve;
+			if(curve >= kOALEnvelopeCurveSineIn && curve <= kOALEnvelopeCurveExponentialInOut)
+			{
+				int index = curve - kOALEnvelopeCurveSineIn;
+				curveFunctions_[i] = [OALEaseAction easeFunctionForShape:(OALEaseShape)(index / 3)
+																   phase:(OALEasePhase)(index % 3)];
+			}
+		}
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
+- (void) dealloc
+{
+	free(breakpoints_);
+	free(curveFunctions_);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize count = count_;
+
+- (const OALBreakpoint*) breakpoints
+{
+	return breakpoints_;
+}
+
+- (float) duration
+{
+	return breakpoints_[count_ - 1].time;
+}
+
+
+#pragma mark Evaluation
+
+- (float) valueAtTime:(float) time cursor:(NSUInteger*) cursor
+{
+	NSUInteger last = count_ - 1;
+	if(time <= breakpoints_[0].time)
+	{
+		*cursor = 0;
+		return breakpoints_[0].value;
+	}
+	if(time >= breakpoints_[last].time)
+	{
+		*cursor = last;
+		return breakpoints_[last].value;
+	}
+
+	// Time normally only moves forward, so carry on from the last segment.
+	// If it went backwards (a loop or restart), search again from the start.
+	NSUInteger index = *cursor;
+	if(index >= last || breakpoints_[index].time > time)
+	{
+		index = 0;
+	}
+	while(breakpoints_[index + 1].time <= time)
+	{
+		index++;
+	}
+	*cursor = index;
+
+	const OALBreakpoint* from = &breakpoints_[index];
+	const OALBreakpoint* to = &breakpoints_[index + 1];
+	if(kOALEnvelopeCurveHold == from->curve)
+	{
+		return from->value;
+	}
+
+	float proportion = (time - from->time) / (to->time - from->time);
+	if(NULL != curveFunctions_[index])
+	{
+		proportion = curveFunctions_[index](proportion);
+	}
+	return from->value + (to->value - from->value) * proportion;
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALEnvelopeAction
+
+@implementation OALEnvelopeAction
+
+#pragma mark Object Management
+
++ (id) actionWithEnvelope:(OALEnvelope*) envelope
+			  propertyKey:(NSString*) propertyKey
+					loops:(bool) loops
+{
+	return as_autorelease([[self alloc] initWithEnvelope:envelope
+											 propertyKey:propertyKey
+												   loops:loops]);
+}
+
+- (id) initWithEnvelope:(OALEnvelope*) envelope
+			propertyKey:(NSString*) propertyKey
+				  loops:(bool) loops
+{
+	if(nil == envelope)
+	{
+		OAL_LOG_ERROR(@"%@: Envelope action needs an envelope", self);
+		as_release(self);
+		return nil;
+	}
+
+	if(nil != (self = [super initWithDuration:envelope.duration
+								  propertyKey:propertyKey
+								   startValue:envelope.breakpoints[0].value
+									 endValue:envelope.breakpoints[envelope.count - 1].value]))
+	{
+		envelope_ = as_retain(envelope);
+		loops_ = loops;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	as_release(envelope_);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize envelope = envelope_;
+@synthesize loops = loops_;
+
+
+#pragma mark Functions
+
+- (void) prepareWithTarget:(id) target
+{
+	[super prepareWithTarget:target];
+	cursor_ = 0;
+}
+
+- (void) updateCompletion:(float) proportionComplete
+{
+	float duration = self.duration;
+	float time = proportionComplete * duration;
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	// At the end of a loop, wind the elapsed time back by one cycle.
+	// When the manager sees an action reach its end, it reads the elapsed
+	// time again after the update, so it will see the rewound time and keep
+	// the action running.
+	if(loops_ && proportionComplete >= 1.0f && duration > 0)
+	{
+		time = fmodf(self.elapsed, duration);
+		self.elapsed = time;
+	}
+#endif
+
+	[self applyValue:[envelope_ valueAtTime:time cursor:&cursor_]];
+}
+
+@end
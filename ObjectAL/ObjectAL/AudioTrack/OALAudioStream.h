@@ -0,0 +1,167 @@
+//
+//  OALAudioStream.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALSource.h"
+#import "OALAudioFile.h"
+#import "OALCrossfade.h"
+
+/** The number of buffers an OALAudioStream keeps queued. */
+#define kOALAudioStreamBufferCount 3
+
+/** The number of frames decoded into each buffer. */
+#define kOALAudioStreamBufferFrames 4096
+
+
+#pragma mark OALAudioStream
+
+/**
+ * Plays music through OpenAL by decoding a file a few blocks ahead into a
+ * buffer queue, and crossfades from one file to another inside the stream. <br><br>
+ *
+ * Fading two OALAudioTrack objects against each other with fadeTo: steps the
+ * gains at the action manager's rate, and the linear curves dip by 3 db in the
+ * middle. Here the crossfade is worked into the samples as they are decoded
+ * (see OALCrossfade.h): It follows an equal-power curve, changes on every
+ * frame, and ends on an exact frame, after which the outgoing file is closed
+ * straight away. <br><br>
+ *
+ * Every file is decoded to the sample rate and channel count of the file that
+ * started playback, so any two files can be crossfaded. <br><br>
+ *
+ * Use source to control gain, pan, position and so on. Buffers get refilled,
+ * and files decoded, by a timer on a background queue. If
+ * OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS is 0 nothing would keep that apart
+ * from your calls, so the timer runs on the main queue instead, and the
+ * stream must only be used from the main thread.
+ */
+@interface OALAudioStream : NSObject
+{
+	ALSource* source;
+	ALuint bufferIds[kOALAudioStreamBufferCount];
+	ALenum format;
+	Float64 sampleRate;
+	UInt32 channels;
+
+	/** One block of decoded audio from each file. The mix ends up in blockData. */
+	int16_t* blockData;
+	int16_t* incomingData;
+
+	/** The file being played, or faded out. */
+	OALAudioFile* file;
+	bool looping;
+
+	/** The file being faded in. */
+	OALAudioFile* incomingFile;
+	bool incomingLooping;
+
+	OALCrossfade crossfade;
+	bool playing;
+
+	/** Unqueues played buffers and refills them. */
+	dispatch_source_t refillTimer;
+}
+
+
+#pragma mark Properties
+
+/** The source the stream plays through. */
+@property(nonatomic,readonly,retain) ALSource* source;
+
+/** The URL of the file playing (the outgoing file during a crossfade). */
+@property(nonatomic,readonly,retain) NSURL* url;
+
+/** If true, the playing file starts over when it reaches its end. */
+@property(nonatomic,readwrite,assign) bool looping;
+
+/** If true, the stream is playing. It stops by itself once the file runs out. */
+@property(nonatomic,readonly,assign) bool playing;
+
+/** If true, a crossfade is in progress. */
+@property(nonatomic,readonly,assign) bool fading;
+
+
+#pragma mark Object Management
+
+/** Create a new stream on the current context.
+ *
+ * @return A new stream.
+ */
++ (id) stream;
+
+/** Initialize a stream on the current context.
+ *
+ * @return The initialized stream.
+ */
+- (id) init;
+
+
+#pragma mark Playback
+
+/** Stop whatever is playing, and play a file.
+ *
+ * @param path The file to play.
+ * @param loop If true, loop the file.
+ * @return TRUE if playback started.
+ */
+- (bool) playFile:(NSString*) path loop:(bool) loop;
+
+/** Stop whatever is playing, and play a URL.
+ *
+ * @param url The URL to play.
+ * @param loop If true, loop the file.
+ * @return TRUE if playback started.
+ */
+- (bool) playUrl:(NSURL*) url loop:(bool) loop;
+
+/** Crossfade from the playing file to another one. The fade starts with the
+ * first frame that hasn't been queued yet, so at most
+ * kOALAudioStreamBufferCount * kOALAudioStreamBufferFrames frames after this call.
+ * If nothing is playing, the file fades in from silence. If a crossfade is
+ * already in progress, the file being faded in becomes the outgoing file.
+ *
+ * @param path The file to fade to.
+ * @param loop If true, loop the new file.
+ * @param duration The length of the fade in seconds.
+ * @return TRUE if the crossfade started.
+ */
+- (bool) crossfadeToFile:(NSString*) path loop:(bool) loop duration:(float) duration;
+
+/** Crossfade from the playing file to another one (see crossfadeToFile:loop:duration:).
+ *
+ * @param url The URL to fade to.
+ * @param loop If true, loop the new file.
+ * @param duration The length of the fade in seconds.
+ * @return TRUE if the crossfade started.
+ */
+- (bool) crossfadeToUrl:(NSURL*) url loop:(bool) loop duration:(float) duration;
+
+/** Stop playback and close any open files.
+ */
+- (void) stop;
+
+@end
@@ -0,0 +1,434 @@
+//
+//  OALAudioStream.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALAudioStream.h"
+#import "ALWrapper.h"
+#import "OALTools.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "OALWeakReference.h"
+
+
+/** How often (in seconds) to check for played buffers. One buffer lasts
+ * about 90 ms at 44.1 kHz, so this leaves plenty of slack.
+ */
+#define kOALAudioStreamRefillInterval 0.025
+
+#if OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS
+/** Where refills (and so decoding) run. The stream's lock keeps them apart from
+ * the public methods.
+ */
+#define kOALAudioStreamRefillQueue dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+#else
+/** Where refills (and so decoding) run. Nothing locks the stream, so they run
+ * on the main thread along with everything else.
+ */
+#define kOALAudioStreamRefillQueue dispatch_get_main_queue()
+#endif
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALAudioStream.
+ */
+@interface OALAudioStream ()
+
+/** (INTERNAL USE) Open a file, converting it to the stream's format.
+ * If the stream isn't playing, the stream takes on the file's format instead.
+ */
+- (OALAudioFile*) openUrl:(NSURL*) url;
+
+/** (INTERNAL USE) Decode up to one block from a file, starting it over at the end if looping.
+ *
+ * @return The number of frames decoded.
+ */
+- (UInt32) decode:(OALAudioFile*) audioFile loop:(bool) loop into:(int16_t*) data;
+
+/** (INTERNAL USE) Decode the next block, mixing in the crossfade if there is one,
+ * and load it into an OpenAL buffer.
+ *
+ * @return FALSE if there was nothing left to play.
+ */
+- (bool) fillBuffer:(ALuint) bufferId;
+
+/** (INTERNAL USE) Fill and queue all buffers, and start playing.
+ */
+- (bool) start;
+
+/** (INTERNAL USE) Stop and release refillTimer, if there is one.
+ */
+- (void) cancelRefillTimer;
+
+/** (INTERNAL USE) Called by refillTimer.
+ */
+- (void) refill;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark OALAudioStream
+
+@implementation OALAudioStream
+
+#pragma mark Object Management
+
++ (id) stream
+{
+	return as_autorelease([[self alloc] init]);
+}
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init", self);
+		source = as_retain([ALSource source]);
+		if(nil == source)
+		{
+			OAL_LOG_ERROR(@"%@: Could not create a source", self);
+			goto initFailed;
+		}
+		if(![ALWrapper genBuffers:bufferIds numBuffers:kOALAudioStreamBufferCount])
+		{
+			OAL_LOG_ERROR(@"%@: Could not create buffers", self);
+			goto initFailed;
+		}
+		blockData = malloc(kOALAudioStreamBufferFrames * 2 * sizeof(*blockData));
+		incomingData = malloc(kOALAudioStreamBufferFrames * 2 * sizeof(*incomingData));
+		if(NULL == blockData || NULL == incomingData)
+		{
+			OAL_LOG_ERROR(@"%@: Could not allocate decode buffers", self);
+			goto initFailed;
+		}
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+	[self cancelRefillTimer];
+	[source stop];
+	[ALWrapper sourcei:source.sourceId parameter:AL_BUFFER value:AL_NONE];
+	if(0 != bufferIds[0])
+	{
+		[ALWrapper deleteBuffers:bufferIds numBuffers:kOALAudioStreamBufferCount];
+	}
+	free(blockData);
+	free(incomingData);
+	as_release(file);
+	as_release(incomingFile);
+	as_release(source);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize source;
+
+- (NSURL*) url
+{
+	return file.url;
+}
+
+@synthesize looping;
+
+@synthesize playing;
+
+- (bool) fading
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return nil != incomingFile;
+	}
+}
+
+
+#pragma mark Playback
+
+- (bool) playFile:(NSString*) path loop:(bool) loop
+{
+	return [self playUrl:[OALTools urlForPath:path] loop:loop];
+}
+
+- (bool) playUrl:(NSURL*) url loop:(bool) loop
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[self stop];
+
+		OALAudioFile* newFile = [self openUrl:url];
+		if(nil == newFile)
+		{
+			return NO;
+		}
+		file = as_retain(newFile);
+		looping = loop;
+		return [self start];
+	}
+}
+
+- (bool) crossfadeToFile:(NSString*) path loop:(bool) loop duration:(float) duration
+{
+	return [self crossfadeToUrl:[OALTools urlForPath:path] loop:loop duration:duration];
+}
+
+- (bool) crossfadeToUrl:(NSURL*) url loop:(bool) loop duration:(float) duration
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(!playing)
+		{
+			[self stop];
+		}
+
+		OALAudioFile* newFile = [self openUrl:url];
+		if(nil == newFile)
+		{
+			return NO;
+		}
+
+		if(nil != incomingFile)
+		{
+			as_release(file);
+			file = incomingFile;
+			looping = incomingLooping;
+		}
+		incomingFile = as_retain(newFile);
+		incomingLooping = loop;
+		OALCrossfadeInit(&crossfade, (int64_t)(duration * sampleRate));
+
+		if(!playing)
+		{
+			return [self start];
+		}
+		return YES;
+	}
+}
+
+- (void) stop
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[self cancelRefillTimer];
+		playing = NO;
+
+		[source stop];
+		[ALWrapper sourcei:source.sourceId parameter:AL_BUFFER value:AL_NONE];
+
+		as_release(file);
+		file = nil;
+		as_release(incomingFile);
+		incomingFile = nil;
+	}
+}
+
+
+#pragma mark Internal Use
+
+- (OALAudioFile*) openUrl:(NSURL*) url
+{
+	OALAudioFile* audioFile = [OALAudioFile fileWithUrl:url reduceToMono:NO];
+	if(nil == audioFile)
+	{
+		return nil;
+	}
+
+	if(!playing)
+	{
+		sampleRate = audioFile.streamDescription->mSampleRate;
+		channels = audioFile.streamDescription->mChannelsPerFrame;
+		format = 1 == channels ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+	}
+	if(![audioFile convertToChannels:channels sampleRate:sampleRate])
+	{
+		return nil;
+	}
+	return audioFile;
+}
+
+- (UInt32) decode:(OALAudioFile*) audioFile loop:(bool) loop into:(int16_t*) data
+{
+	UInt32 frames = 0;
+	bool rewound = NO;
+	while(nil != audioFile && frames < kOALAudioStreamBufferFrames)
+	{
+		UInt32 framesRead = [audioFile readFrames:kOALAudioStreamBufferFrames - frames into:data + frames * channels];
+		if(0 == framesRead)
+		{
+			// Only start over once in a row, in case the file is empty.
+			if(!loop || rewound || ![audioFile rewind])
+			{
+				break;
+			}
+			rewound = YES;
+			continue;
+		}
+		rewound = NO;
+		frames += framesRead;
+	}
+	return frames;
+}
+
+- (bool) fillBuffer:(ALuint) bufferId
+{
+	UInt32 frames = [self decode:file loop:looping into:blockData];
+
+	if(nil != incomingFile)
+	{
+		UInt32 incomingFrames = [self decode:incomingFile loop:incomingLooping into:incomingData];
+
+		// Whichever file runs out first goes silent for the rest of the block.
+		UInt32 mixFrames = frames > incomingFrames ? frames : incomingFrames;
+		memset(blockData + frames * channels, 0, (mixFrames - frames) * channels * sizeof(*blockData));
+		memset(incomingData + incomingFrames * channels, 0, (mixFrames - incomingFrames) * channels * sizeof(*incomingData));
+		OALCrossfadeMixInt16(&crossfade, blockData, incomingData, blockData, (int)mixFrames, (int)channels);
+		frames = mixFrames;
+
+		if(OALCrossfadeFinished(&crossfade))
+		{
+			// The outgoing file isn't needed any more, so close it right away.
+			OAL_LOG_DEBUG(@"%@: Crossfade to %@ complete", self, incomingFile.url);
+			as_release(file);
+			file = incomingFile;
+			looping = incomingLooping;
+			incomingFile = nil;
+		}
+	}
+
+	if(0 == frames)
+	{
+		return NO;
+	}
+	return [ALWrapper bufferData:bufferId
+						  format:format
+							data:blockData
+							size:(ALsizei)(frames * channels * sizeof(*blockData))
+					   frequency:(ALsizei)sampleRate];
+}
+
+- (bool) start
+{
+	ALsizei numBuffers = 0;
+	while(numBuffers < kOALAudioStreamBufferCount && [self fillBuffer:bufferIds[numBuffers]])
+	{
+		numBuffers++;
+	}
+	if(0 == numBuffers)
+	{
+		OAL_LOG_WARNING(@"%@: Nothing to play", self);
+		[self stop];
+		return NO;
+	}
+
+	[ALWrapper sourceQueueBuffers:source.sourceId numBuffers:numBuffers bufferIds:bufferIds];
+	if(nil == [source play])
+	{
+		[self stop];
+		return NO;
+	}
+	playing = YES;
+
+	// The timer only holds the stream weakly, so dropping the stream stops it.
+	OALWeakReference* reference = [OALWeakReference referenceWithTarget:self];
+	uint64_t interval = (uint64_t)(kOALAudioStreamRefillInterval * NSEC_PER_SEC);
+	[self cancelRefillTimer];
+	refillTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, kOALAudioStreamRefillQueue);
+	dispatch_source_set_timer(refillTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+	dispatch_source_set_event_handler(refillTimer, ^
+	{
+		as_autoreleasepool_start(pool);
+		[(OALAudioStream*)reference.target refill];
+		as_autoreleasepool_end(pool);
+	});
+	dispatch_resume(refillTimer);
+	return YES;
+}
+
+- (void) cancelRefillTimer
+{
+	if(NULL == refillTimer)
+	{
+		return;
+	}
+	dispatch_source_cancel(refillTimer);
+#if !__has_feature(objc_arc)
+	dispatch_release(refillTimer);
+#endif
+	refillTimer = NULL;
+}
+
+- (void) refill
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(!playing)
+		{
+			return;
+		}
+
+		ALuint sourceId = source.sourceId;
+		for(ALint processed = [ALWrapper getSourcei:sourceId parameter:AL_BUFFERS_PROCESSED]; processed > 0; processed--)
+		{
+			ALuint bufferId;
+			if(![ALWrapper sourceUnqueueBuffers:sourceId numBuffers:1 bufferIds:&bufferId])
+			{
+				break;
+			}
+			if([self fillBuffer:bufferId])
+			{
+				[ALWrapper sourceQueueBuffers:sourceId numBuffers:1 bufferIds:&bufferId];
+			}
+		}
+
+		if(0 == [ALWrapper getSourcei:sourceId parameter:AL_BUFFERS_QUEUED])
+		{
+			OAL_LOG_DEBUG(@"%@: Finished playing", self);
+			[self stop];
+			return;
+		}
+
+		// If a refill came too late, OpenAL will have stopped the source. Pausing is left alone.
+		if(AL_STOPPED == [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE])
+		{
+			OAL_LOG_WARNING(@"%@: Buffer underrun. Restarting", self);
+			[ALWrapper sourcePlay:sourceId];
+		}
+	}
+}
+
+@end
@@ -73,10 +73,10 @@
 	NSTimeInterval currentTime;
 	
 	/** The current action being applied to gain. */
-	OALAction* gainAction;
+	OALRampAction* gainAction;
 	
 	/** The current action being applied to pan. */
-	OALAction* panAction;
+	OALRampAction* panAction;
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
@@ -28,10 +28,8 @@
 //
 
 #import "OALAudioTrack.h"
-#import "OALAudioActions.h"
 #import "OALAudioTracks.h"
 #import "OALTools.h"
-#import "OALUtilityActions.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
 
@@ -253,9 +251,9 @@
 	as_release(operationQueue);
 	as_release(currentlyLoadedUrl);
 	as_release(simulatorPlayerRef);
-	[gainAction stopAction];
+	[gainAction cancel];
 	as_release(gainAction);
-	[panAction stopAction];
+	[panAction cancel];
 	as_release(panAction);
 	as_release(suspendHandler);
 	as_superdealloc();
@@ -815,17 +813,18 @@
 		 target:(id) target
 	   selector:(SEL) selector
 {
+	float startValue;
 	// Must always be synchronized
 	@synchronized(self)
 	{
-		[self stopFade];
-		gainAction = [OALSequentialActions actions:
-                      [OALPropertyAction gainActionWithDuration:duration endValue:value],
-                      [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                      nil];
-        gainAction = as_retain(gainAction);
-		[gainAction runWithTarget:self];
+		if(nil == gainAction)
+		{
+			gainAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"gain"];
+		}
+		startValue = self.gain;
 	}
+	// Started outside of our lock, like ALSource's ramps.
+	[gainAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
 }
 
 - (void) stopFade
@@ -833,9 +832,7 @@
 	// Must always be synchronized
 	@synchronized(self)
 	{
-		[gainAction stopAction];
-		as_release(gainAction);
-		gainAction = nil;
+		[gainAction cancel];
 	}
 }
 
@@ -844,17 +841,17 @@
 		target:(id) target
 	  selector:(SEL) selector
 {
+    float startValue;
     // Must always be synchronized
     @synchronized(self)
     {
-        [self stopPan];
-        panAction = [OALSequentialActions actions:
-                     [OALPropertyAction panActionWithDuration:duration endValue:value],
-                     [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                     nil];
-        panAction = as_retain(panAction);
-        [panAction runWithTarget:self];
+        if(nil == panAction)
+        {
+            panAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"pan"];
+        }
+        startValue = self.pan;
     }
+    [panAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
 }
 
 - (void) stopPan
@@ -862,9 +859,7 @@
     // Must always be synchronized
     @synchronized(self)
     {
-        [panAction stopAction];
-        as_release(panAction);
-        panAction = nil;
+        [panAction cancel];
     }
 }
 
@@ -248,6 +248,17 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
                                           monoSources:(int) monoSources
                                         stereoSources:(int) stereoSources;
 
+/** Start OALSimpleAudio on a device you opened yourself, such as a loopback
+ * device for running without audio hardware (see ALDevice.initLoopbackWithFrequency:channels:sampleType:). <br>
+ * <strong>Note:</strong> This method must be called ONLY ONCE, <em>BEFORE</em>
+ * any attempt is made to access the shared instance.
+ *
+ * @param device The device to play on.
+ * @param sources the number of sources OALSimpleAudio will reserve for itself.
+ * @return The shared instance.
+ */
++ (OALSimpleAudio*) sharedInstanceWithDevice:(ALDevice*) device sources:(int) sources;
+
 /** \cond */
 /** (INTERNAL USE) Initialize with the specified number of reserved sources.
  *
@@ -266,6 +277,14 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
 - (id) initWithReservedSources:(int) reservedSources
                    monoSources:(int) monoSources
                  stereoSources:(int) stereoSources;
+
+/** (INTERNAL USE) Initialize on the specified device.
+ *
+ * @param device The device to play on (nil = default device).
+ * @param reservedSources the number of sources to reserve when initializing.
+ * @return The shared instance.
+ */
+- (id) initWithDevice:(ALDevice*) device sources:(int) reservedSources;
 /** \endcond */
 
 
@@ -85,6 +85,11 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
                                                   stereoSources:stereoSources]);
 }
 
++ (OALSimpleAudio*) sharedInstanceWithDevice:(ALDevice*) device sources:(int) sources
+{
+	return as_autorelease([[self alloc] initWithDevice:device sources:sources]);
+}
+
 - (id) init
 {
 	return [self initWithSources:kDefaultReservedSources];
@@ -142,11 +147,23 @@ initFailed:
 }
 
 - (id) initWithSources:(int) reservedSources
+{
+	return [self initWithDevice:nil sources:reservedSources];
+}
+
+- (id) initWithDevice:(ALDevice*) deviceIn sources:(int) reservedSources
 {
 	if(nil != (self = [super init]))
 	{
-		OAL_LOG_DEBUG(@"%@: Init with %d reserved sources", self, reservedSources);
-		device = [[ALDevice alloc] initWithDeviceSpecifier:nil];
+		OAL_LOG_DEBUG(@"%@: Init on %@ with %d reserved sources", self, deviceIn, reservedSources);
+		if(nil != deviceIn)
+		{
+			device = as_retain(deviceIn);
+		}
+		else
+		{
+			device = [[ALDevice alloc] initWithDeviceSpecifier:nil];
+		}
         if(device == nil)
 		{
 			OAL_LOG_ERROR(@"%@: Could not create OpenAL device", self);
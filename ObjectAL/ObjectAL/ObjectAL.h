@@ -31,12 +31,15 @@
 #import "OALAction.h"
 #import "OALAudioActions.h"
 #import "OALUtilityActions.h"
+#import "OALEnvelope.h"
 #import "OALActionManager.h"
+#import "OALClock.h"
 
 // AudioTrack
 #import "OALAudioTrack.h"
 #import "OALAudioTracks.h"
 #import "OALAudioTrackNotifications.h"
+#import "OALAudioStream.h"
 
 // OpenAL
 #import "ALTypes.h"
@@ -45,12 +48,17 @@
 #import "ALContext.h"
 #import "ALDevice.h"
 #import "ALListener.h"
+#import "ALMixBus.h"
+#import "ALEffects.h"
 #import "ALSource.h"
 //#import "ALWrapper.h"
 #import "ALChannelSource.h"
 #import "ALSoundSourcePool.h"
 #import "OpenALManager.h"
+#import "OALAudioControlThread.h"
 #import "OALAudioFile.h"
+#import "OALSoftwareMixer.h"
+#import "OALCrossfade.h"
 
 // Other
 //#import "OALNotifications.h"
@@ -109,6 +109,40 @@
 #endif
 
 
+/** Selects how the OpenAL layer (ALSource, ALListener, ALContext, ALSoundSourcePool
+ * and ALChannelSource) protects itself from concurrent access:
+ *
+ * OBJECTAL_LOCK_POLICY_NONE:         No locking at all. This is single threaded mode:
+ *                                    every ObjectAL call must come from the same thread
+ *                                    (for example by routing them all through
+ *                                    OALAudioControlThread).
+ * OBJECTAL_LOCK_POLICY_SYNCHRONIZED: Use @synchronized, as older versions of ObjectAL did.
+ * OBJECTAL_LOCK_POLICY_LIGHTWEIGHT:  Use a small recursive lock embedded in each object
+ *                                    (os_unfair_lock or a futex based mutex). This avoids
+ *                                    the global table lookup that @synchronized does on
+ *                                    every call.
+ *
+ * Simple flags such as ALSource.interruptible are accessed atomically under all policies.
+ * Other parts of ObjectAL continue to use OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS. <br>
+ *
+ * Default: OBJECTAL_LOCK_POLICY_LIGHTWEIGHT, or OBJECTAL_LOCK_POLICY_NONE if
+ * OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS is 0.
+ *
+ * Recommended setting: OBJECTAL_LOCK_POLICY_LIGHTWEIGHT
+ */
+#define OBJECTAL_LOCK_POLICY_NONE         0
+#define OBJECTAL_LOCK_POLICY_SYNCHRONIZED 1
+#define OBJECTAL_LOCK_POLICY_LIGHTWEIGHT  2
+
+#ifndef OBJECTAL_CFG_LOCK_POLICY
+#if OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS
+#define OBJECTAL_CFG_LOCK_POLICY OBJECTAL_LOCK_POLICY_LIGHTWEIGHT
+#else
+#define OBJECTAL_CFG_LOCK_POLICY OBJECTAL_LOCK_POLICY_NONE
+#endif
+#endif
+
+
 /** When this option is other than LEVEL_NONE, ObjectAL will output log entries that correspond
  * to the LEVEL:
  *
@@ -50,6 +50,15 @@
 	void* bufferData;
 	bool freeDataOnDestroy;
 	ALBuffer* parentBuffer;
+	ALint loopStart;
+	ALint loopEnd;
+	bool nativeLoopPoints;
+	/** Slices at the loop points, shared by every source that loops this buffer. */
+	ALBuffer* introSlice;
+	ALBuffer* loopSlice;
+	/** The loop points introSlice and loopSlice were cut at. */
+	ALint sliceLoopStart;
+	ALint sliceLoopEnd;
 }
 
 
@@ -90,6 +99,26 @@
 /** The parent buffer (which owns the uncompressed data) */
 @property(nonatomic,readwrite,retain) ALBuffer* parentBuffer;
 
+/** The number of sample frames in this buffer. */
+@property(nonatomic,readonly,assign) ALint frames;
+
+/** The frame where looping restarts (see setLoopStart:end:). Default: 0 */
+@property(nonatomic,readonly,assign) ALint loopStart;
+
+/** The frame just past the end of the looped part (see setLoopStart:end:).
+ * Default: frames
+ */
+@property(nonatomic,readonly,assign) ALint loopEnd;
+
+/** If true, the loop points cover less than the whole buffer. */
+@property(nonatomic,readonly,assign) bool hasLoopPoints;
+
+/** If true, OpenAL handles the loop points itself (AL_SOFT_loop_points).
+ * Otherwise, a looping ALSource plays the part before loopStart once, then
+ * loops between loopStart and loopEnd by queueing slices of this buffer.
+ */
+@property(nonatomic,readonly,assign) bool nativeLoopPoints;
+
 #pragma mark Object Management
 
 /** Make a new buffer.
@@ -134,5 +163,34 @@
  */
 - (ALBuffer*)sliceWithName:(NSString *) sliceName offset:(ALsizei) offset size:(ALsizei) size;
 
+/** Set the part of the buffer that a looping source repeats. The part before
+ * start plays once, like an intro, and anything from end on is never played
+ * while looping.
+ *
+ * Note: OpenAL won't change loop points on a buffer that is attached to a
+ * source, so set them before giving the buffer to a source.
+ *
+ * @param start The frame where looping restarts.
+ * @param end The frame just past the end of the looped part, or -1 for the
+ *            end of the buffer.
+ * @return TRUE if the loop points were set.
+ */
+- (bool) setLoopStart:(ALint) start end:(ALint) end;
+
+
+#pragma mark Internal Use
+
+/** \cond */
+/** (INTERNAL USE) The part of this buffer before loopStart, for sources that
+ * loop it without native loop points. Made on first use and kept until the
+ * loop points change. nil if loopStart is 0 or the buffer couldn't be sliced.
+ */
+@property(nonatomic,readonly,retain) ALBuffer* introSlice;
+
+/** (INTERNAL USE) The part of this buffer from loopStart to loopEnd, cached
+ * like introSlice. nil if the buffer couldn't be sliced.
+ */
+@property(nonatomic,readonly,retain) ALBuffer* loopSlice;
+/** \endcond */
 
 @end
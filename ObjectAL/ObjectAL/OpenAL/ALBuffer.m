@@ -73,6 +73,8 @@
 		format = formatIn;
 		freeDataOnDestroy = YES;
 		parentBuffer = nil;
+		loopStart = 0;
+		loopEnd = -1;
 
 		if(![ALWrapper bufferDataStatic:bufferId format:format data:bufferData size:size frequency:frequency])
         {
@@ -96,6 +98,8 @@ initFailed:
 	as_release(device);
 	as_release(name);
 	as_release(parentBuffer);
+	as_release(introSlice);
+	as_release(loopSlice);
 	if(freeDataOnDestroy)
 	{
 		free(bufferData);
@@ -146,6 +150,26 @@ initFailed:
 
 @synthesize parentBuffer;
 
+- (ALint) frames
+{
+	ALint frameSize = self.channels * self.bits / 8;
+	return frameSize > 0 ? self.size / frameSize : 0;
+}
+
+@synthesize loopStart;
+
+- (ALint) loopEnd
+{
+	return loopEnd < 0 ? self.frames : loopEnd;
+}
+
+- (bool) hasLoopPoints
+{
+	return loopStart > 0 || (loopEnd >= 0 && loopEnd < self.frames);
+}
+
+@synthesize nativeLoopPoints;
+
 #pragma mark Buffer slicing
 
 - (ALBuffer*)sliceWithName:(NSString *) sliceName offset:(ALsizei) offset size:(ALsizei) size
@@ -179,4 +203,86 @@ initFailed:
 	return slice;
 }
 
+#pragma mark Loop points
+
+- (bool) setLoopStart:(ALint) start end:(ALint) end
+{
+	ALint frames = self.frames;
+	if(end < 0)
+	{
+		end = frames;
+	}
+	if(start < 0 || end > frames || start >= end)
+	{
+		OAL_LOG_ERROR(@"%@: Invalid loop points %d - %d (buffer has %d frames)", self, start, end, frames);
+		return NO;
+	}
+
+	nativeLoopPoints = [ALWrapper isExtensionPresent:@"AL_SOFT_loop_points"];
+	if(nativeLoopPoints)
+	{
+		ALint values[2] = {start, end};
+		if(![ALWrapper bufferiv:bufferId parameter:AL_LOOP_POINTS_SOFT values:values])
+		{
+			OAL_LOG_ERROR(@"%@: Could not set loop points %d - %d. Is the buffer attached to a source?", self, start, end);
+			nativeLoopPoints = NO;
+			return NO;
+		}
+	}
+
+	loopStart = start;
+	loopEnd = end == frames ? -1 : end;
+	return YES;
+}
+
+#pragma mark Internal Use
+
+/** (INTERNAL USE) Cut introSlice and loopSlice at the current loop points,
+ * unless they already are.
+ */
+- (void) updateLoopSlices
+{
+	ALint start = self.loopStart;
+	ALint end = self.loopEnd;
+	if(nil != loopSlice && start == sliceLoopStart && end == sliceLoopEnd)
+	{
+		return;
+	}
+
+	as_release(introSlice);
+	introSlice = nil;
+	as_release(loopSlice);
+	loopSlice = nil;
+
+	// This buffer holds on to its slices, so they mustn't hold on to it.
+	// Any source playing a slice also holds this buffer.
+	loopSlice = as_retain([self sliceWithName:name offset:start size:end - start]);
+	loopSlice.parentBuffer = nil;
+	if(start > 0)
+	{
+		introSlice = as_retain([self sliceWithName:name offset:0 size:start]);
+		introSlice.parentBuffer = nil;
+	}
+	sliceLoopStart = start;
+	sliceLoopEnd = end;
+}
+
+- (ALBuffer*) introSlice
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[self updateLoopSlices];
+		return as_autorelease(as_retain(introSlice));
+	}
+}
+
+- (ALBuffer*) loopSlice
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[self updateLoopSlices];
+		return as_autorelease(as_retain(loopSlice));
+	}
+}
+
 @end
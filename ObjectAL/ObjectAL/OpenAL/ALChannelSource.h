@@ -39,19 +39,24 @@
  * Property values are applied to all sources within the channel. <br>
  * Sounds will get played by any free sources within this channel. <br>
  * If all sources are busy when playback is requested, it will attempt to interrupt a source
- * to free it for playback.
+ * to free it for playback. <br>
+ * Channel gain and pitch apply on top of each source's own, so the gain and pitch
+ * given to play:gain:pitch:pan:loop: are multiplied by the channel's.
  */
 @interface ALChannelSource : NSObject <ALSoundSource>
 {
     /** Pool holding the actual sources */
 	ALSoundSourcePool* sourcePool;
 	ALContext* context;
+
+	/** Mixing bus that all of this channel's sources feed into.
+	 * Channel gain, pitch and mute are applied here rather than on every source.
+	 */
+	ALMixBus* bus;
     
     /** If YES, the defaults of this channel have been initialized */
     bool defaultsInitialized;
 
-	float pitch;
-	float gain;
 	float maxDistance;
 	float rolloffFactor;
 	float referenceDistance;
@@ -113,7 +118,6 @@
     
 
 	bool interruptible;
-	bool muted;
 	bool paused;
 
 	/** Target to inform when the current fade operation completes. */
@@ -122,12 +126,6 @@
 	/** Selector to call when the current fade operation completes. */
 	SEL fadeCompleteSelector;
 	
-	/** The expected number of sources that will callback when fading completes */
-	int expectedFadeCallbackCount;
-
-	/** The actual number of sources that have called back */
-	int currentFadeCallbackCount;
-	
 
 	/** Target to inform when the current pan operation completes. */
 	id panCompleteTarget;
@@ -148,12 +146,6 @@
 	
 	/** Selector to call when the current pitch operation completes. */
 	SEL pitchCompleteSelector;
-	
-	/** The expected number of sources that will callback when pitch op completes */
-	int expectedPitchCallbackCount;
-	
-	/** The actual number of sources that have called back */
-	int currentPitchCallbackCount;
 }
 
 
@@ -165,6 +157,11 @@
 /** All sources being used by this channel. Do not modify! */
 @property(nonatomic,readonly,retain) ALSoundSourcePool* sourcePool;
 
+/** The mixing bus this channel's sources feed into. It feeds into the context's
+ * master bus by default; set its parent to place this channel in a category bus.
+ */
+@property(nonatomic,readonly,retain) ALMixBus* bus;
+
 /** The number of sources reserved by this channel. */
 @property(nonatomic,readwrite,assign) int reservedSources;
 
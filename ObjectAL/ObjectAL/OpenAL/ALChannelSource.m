@@ -37,7 +37,7 @@
 #define SYNTHESIZE_DELEGATE_PROPERTY(NAME, CAPSNAME, TYPE) \
 - (TYPE) NAME \
 { \
-	OPTIONALLY_SYNCHRONIZED(sourcePool) \
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock) \
 	{ \
 		return NAME; \
 	} \
@@ -45,7 +45,7 @@
  \
 - (void) set##CAPSNAME:(TYPE) value \
 { \
-	OPTIONALLY_SYNCHRONIZED(sourcePool) \
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock) \
 	{ \
 		NAME = value; \
 		for(id<ALSoundSource> source in sourcePool.sources) \
@@ -68,7 +68,7 @@
 
 /** (INTERNAL USE) Called by the action system when a fade completes.
  */
-- (void) onFadeComplete:(id<ALSoundSource>) source;
+- (void) onFadeComplete:(ALMixBus*) fadedBus;
 
 /** (INTERNAL USE) Called by the action system when a pan completes.
  */
@@ -76,12 +76,20 @@
 
 /** (INTERNAL USE) Called by the action system when a pitch change completes.
  */
-- (void) onPitchComplete:(id<ALSoundSource>) source;
+- (void) onPitchComplete:(ALMixBus*) pitchedBus;
 
 /** (INTERNAL USE) Set defaults from another channel.
  */
 - (void) setDefaultsFromChannel:(ALChannelSource*) channel;
 
+/** (INTERNAL USE) Make a source feed into this channel's bus.
+ */
+- (void) attachSourceToBus:(id<ALSoundSource>) source;
+
+/** (INTERNAL USE) Return a source that left this channel to its context's master bus.
+ */
+- (void) detachSourceFromBus:(id<ALSoundSource>) source;
+
 @end
 /** \endcond */
 
@@ -109,6 +117,7 @@
         }
 
 		sourcePool = [[ALSoundSourcePool alloc] init];
+		bus = [[ALMixBus alloc] initWithParent:context.masterBus];
 
         for(int i = 0; i < reservedSources; i++)
         {
@@ -126,6 +135,8 @@ initFailed:
 {
 	OAL_LOG_DEBUG(@"%@: Dealloc", self);
 	
+	[bus stopActions];
+	as_release(bus);
 	as_release(sourcePool);
 	as_release(context);
 
@@ -157,6 +168,42 @@ initFailed:
 
 @synthesize sourcePool;
 
+@synthesize bus;
+
+- (float) gain
+{
+	return bus.gain;
+}
+
+- (void) setGain:(float) value
+{
+	bus.gain = value;
+}
+
+- (float) pitch
+{
+	return bus.pitch;
+}
+
+- (void) setPitch:(float) value
+{
+	bus.pitch = value;
+}
+
+- (bool) muted
+{
+	return bus.muted;
+}
+
+- (void) setMuted:(bool) value
+{
+	if(value)
+	{
+		[self stopActions];
+	}
+	bus.muted = value;
+}
+
 - (float) volume
 {
 	return self.gain;
@@ -184,7 +231,7 @@ initFailed:
 
 - (bool) playing
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
@@ -205,8 +252,6 @@ SYNTHESIZE_DELEGATE_PROPERTY(coneOuterGain, ConeOuterGain, float);
 
 SYNTHESIZE_DELEGATE_PROPERTY(direction, Direction, ALVector);
 
-SYNTHESIZE_DELEGATE_PROPERTY(gain, Gain, float);
-
 SYNTHESIZE_DELEGATE_PROPERTY(interruptible, Interruptible, bool);
 
 SYNTHESIZE_DELEGATE_PROPERTY(looping, Looping, bool);
@@ -217,12 +262,8 @@ SYNTHESIZE_DELEGATE_PROPERTY(maxGain, MaxGain, float);
 
 SYNTHESIZE_DELEGATE_PROPERTY(minGain, MinGain, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(muted, Muted, bool);
-
 SYNTHESIZE_DELEGATE_PROPERTY(paused, Paused, bool);
 
-SYNTHESIZE_DELEGATE_PROPERTY(pitch, Pitch, float);
-
 SYNTHESIZE_DELEGATE_PROPERTY(position, Position, ALPoint);
 
 SYNTHESIZE_DELEGATE_PROPERTY(referenceDistance, ReferenceDistance, float);
@@ -255,7 +296,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (id<ALSoundSource>) play:(ALBuffer*) buffer loop:(bool) loop
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
 		// Try to find a free source for playback.
 		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
@@ -266,7 +307,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (id<ALSoundSource>) play:(ALBuffer*) buffer gain:(float) gainIn pitch:(float) pitchIn pan:(float) panIn loop:(bool) loop
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
 		// Try to find a free source for playback.
 		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
@@ -275,9 +316,20 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 	}
 }
 
+- (id<ALSoundSource>) play:(ALBuffer*) buffer loop:(bool) loop atSampleTime:(int64_t) sampleTime
+{
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
+	{
+		// Try to find a free source for playback.
+		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
+		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible];
+		return [soundSource play:buffer loop:loop atSampleTime:sampleTime];
+	}
+}
+
 - (void) stop
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         [sourcePool.sources makeObjectsPerformSelector:@selector(stop)];
 	}
@@ -285,7 +337,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) rewind
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         [sourcePool.sources makeObjectsPerformSelector:@selector(rewind)];
 	}
@@ -294,51 +346,43 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 - (void) fadeTo:(float) value duration:(float) duration target:(id) target selector:(SEL) selector
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
 		[self stopFade];
 		fadeCompleteTarget = target;
 		fadeCompleteSelector = selector;
 
-		currentFadeCallbackCount = 0;
-		expectedFadeCallbackCount = (int)[sourcePool.sources count];
-		for(id<ALSoundSource> source in sourcePool.sources)
-		{
-			[source fadeTo:value duration:duration target:self selector:@selector(onFadeComplete:)];
-		}
+		// One ramp on the bus instead of one per source.
+		[bus fadeTo:value duration:duration target:self selector:@selector(onFadeComplete:)];
 	}
 }
 
-- (void) onFadeComplete:(id<ALSoundSource>) source
+- (void) onFadeComplete:(ALMixBus*) fadedBus
 {
-    #pragma unused(source)
+    #pragma unused(fadedBus)
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
-		currentFadeCallbackCount++;
-		if(currentFadeCallbackCount == expectedFadeCallbackCount)
-		{
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-			[fadeCompleteTarget performSelector:fadeCompleteSelector withObject:self];
+		[fadeCompleteTarget performSelector:fadeCompleteSelector withObject:self];
 #pragma clang diagnostic pop
-		}
 	}
 }
 
 - (void) stopFade
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
-		[sourcePool.sources makeObjectsPerformSelector:@selector(stopFade)];
+		[bus stopFade];
 	}
 }
 
 - (void) panTo:(float) value duration:(float) duration target:(id) target selector:(SEL) selector
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
 		[self stopPan];
 		panCompleteTarget = target;
@@ -357,7 +401,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 {
     #pragma unused(source)
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
 		currentPanCallbackCount++;
 		if(currentPanCallbackCount == expectedPanCallbackCount)
@@ -373,7 +417,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 - (void) stopPan
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
 		[sourcePool.sources makeObjectsPerformSelector:@selector(stopPan)];
 	}
@@ -382,52 +426,45 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 - (void) pitchTo:(float) value duration:(float) duration target:(id) target selector:(SEL) selector
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
 		[self stopPitch];
 		pitchCompleteTarget = target;
 		pitchCompleteSelector = selector;
-		
-		currentPitchCallbackCount = 0;
-		expectedPitchCallbackCount = (int)[sourcePool.sources count];
-		for(id<ALSoundSource> source in sourcePool.sources)
-		{
-			[source pitchTo:value duration:duration target:self selector:@selector(onPitchComplete:)];
-		}
+
+		// One ramp on the bus instead of one per source.
+		[bus pitchTo:value duration:duration target:self selector:@selector(onPitchComplete:)];
 	}
 }
 
-- (void) onPitchComplete:(id<ALSoundSource>) source
+- (void) onPitchComplete:(ALMixBus*) pitchedBus
 {
-    #pragma unused(source)
+    #pragma unused(pitchedBus)
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
-		currentPitchCallbackCount++;
-		if(currentPitchCallbackCount == expectedPitchCallbackCount)
-		{
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-			[pitchCompleteTarget performSelector:pitchCompleteSelector withObject:self];
+		[pitchCompleteTarget performSelector:pitchCompleteSelector withObject:self];
 #pragma clang diagnostic pop
-		}
 	}
 }
 
 - (void) stopPitch
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
-		[sourcePool.sources makeObjectsPerformSelector:@selector(stopPitch)];
+		[bus stopPitch];
 	}
 }
 
 - (void) stopActions
 {
 	// Must always be synchronized
-	@synchronized(sourcePool)
+	ALWAYS_LOCKED(sourcePool, sourcePool.lock)
 	{
+		[bus stopActions];
 		[sourcePool.sources makeObjectsPerformSelector:@selector(stopActions)];
 	}
 }
@@ -435,7 +472,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) clear
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         [sourcePool.sources makeObjectsPerformSelector:@selector(clear)];
 	}
@@ -443,7 +480,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) setDefaultsFromSource:(id<ALSoundSource>) source
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         defaultPitch = source.pitch;
         defaultGain = source.gain;
@@ -468,7 +505,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) setDefaultsFromChannel:(ALChannelSource*) channel
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         defaultPitch = channel->defaultPitch;
         defaultGain = channel->defaultGain;
@@ -495,10 +532,16 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) resetToDefault
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
-        self.pitch = defaultPitch;
-        self.gain = defaultGain;
+        // Channel level gain and pitch live on the bus; the sources get their own defaults back.
+        bus.pitch = 1.0f;
+        bus.gain = 1.0f;
+        for(id<ALSoundSource> source in sourcePool.sources)
+        {
+            source.pitch = defaultPitch;
+            source.gain = defaultGain;
+        }
         self.maxDistance = defaultMaxDistance;
         self.rolloffFactor = defaultRolloffFactor;
         self.referenceDistance = defaultReferenceDistance;
@@ -521,7 +564,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) addSource:(id<ALSoundSource>) source
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         if(nil == source)
         {
@@ -534,8 +577,8 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
         }
         if(defaultsInitialized)
         {
-            source.pitch = pitch;
-            source.gain = gain;
+            source.pitch = defaultPitch;
+            source.gain = defaultGain;
             source.maxDistance = maxDistance;
             source.rolloffFactor = rolloffFactor;
             source.referenceDistance = referenceDistance;
@@ -556,13 +599,14 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
             [self setDefaultsFromSource:source];
             [self resetToDefault];
         }
+        [self attachSourceToBus:source];
         [sourcePool addSource:source];
     }
 }
 
 - (id<ALSoundSource>) removeSource:(id<ALSoundSource>) source
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         if(nil == source)
         {
@@ -574,16 +618,42 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
         }
         as_autorelease_noref(as_retain(source));
         [sourcePool removeSource:source];
+        [self detachSourceFromBus:source];
     }
     
     return source;
 }
 
+- (void) attachSourceToBus:(id<ALSoundSource>) source
+{
+    if([source isKindOfClass:[ALSource class]])
+    {
+        ((ALSource*)source).bus = bus;
+    }
+    else if([source isKindOfClass:[ALChannelSource class]])
+    {
+        ((ALChannelSource*)source).bus.parent = bus;
+    }
+}
+
+- (void) detachSourceFromBus:(id<ALSoundSource>) source
+{
+    if([source isKindOfClass:[ALSource class]])
+    {
+        ALSource* alSource = (ALSource*)source;
+        alSource.bus = alSource.context.masterBus;
+    }
+    else if([source isKindOfClass:[ALChannelSource class]])
+    {
+        ((ALChannelSource*)source).bus.parent = context.masterBus;
+    }
+}
+
 - (ALChannelSource*) splitChannelWithSources:(int) numSources
 {
     ALChannelSource* newChannel;
 
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         newChannel = [ALChannelSource channelWithSources:0];
         [newChannel setDefaultsFromChannel:self];
@@ -606,7 +676,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 {
     id<ALSoundSource> source;
     
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         while (nil != (source = [channel removeSource:nil]))
         {
@@ -618,7 +688,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 - (NSArray*) clearUnusedBuffers
 {
     NSMutableArray* removed = [NSMutableArray arrayWithCapacity:[sourcePool.sources count]];
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         for(ALSource* source in sourcePool.sources)
         {
@@ -637,7 +707,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 - (BOOL) removeBuffersNamed:(NSString*) name
 {
     BOOL playing = NO;
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	OPTIONALLY_LOCKED(sourcePool, sourcePool.lock)
 	{
         for(ALSource* source in sourcePool.sources)
         {
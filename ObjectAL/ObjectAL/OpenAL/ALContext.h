@@ -31,12 +31,33 @@
 #import <OpenAL/alc.h>
 #import "ALListener.h"
 #import "ALSource.h"
+#import "ALMixBus.h"
+#import "ALEffects.h"
 #import "OALSuspendHandler.h"
+#import "OALLock.h"
 
 
 @class ALDevice;
 
 
+/** A game-supplied occlusion query (see ALContext.occlusionQuery). <br>
+ * Fill in the occlusion and obstruction between the listener and each source
+ * before returning. The block can split the work over several threads, but it must
+ * not create, destroy or modify sources.
+ *
+ * @param listenerPosition The listener's position.
+ * @param sourcePositions The positions of the sources to check.
+ * @param count The number of sources to check.
+ * @param occlusions Receives each source's occlusion in db (see ALSoundSource.reverbOcclusion).
+ * @param obstructions Receives each source's obstruction in db (see ALSoundSource.reverbObstruction).
+ */
+typedef void (^ALOcclusionQuery)(ALPoint listenerPosition,
+								 const ALPoint* sourcePositions,
+								 NSUInteger count,
+								 float* occlusions,
+								 float* obstructions);
+
+
 #pragma mark ALContext
 
 /**
@@ -61,6 +82,122 @@
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
+
+	/** If true, source parameter changes are held until commitDeferredUpdates. */
+	bool deferUpdates;
+
+	/** Sources with parameter changes waiting for the next commit. */
+	NSMutableArray* dirtySources;
+
+	/** Root of this context's mixing bus tree. */
+	ALMixBus* masterBus;
+
+	/** EFX effects and filters. */
+	ALEffects* effects;
+
+	/** Protects this context's properties (see OBJECTAL_CFG_LOCK_POLICY). */
+	OALLock lock;
+
+	/** Protects the sources list. */
+	OALLock sourcesLock;
+
+	/** Protects the dirty sources list. */
+	OALLock dirtySourcesLock;
+
+	/** Sources waiting for a software scheduled start, keyed by start time
+	 * in device clock nanoseconds (NSNumber* -> NSMutableArray of ALSource*).
+	 */
+	NSMutableDictionary* scheduledStarts;
+
+	/** Sources playing the intro of a buffer with software loop points, which
+	 * still have to switch to looping (ALSource*). Protected by lock.
+	 */
+	NSMutableArray* loopSwitchSources;
+
+	/** Scratch space for bulk updates: Source IDs for positions, then for velocities. */
+	ALuint* bulkSourceIds;
+
+	/** Scratch space for bulk updates: Position x, y, z, then velocity x, y, z. */
+	float* bulkValues;
+
+	/** Scratch space for bulk updates: The sources whose values were sent (ALSource*, not retained). */
+	void** bulkSources;
+
+	/** Scratch space for bulk updates: Each sent source's motionSequence when its values were stored. */
+	uint32_t* bulkSequences;
+
+	/** How many sources the bulk update scratch space can hold. */
+	NSUInteger bulkCapacity;
+
+	/** Protects the bulk update scratch space. */
+	OALLock bulkLock;
+
+	/** If true, updateCulling virtualizes sources that can't be heard. */
+	bool cullingEnabled;
+
+	/** Estimated gain below which a source gets virtualized. */
+	float cullingThreshold;
+
+	/** Sources further than this from the listener are culled without estimating their gain (0 = no limit). */
+	float cullingRadius;
+
+	/** Number of culling passes run, used to schedule full passes. */
+	NSUInteger cullingPassCount;
+
+	/** Index of source positions, for finding the sources near a point without
+	 * looking at all of them. Source-relative sources aren't in it.
+	 */
+	struct OALSpatialGrid* spatialGrid;
+
+	/** Source-relative sources, which move with the listener. */
+	NSMutableArray* relativeSources;
+
+	/** Sources that were within cullingRadius on the last culling pass (their spatialItems). */
+	void** nearbySources;
+
+	/** The number of entries in nearbySources. */
+	size_t nearbySourcesCount;
+
+	/** Scratch space for spatial queries. */
+	void** spatialResults;
+
+	/** How many entries nearbySources and spatialResults can each hold. */
+	size_t spatialCapacity;
+
+	/** Protects the spatial index and everything used with it. */
+	OALLock spatialLock;
+
+	/** Game-supplied occlusion query (see occlusionQuery). */
+	ALOcclusionQuery occlusionQuery;
+
+	/** The most sources to send to the occlusion query per update. */
+	NSUInteger occlusionBudget;
+
+	/** Time constant (in seconds) of the glide toward new occlusion values. */
+	float occlusionSmoothing;
+
+	/** Time (OALClockNow) of the last occlusion update (negative = never). */
+	double occlusionUpdateTime;
+
+	/** Scratch space for occlusion updates: Sources that could be queried, with their scores. */
+	struct ALOcclusionCandidate* occlusionCandidates;
+
+	/** How many entries occlusionCandidates can hold. */
+	size_t occlusionCandidatesCapacity;
+
+	/** The sources in the current occlusion batch (strong references, so that
+	 * they outlive the query).
+	 */
+	NSMutableArray* occlusionBatch;
+
+	/** Scratch space for occlusion updates: Source positions. */
+	ALPoint* occlusionPositions;
+
+	/** Scratch space for occlusion updates: Occlusions, then obstructions. */
+	float* occlusionResults;
+
+	/** Protects occlusion updates and their scratch space. */
+	OALLock occlusionLock;
 }
 
 
@@ -80,6 +217,12 @@
 /** The OpenAL context pointer. */
 @property(nonatomic,readonly,assign) ALCcontext* context;
 
+/** The number of sample frames OpenAL mixes per update (the period), worked out
+ * from the ALC_REFRESH and ALC_FREQUENCY attributes. 0 if the implementation
+ * doesn't report them. See ALDevice.latency for the resulting total latency.
+ */
+@property(nonatomic,readonly,assign) int periodFrames;
+
 /** The device this context was opened on. */
 @property(nonatomic,readonly,retain) ALDevice* device;
 
@@ -96,6 +239,11 @@
  */
 @property(nonatomic,readwrite,assign) float dopplerFactor;
 
+/** This context's EFX effect slots, filters and reverb.
+ * Only valid when this is the current context.
+ */
+@property(nonatomic,readonly,retain) ALEffects* effects;
+
 /** List of available extensions (NSString*).
  * Only valid when this is the current context.
  */
@@ -104,6 +252,11 @@
 /** This context's listener. */
 @property(nonatomic,readonly,retain) ALListener* listener;
 
+/** The root of this context's mixing bus tree. Create category and channel
+ * buses under it with [ALMixBus busWithParent:]. ALChannelSource does this automatically.
+ */
+@property(nonatomic,readonly,retain) ALMixBus* masterBus;
+
 /** Information about the specific renderer.
  * Only valid when this is the current context.
  */
@@ -122,6 +275,65 @@
  */
 @property(nonatomic,readonly,retain) NSString* vendor;
 
+/** If true, changes to source parameters (gain, pitch, position, velocity etc)
+ * are not sent to OpenAL right away. Instead, they are held until
+ * commitDeferredUpdates is called, and then applied all at once. <br>
+ * Setting this to false commits any pending changes. <br>
+ * Default value: NO
+ */
+@property(nonatomic,readwrite,assign) bool deferUpdates;
+
+/** If true, updateCulling takes sources that are too quiet to hear out of the mixer,
+ * so that mixing cost follows the number of audible sounds rather than the number of
+ * playing ones. Culled sources keep counting as playing, and go back into the mixer
+ * at the right offset once they're loud enough (see ALSource.virtualized). <br>
+ * Sources playing queued buffers are never culled. <br>
+ * Default value: NO
+ */
+@property(nonatomic,readwrite,assign) bool cullingEnabled;
+
+/** The estimated gain at the listener (after distance attenuation, cone, bus and
+ * listener gain) below which a source is culled. A culled source comes back once
+ * it gets a little louder than this, so that it doesn't flap on the boundary. <br>
+ * Default value: 0.001 (-60 dB)
+ */
+@property(nonatomic,readwrite,assign) float cullingThreshold;
+
+/** If nonzero, updateCulling only estimates the gain of sources within this distance
+ * of the listener, found through a spatial index, and culls everything further away.
+ * This keeps the culling pass cheap with thousands of placed sources. <br>
+ * Sources that start playing outside the radius are caught by a full pass every
+ * few ticks. Source-relative sources are always checked. <br>
+ * Setting this also sets the size of the index's cells, so pick a value close to
+ * the distance at which your sounds become inaudible. <br>
+ * Default value: 0
+ */
+@property(nonatomic,readwrite,assign) float cullingRadius;
+
+/** If set, updateOcclusion calls this with a batch of playing sources, and sets their
+ * reverbOcclusion and reverbObstruction from the results, gliding toward them over
+ * occlusionSmoothing. This lets the game do its raycasts for many sources at once,
+ * on its own job system, instead of setting each source by hand. <br>
+ * Sources are picked by how long it's been since they were last checked, scaled by
+ * their occlusionPriority and divided by their distance to the listener, so distant
+ * sounds are checked less often. Source-relative sources are never checked. <br>
+ * While this is set, the query results overwrite values set by hand. <br>
+ * Default value: nil
+ */
+@property(nonatomic,readwrite,copy) ALOcclusionQuery occlusionQuery;
+
+/** The most sources updateOcclusion sends to occlusionQuery at once. This bounds the
+ * cost of occlusion per frame, however many sources are playing. <br>
+ * Default value: 32
+ */
+@property(nonatomic,readwrite,assign) NSUInteger occlusionBudget;
+
+/** How long (in seconds) a source takes to get most of the way (63%) to a new
+ * occlusion value, so that doors and walls fade in rather than pop. 0 = no smoothing. <br>
+ * Default value: 0.1
+ */
+@property(nonatomic,readwrite,assign) float occlusionSmoothing;
+
 
 #pragma mark Object Management
 
@@ -129,7 +341,8 @@
  *
  * @param device The device to open the context on.
  * @param attributes An array of NSNumber in ordered pairs (attribute id followed by integer value).
- * Posible attributes: ALC_FREQUENCY, ALC_REFRESH, ALC_SYNC, ALC_MONO_SOURCES, ALC_STEREO_SOURCES
+ * Posible attributes: ALC_FREQUENCY, ALC_REFRESH, ALC_SYNC, ALC_MONO_SOURCES, ALC_STEREO_SOURCES,
+ * and ALC_HRTF_SOFT and ALC_HRTF_ID_SOFT with OpenAL Soft (see ALDevice.hrtfAttributesWithMode:specifier:).
  * @return A new context.
  */
 + (id) contextOnDevice:(ALDevice *) device attributes:(NSArray*) attributes;
@@ -174,11 +387,47 @@
 	  stereoSources:(int) stereoSources;
 
 
+/** Create a new context on the specified device, asking for a particular latency. <br><br>
+ *
+ * Smaller sizes give lower latency, but raise the risk of underruns (clicks and dropouts)
+ * when the mixer can't keep up. Implementations treat them as hints, so check
+ * periodFrames and ALDevice.latency to see what was actually used. <br>
+ * OpenAL Soft takes the period size from ALC_REFRESH, and its number of periods from
+ * its own configuration; when only bufferFrames is given, the period is set to a third
+ * of it (OpenAL Soft's default is 3 periods). iOS ignores ALC_REFRESH and mixes straight
+ * into the audio session's I/O buffer, so bufferFrames sets its preferred I/O buffer duration.
+ *
+ * @param device The device to open the context on.
+ * @param periodFrames The number of sample frames to mix per update (0 = default).
+ * @param bufferFrames The total number of sample frames buffered for output (0 = default).
+ * @param attributes Any other attributes (see contextOnDevice:attributes:).
+ * @return A new context.
+ */
++ (id) contextOnDevice:(ALDevice*) device
+		  periodFrames:(int) periodFrames
+		  bufferFrames:(int) bufferFrames
+			attributes:(NSArray*) attributes;
+
+/** Initialize this context on the specified device, asking for a particular latency
+ * (see contextOnDevice:periodFrames:bufferFrames:attributes:).
+ *
+ * @param device The device to open the context on.
+ * @param periodFrames The number of sample frames to mix per update (0 = default).
+ * @param bufferFrames The total number of sample frames buffered for output (0 = default).
+ * @param attributes Any other attributes (see contextOnDevice:attributes:).
+ * @return The initialized context.
+ */
+- (id) initOnDevice:(ALDevice*) device
+	   periodFrames:(int) periodFrames
+	   bufferFrames:(int) bufferFrames
+		 attributes:(NSArray*) attributes;
+
 /** Initialize this context for the specified device and attributes.
  *
  * @param device The device to open the context on.
  * @param attributes An array of NSNumber in ordered pairs (attribute id followed by integer value).
- * Posible attributes: ALC_FREQUENCY, ALC_REFRESH, ALC_SYNC, ALC_MONO_SOURCES, ALC_STEREO_SOURCES
+ * Posible attributes: ALC_FREQUENCY, ALC_REFRESH, ALC_SYNC, ALC_MONO_SOURCES, ALC_STEREO_SOURCES,
+ * and ALC_HRTF_SOFT and ALC_HRTF_ID_SOFT with OpenAL Soft (see ALDevice.hrtfAttributesWithMode:specifier:).
  * @return The initialized context.
  */
 - (id) initOnDevice:(ALDevice *) device attributes:(NSArray*) attributes;
@@ -204,6 +453,104 @@
  */
 - (void) ensureContextIsCurrent;
 
+/** Send all pending source parameter changes to OpenAL in one batch.
+ * The changes are applied atomically where the implementation supports it.
+ * Call this once per frame/tick when deferUpdates is enabled. <br>
+ * While the context is suspended, nothing is sent. The changes are kept, and
+ * committed when the context resumes.
+ */
+- (void) commitDeferredUpdates;
+
+/** Estimate how loud each source is at the listener, and cull or restore it.
+ * Does nothing unless cullingEnabled is set. Call this once per frame/tick
+ * (OALAudioControlThread does this automatically).
+ */
+- (void) updateCulling;
+
+/** Run the occlusion query on the sources that need it most, and glide all sources
+ * toward their latest results. Does nothing unless occlusionQuery is set.
+ * Call this once per frame/tick (OALAudioControlThread does this automatically).
+ */
+- (void) updateOcclusion;
+
+/** Switch sources that have played the intro of a buffer with loop points over
+ * to looping, where OpenAL can't loop part of a buffer by itself (see
+ * ALBuffer.setLoopStart:end:). A timer does this too, so calling it is optional,
+ * but it keeps offline renders in step. Call this once per frame/tick
+ * (OALAudioControlThread and ALDevice.renderToWAVFile:duration: do this automatically).
+ */
+- (void) updateLoopPoints;
+
+/** Start a group of sources together, at an exact sample on the device clock.
+ * All sources start on the same sample, even if the start time has already passed. <br>
+ * Uses the OpenAL implementation's start delay support (AL_SOFT_source_start_delay)
+ * if available. Otherwise the sources are started by a timer and, if the timer fires late,
+ * offset by the lateness so that they still line up with the device clock. On a loopback
+ * device, they are started by the render itself, on their exact sample.
+ *
+ * @param sources The sources to start (ALSource*).
+ * @param sampleTime The time to start at, in sample frames on ALDevice.sampleClock.
+ * @return TRUE if the sources were scheduled.
+ */
+- (bool) playSources:(NSArray*) sources atSampleTime:(int64_t) sampleTime;
+
+
+#pragma mark Spatial Queries
+
+/** Find the sources within a distance of a point, using the spatial index.
+ * Source-relative sources aren't included.
+ *
+ * @param radius The distance.
+ * @param point The point to search around.
+ * @return The sources found (ALSource*), in no particular order.
+ */
+- (NSArray*) sourcesWithinRadius:(float) radius ofPoint:(ALPoint) point;
+
+/** Find the sources closest to a point, using the spatial index.
+ * Source-relative sources aren't included.
+ *
+ * @param count The maximum number of sources to return.
+ * @param point The point to search around.
+ * @return Up to count sources (ALSource*), closest first.
+ */
+- (NSArray*) nearestSources:(NSUInteger) count toPoint:(ALPoint) point;
+
+/** Find the sources that sound loudest at the listener, by the same estimate
+ * that the culling pass uses. Only sources within the radius are scored,
+ * plus all source-relative sources. Use this to decide which sounds get real
+ * voices when there are more sounds than the hardware can mix.
+ *
+ * @param count The maximum number of sources to return.
+ * @param radius Only consider sources within this distance of the listener.
+ * @return Up to count sources (ALSource*), loudest first.
+ */
+- (NSArray*) loudestSources:(NSUInteger) count withinRadius:(float) radius;
+
+
+#pragma mark Bulk Updates
+
+/** Set the positions and velocities of many sources in one pass. <br>
+ * Only values that changed are sent to OpenAL. They are all sent at once,
+ * inside a single deferred update, rather than one call per source.
+ * Use this to update every emitter in a scene once per frame. <br>
+ * The coordinate arrays are indexed the same as the sources array.
+ *
+ * @param sources The sources to update (ALSource*).
+ * @param positionX The sources' X positions (NULL = don't change positions).
+ * @param positionY The sources' Y positions.
+ * @param positionZ The sources' Z positions.
+ * @param velocityX The sources' X velocities (NULL = don't change velocities).
+ * @param velocityY The sources' Y velocities.
+ * @param velocityZ The sources' Z velocities.
+ */
+- (void) updateSources:(NSArray*) sources
+			 positionX:(const float*) positionX
+			 positionY:(const float*) positionY
+			 positionZ:(const float*) positionZ
+			 velocityX:(const float*) velocityX
+			 velocityY:(const float*) velocityY
+			 velocityZ:(const float*) velocityZ;
+
 #pragma mark Extensions
 
 /** Check if the specified extension is present in this context.
@@ -240,6 +587,47 @@
  * @param source the source that is deallocating.
  */
 - (void) notifySourceDeallocating:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALSource to announce that it has parameter
+ * changes waiting for the next commit.
+ *
+ * @param source the source that has pending changes.
+ */
+- (void) notifySourceDirty:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALSource to announce that its position or
+ * source-relative setting has changed. Must not be called while holding
+ * the source's lock.
+ *
+ * @param source the source that moved.
+ */
+- (void) notifySourceMoved:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALSource to announce that it is playing an intro
+ * slice, and needs updateLoopPoints to switch it to looping.
+ *
+ * @param source the source that is waiting to loop.
+ */
+- (void) notifySourceLoopPending:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALDevice to announce that it has been reset
+ * with new attributes.
+ */
+- (void) notifyDeviceReset;
+
+/** (INTERNAL USE) Used by loopback devices, which start software scheduled
+ * sources as they render rather than from a timer.
+ *
+ * @return The sample time of the earliest scheduled start, or INT64_MAX if there are none.
+ */
+- (int64_t) nextScheduledSampleTime;
+
+/** (INTERNAL USE) Used by loopback devices to start every group of software
+ * scheduled sources that is due.
+ *
+ * @param sampleTime The device's current sample time.
+ */
+- (void) startScheduledSourcesAtSampleTime:(int64_t) sampleTime;
 /** \endcond */
 
 @end
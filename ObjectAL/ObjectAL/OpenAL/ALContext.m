@@ -34,6 +34,59 @@
 #import "ALWrapper.h"
 #import "OpenALManager.h"
 #import "ALDevice.h"
+#import "OALSpatialGrid.h"
+#import "OALClock.h"
+#if defined(__IPHONE_OS_VERSION_MAX_ALLOWED) && !defined(__TV_OS_VERSION_MIN_REQUIRED)
+#import <AVFoundation/AVFoundation.h>
+#endif
+
+
+/** A culled source is restored once its estimated gain reaches cullingThreshold times this. */
+#define kALCullingHysteresis 1.5f
+
+/** With a culling radius, every this many culling passes look at all sources,
+ * to catch sources that started playing outside the radius.
+ */
+#define kALCullingFullPassInterval 16
+
+/** Cell size of the spatial index while cullingRadius is 0. */
+#define kALDefaultSpatialCellSize 50.0f
+
+/** The number of periods OpenAL Soft buffers unless configured otherwise. */
+#define kALDefaultPeriods 3
+
+
+/** Find an attribute's value in a list of attribute id/value pairs (NSNumber*).
+ *
+ * @param attributes The attribute list.
+ * @param attribute The attribute to look for.
+ * @param defaultValue What to return if it isn't there.
+ * @return The attribute's value, or defaultValue.
+ */
+static int attributeValue(NSArray* attributes, int attribute, int defaultValue)
+{
+	NSUInteger count = [attributes count];
+	for(NSUInteger i = 0; i + 1 < count; i += 2)
+	{
+		if([[attributes objectAtIndex:i] intValue] == attribute)
+		{
+			return [[attributes objectAtIndex:i + 1] intValue];
+		}
+	}
+	return defaultValue;
+}
+
+
+/** A source that could go into the next occlusion batch. */
+struct ALOcclusionCandidate
+{
+	/** The source (ALSource*). */
+	void* source;
+	/** How badly it needs checking (see ALSource occlusionScoreAtListenerPosition:). */
+	float score;
+	/** Its position. */
+	ALPoint position;
+};
 
 
 #pragma mark -
@@ -49,6 +102,39 @@
  */
 - (void) setSuspended:(bool) value;
 
+/** (INTERNAL USE) Start the sources that were scheduled in software for a particular time.
+ *
+ * @param key The start time, in device clock nanoseconds.
+ */
+- (void) startScheduledSources:(NSNumber*) key;
+
+/** (INTERNAL USE) Read this context's attributes from OpenAL into the attributes array.
+ */
+- (void) cacheAttributes;
+
+/** (INTERNAL USE) Add, move or remove a source in the spatial index according
+ * to its position and source-relative setting. Call only with spatialLock held.
+ *
+ * @param source The source to index.
+ */
+- (void) indexSource:(ALSource*) source;
+
+/** (INTERNAL USE) Make sure nearbySources and spatialResults can each hold
+ * at least this many entries. Call only with spatialLock held.
+ *
+ * @param count The number of entries needed.
+ */
+- (void) reserveSpatialCapacity:(size_t) count;
+
+/** (INTERNAL USE) Find the indexed sources within a radius of a point, and put
+ * them in spatialResults. Call only with spatialLock held.
+ *
+ * @param point The point to search around.
+ * @param radius The radius to search.
+ * @return The number of sources found.
+ */
+- (size_t) querySpatialIndexAround:(ALPoint) point radius:(float) radius;
+
 @end
 /** \endcond */
 
@@ -62,6 +148,8 @@
 @synthesize device;
 @synthesize sources;
 @synthesize listener;
+@synthesize masterBus;
+@synthesize effects;
 @synthesize context;
 @synthesize attributes;
 
@@ -107,6 +195,17 @@
 	return [self contextOnDevice:device attributes:attributes];
 }
 
++ (id) contextOnDevice:(ALDevice*) device
+		  periodFrames:(int) periodFrames
+		  bufferFrames:(int) bufferFrames
+			attributes:(NSArray*) attributes
+{
+	return as_autorelease([[self alloc] initOnDevice:device
+										periodFrames:periodFrames
+										bufferFrames:bufferFrames
+										  attributes:attributes]);
+}
+
 - (id) initOnDevice:(ALDevice*) deviceIn
 	outputFrequency:(int) outputFrequency
    refreshIntervals:(int) refreshIntervals 
@@ -139,7 +238,50 @@
 		[attributesList addObject:[NSNumber numberWithInt:stereoSources]];
 	}
 	
-	return [self initOnDevice:deviceIn attributes:attributes];
+	return [self initOnDevice:deviceIn attributes:attributesList];
+}
+
+- (id) initOnDevice:(ALDevice*) deviceIn
+	   periodFrames:(int) periodFrames
+	   bufferFrames:(int) bufferFrames
+		 attributes:(NSArray*) attributesIn
+{
+	int frequency = attributeValue(attributesIn, ALC_FREQUENCY, deviceIn.frequency);
+
+	if(bufferFrames > 0 && frequency > 0)
+	{
+#if defined(__IPHONE_OS_VERSION_MAX_ALLOWED) && !defined(__TV_OS_VERSION_MIN_REQUIRED)
+		NSError* error = nil;
+		if(![[AVAudioSession sharedInstance] setPreferredIOBufferDuration:(NSTimeInterval)bufferFrames / frequency
+																	error:&error])
+		{
+			OAL_LOG_WARNING(@"%@: Could not set the I/O buffer to %d frames: %@", self, bufferFrames, error);
+		}
+#else
+		if(periodFrames <= 0)
+		{
+			periodFrames = bufferFrames / kALDefaultPeriods;
+		}
+#endif
+	}
+
+	NSMutableArray* attributesList = [NSMutableArray arrayWithCapacity:[attributesIn count] + 2];
+	for(NSUInteger i = 0; i + 1 < [attributesIn count]; i += 2)
+	{
+		if(periodFrames <= 0 || ALC_REFRESH != [[attributesIn objectAtIndex:i] intValue])
+		{
+			[attributesList addObject:[attributesIn objectAtIndex:i]];
+			[attributesList addObject:[attributesIn objectAtIndex:i + 1]];
+		}
+	}
+	if(periodFrames > 0)
+	{
+		// OpenAL asks for the period as a number of updates per second.
+		[attributesList addObject:[NSNumber numberWithInt:ALC_REFRESH]];
+		[attributesList addObject:[NSNumber numberWithInt:MAX(1, (frequency + periodFrames / 2) / periodFrames)]];
+	}
+
+	return [self initOnDevice:deviceIn attributes:attributesList];
 }
 
 - (id) initOnDevice:(ALDevice *) deviceIn attributes:(NSArray*) attributesIn
@@ -147,6 +289,16 @@
 	if(nil != (self = [super init]))
 	{
 		OAL_LOG_DEBUG(@"%@: Init on %@ with attributes %@", self, deviceIn, attributesIn);
+		OALLockInit(&lock);
+		OALLockInit(&sourcesLock);
+		OALLockInit(&dirtySourcesLock);
+		OALLockInit(&bulkLock);
+		OALLockInit(&spatialLock);
+		cullingThreshold = 0.001f;
+		occlusionUpdateTime = -1;
+		OALLockInit(&occlusionLock);
+		occlusionBudget = 32;
+		occlusionSmoothing = 0.1f;
 
 		if(nil == deviceIn)
 		{
@@ -156,17 +308,21 @@
 
 		suspendHandler = [[OALSuspendHandler alloc] initWithTarget:self selector:@selector(setSuspended:)];
 
-		// Build up an ALCint array for OpenAL's createContext function.
+		// Loopback devices need their mixing format passed in.
+		attributesIn = [deviceIn contextAttributes:attributesIn];
+
+		// Build up a zero terminated ALCint array for OpenAL's createContext function.
 		ALCint* attributesList = nil;
 
 		if([attributesIn count] > 0)
 		{
-			attributesList = (ALCint*)malloc(sizeof(ALCint) * [attributesIn count]);
+			attributesList = (ALCint*)malloc(sizeof(ALCint) * ([attributesIn count] + 1));
 			ALCint* attributePtr = attributesList;
 			for(NSNumber* number in attributesIn)
 			{
 				*attributePtr++ = [number intValue];
 			}
+			*attributePtr = 0;
 		}
 		
 		// Notify the device that we are being created.
@@ -182,33 +338,31 @@
         }
 		
 		listener = [[ALListener alloc] initWithContext:self];
+
+		masterBus = [[ALMixBus alloc] initWithParent:nil];
+		masterBus.name = @"master";
+
+		// Sources reach for this from inside their own locks, so it's made up front rather
+		// than on first use. It doesn't create any OpenAL objects until they're needed.
+		effects = [[ALEffects alloc] initWithContext:self];
 		
 		sources = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:32];
+		dirtySources = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:32];
+		scheduledStarts = [[NSMutableDictionary alloc] initWithCapacity:4];
+		loopSwitchSources = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:4];
+		relativeSources = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:8];
+		spatialGrid = OALSpatialGridCreate(kALDefaultSpatialCellSize);
+		occlusionBatch = [[NSMutableArray alloc] initWithCapacity:32];
 		
-		// Cache all attributes for this context.
-		attributes = [[NSMutableArray alloc] initWithCapacity:5];
-		int buffSize = [ALWrapper getInteger:device.device attribute:ALC_ATTRIBUTES_SIZE];
-		if(buffSize > 0)
-		{
-			if(nil != attributesList)
-			{
-				free(attributesList);
-			}
-			attributesList = malloc(sizeof(ALCint) * (unsigned long)buffSize);
-			if([ALWrapper getIntegerv:device.device attribute:ALC_ALL_ATTRIBUTES size:buffSize data:attributesList])
-			{
-				for(int i = 0; i < buffSize; i++)
-				{
-					[attributes addObject:[NSNumber numberWithInt:attributesList[i]]];
-				}
-			}
-		}
-
 		if(nil != attributesList)
 		{
 			free(attributesList);
 		}
 
+		// Cache all attributes for this context.
+		attributes = [[NSMutableArray alloc] initWithCapacity:5];
+		[self cacheAttributes];
+
 		// Manually add a suspend listener for ALListener because if someone
 		// retains the listener it could outlive the context, even though
 		// such a thing would be bad form.
@@ -231,6 +385,18 @@ initFailed:
 	[device removeSuspendListener:self];
 	[device notifyContextDeallocating:self];
 
+    if(nil != effects)
+    {
+        // Effect slots belong to this context, so it must be current to delete them.
+        @synchronized([OpenALManager sharedInstance])
+        {
+            ALCcontext* currentContext = [ALWrapper getCurrentContext];
+            [ALWrapper makeContextCurrent:context];
+            [effects close];
+            [ALWrapper makeContextCurrent:currentContext];
+        }
+    }
+
     if([OpenALManager sharedInstance].currentContext == self)
     {
         [OpenALManager sharedInstance].currentContext = nil;
@@ -238,16 +404,56 @@ initFailed:
     [ALWrapper destroyContext:context];
 
 	as_release(sources);
+	as_release(dirtySources);
+	if(device.loopback && [scheduledStarts count] > 0)
+	{
+		[device notifyScheduledStartsChanged:-(int32_t)[scheduledStarts count]];
+	}
+	as_release(scheduledStarts);
+	as_release(loopSwitchSources);
+	as_release(relativeSources);
 	as_release(listener);
+	as_release(masterBus);
+	as_release(effects);
 	as_release(device);
 	as_release(attributes);
 	as_release(suspendHandler);
+	as_release(occlusionQuery);
+	as_release(occlusionBatch);
+	OALLockDestroy(&lock);
+	OALLockDestroy(&sourcesLock);
+	OALLockDestroy(&dirtySourcesLock);
+	OALLockDestroy(&bulkLock);
+	OALLockDestroy(&spatialLock);
+	OALLockDestroy(&occlusionLock);
+	free(bulkSourceIds);
+	free(bulkValues);
+	free(bulkSources);
+	free(bulkSequences);
+	OALSpatialGridDestroy(spatialGrid);
+	free(nearbySources);
+	free(spatialResults);
+	free(occlusionCandidates);
+	free(occlusionPositions);
+	free(occlusionResults);
 	as_superdealloc();
 }
 
 
 #pragma mark Properties
 
+- (int) periodFrames
+{
+	int frequency = 0;
+	int refresh = 0;
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		frequency = attributeValue(attributes, ALC_FREQUENCY, device.frequency);
+		refresh = attributeValue(attributes, ALC_REFRESH, 0);
+	}
+	return refresh > 0 ? frequency / refresh : 0;
+}
+
 - (NSString*) alVersion
 {
 	return [ALWrapper getString:AL_VERSION];
@@ -256,7 +462,7 @@ initFailed:
 
 - (ALenum) distanceModel
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		return [ALWrapper getInteger:AL_DISTANCE_MODEL];
 	}
@@ -264,7 +470,7 @@ initFailed:
 
 - (void) setDistanceModel:(ALenum) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -278,7 +484,7 @@ initFailed:
 
 - (float) dopplerFactor
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		return [ALWrapper getFloat:AL_DOPPLER_FACTOR];
 	}
@@ -286,7 +492,7 @@ initFailed:
 
 - (void) setDopplerFactor:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -315,7 +521,7 @@ initFailed:
 
 - (float) speedOfSound
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		return [ALWrapper getFloat:AL_SPEED_OF_SOUND];
 	}
@@ -323,7 +529,7 @@ initFailed:
 
 - (void) setSpeedOfSound:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -340,6 +546,162 @@ initFailed:
 	return [ALWrapper getString:AL_VENDOR];
 }
 
+- (bool) cullingEnabled
+{
+	return OAL_ATOMIC_LOAD(&cullingEnabled);
+}
+
+- (void) setCullingEnabled:(bool) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(value == cullingEnabled)
+		{
+			return;
+		}
+		OAL_ATOMIC_STORE(&cullingEnabled, value);
+	}
+
+	if(!value)
+	{
+		// Put everything back in the mixer. With a restore threshold of 0,
+		// every virtualized source qualifies.
+		OPTIONALLY_LOCKED(sources, &sourcesLock)
+		{
+			for(ALSource* source in sources)
+			{
+				[source updateCullingWithListenerPosition:alpoint(0, 0, 0)
+											 listenerGain:1
+											distanceModel:AL_NONE
+												cullBelow:0
+											 restoreAbove:0];
+			}
+		}
+	}
+}
+
+- (float) cullingThreshold
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return cullingThreshold;
+	}
+}
+
+- (void) setCullingThreshold:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		cullingThreshold = value;
+	}
+}
+
+- (float) cullingRadius
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return cullingRadius;
+	}
+}
+
+- (void) setCullingRadius:(float) value
+{
+	value = fmaxf(value, 0);
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		OPTIONALLY_LOCKED(self, &lock)
+		{
+			if(value == cullingRadius)
+			{
+				return;
+			}
+			cullingRadius = value;
+		}
+
+		// Rebuild the index with cells the size of the new radius, so that
+		// a query around the listener only looks at a few cells.
+		OALSpatialGridDestroy(spatialGrid);
+		spatialGrid = OALSpatialGridCreate(value > 0 ? value : kALDefaultSpatialCellSize);
+		nearbySourcesCount = 0;
+		cullingPassCount = 0;
+		OPTIONALLY_LOCKED(sources, &sourcesLock)
+		{
+			for(ALSource* source in sources)
+			{
+				source.spatialHandle = kOALSpatialGridNoHandle;
+				[self indexSource:source];
+			}
+		}
+	}
+}
+
+- (ALOcclusionQuery) occlusionQuery
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return occlusionQuery;
+	}
+}
+
+- (void) setOcclusionQuery:(ALOcclusionQuery) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		ALOcclusionQuery copied = [value copy];
+		as_release(occlusionQuery);
+		occlusionQuery = copied;
+	}
+}
+
+- (NSUInteger) occlusionBudget
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return occlusionBudget;
+	}
+}
+
+- (void) setOcclusionBudget:(NSUInteger) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		occlusionBudget = value;
+	}
+}
+
+- (float) occlusionSmoothing
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return occlusionSmoothing;
+	}
+}
+
+- (void) setOcclusionSmoothing:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		occlusionSmoothing = fmaxf(value, 0);
+	}
+}
+
+- (bool) deferUpdates
+{
+	return deferUpdates;
+}
+
+- (void) setDeferUpdates:(bool) value
+{
+	OPTIONALLY_LOCKED(dirtySources, &dirtySourcesLock)
+	{
+		deferUpdates = value;
+	}
+	if(!value)
+	{
+		[self commitDeferredUpdates];
+	}
+}
+
 
 #pragma mark Suspend Handler
 
@@ -387,6 +749,7 @@ initFailed:
 	else
 	{
 		[self process];
+		[self commitDeferredUpdates];
 	}
 }
 
@@ -395,7 +758,7 @@ initFailed:
 
 - (void) clearBuffers
 {
-	OPTIONALLY_SYNCHRONIZED(sources)
+	OPTIONALLY_LOCKED(sources, &sourcesLock)
 	{
 		for(ALSource* source in sources)
 		{
@@ -417,7 +780,7 @@ initFailed:
 
 - (void) stopAllSounds
 {
-	OPTIONALLY_SYNCHRONIZED(sources)
+	OPTIONALLY_LOCKED(sources, &sourcesLock)
 	{
 		if(self.suspended)
 		{
@@ -446,34 +809,875 @@ initFailed:
 	}
 }
 
-#pragma mark Extensions
-
-- (bool) isExtensionPresent:(NSString*) name
+- (void) commitDeferredUpdates
 {
-	return [ALWrapper isExtensionPresent:name];
+	// Without AL_SOFT_deferred_updates, the batch is bracketed by suspending and
+	// processing the context, which would undo an interruption. The changes stay
+	// pending, and get committed on resume.
+	if(self.suspended)
+	{
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return;
+	}
+
+	NSArray* pendingSources;
+	OPTIONALLY_LOCKED(dirtySources, &dirtySourcesLock)
+	{
+		if([dirtySources count] == 0)
+		{
+			return;
+		}
+		pendingSources = [NSArray arrayWithArray:dirtySources];
+		[dirtySources removeAllObjects];
+	}
+
+	// Sources are committed outside of the lock so that a source setter
+	// (which locks the source, then the context) can't deadlock with us.
+	[ALWrapper beginDeferredUpdates:context];
+	for(ALSource* source in pendingSources)
+	{
+		[source commitParameters];
+	}
+	[ALWrapper endDeferredUpdates:context];
 }
 
-- (void*) getProcAddress:(NSString*) functionName
+- (void) updateLoopPoints
 {
-	return [ALWrapper getProcAddress:functionName];
-}
+	NSArray* pending = nil;
+	ALWAYS_LOCKED(self, &lock)
+	{
+		if(0 == [loopSwitchSources count])
+		{
+			return;
+		}
+		pending = [NSArray arrayWithArray:loopSwitchSources];
+	}
 
+	// Sources are serviced outside of our lock, since they lock themselves first.
+	NSMutableArray* done = [NSMutableArray arrayWithCapacity:[pending count]];
+	for(ALSource* source in pending)
+	{
+		if(![source serviceLoopQueue])
+		{
+			[done addObject:source];
+		}
+	}
 
-#pragma mark Internal Use
+	ALWAYS_LOCKED(self, &lock)
+	{
+		for(ALSource* source in done)
+		{
+			[loopSwitchSources removeObjectIdenticalTo:source];
+		}
+	}
+}
 
-- (void) notifySourceInitializing:(ALSource*) source
+- (bool) playSources:(NSArray*) sourcesIn atSampleTime:(int64_t) sampleTime
 {
-	OPTIONALLY_SYNCHRONIZED(sources)
+	if(self.suspended)
 	{
-		[sources addObject:source];
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return NO;
+	}
+
+	NSUInteger numSources = [sourcesIn count];
+	if(0 == numSources)
+	{
+		return YES;
+	}
+
+	NSMutableArray* ready = [NSMutableArray arrayWithCapacity:numSources];
+	for(ALSource* source in sourcesIn)
+	{
+		if([source prepareScheduledStart])
+		{
+			[ready addObject:source];
+		}
+	}
+	if([ready count] == 0)
+	{
+		return NO;
+	}
+
+	int64_t startTime = (int64_t)((double)sampleTime * 1000000000.0 / (double)device.frequency);
+
+	if(device.hasDeviceClock && [ALWrapper canPlayAtTime])
+	{
+		// OpenAL starts them for us, on the mixer's own clock.
+		ALuint* sourceIds = malloc(sizeof(ALuint) * [ready count]);
+		ALsizei count = 0;
+		for(ALSource* source in ready)
+		{
+			sourceIds[count++] = source.sourceId;
+		}
+		bool started = [ALWrapper sourcePlayv:sourceIds numSources:count atTime:startTime];
+		free(sourceIds);
+		for(ALSource* source in ready)
+		{
+			[source notifyScheduledStart:started];
+		}
+		return started;
+	}
+
+	// No start delay support, so start them from a timer.
+	NSNumber* key = [NSNumber numberWithLongLong:startTime];
+	bool needsTimer = NO;
+	ALWAYS_LOCKED(self, &lock)
+	{
+		// A source that was stopped and rescheduled may still be waiting in another group.
+		for(NSMutableArray* otherGroup in [scheduledStarts allValues])
+		{
+			for(ALSource* source in ready)
+			{
+				[otherGroup removeObjectIdenticalTo:source];
+			}
+		}
+
+		NSMutableArray* group = [scheduledStarts objectForKey:key];
+		if(nil == group)
+		{
+			group = [NSMutableArray arrayWithCapacity:[ready count]];
+			[scheduledStarts setObject:group forKey:key];
+			needsTimer = YES;
+		}
+		[group addObjectsFromArray:ready];
+	}
+
+	if(device.loopback)
+	{
+		// A loopback device's clock only moves as it renders, so it starts them itself.
+		if(needsTimer)
+		{
+			[device notifyScheduledStartsChanged:1];
+		}
 	}
+	else if(needsTimer)
+	{
+		int64_t delay = startTime - device.deviceClock;
+		dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delay > 0 ? delay : 0),
+					   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0),
+					   ^{
+						   [self startScheduledSources:key];
+					   });
+	}
+	return YES;
 }
 
-- (void) notifySourceDeallocating:(ALSource*) source
+- (void) startScheduledSources:(NSNumber*) key
 {
-	OPTIONALLY_SYNCHRONIZED(sources)
+	NSMutableArray* group;
+	ALWAYS_LOCKED(self, &lock)
 	{
-		[sources removeObject:source];
+		group = as_autorelease(as_retain([scheduledStarts objectForKey:key]));
+		[scheduledStarts removeObjectForKey:key];
+	}
+	if(nil != group && device.loopback)
+	{
+		[device notifyScheduledStartsChanged:-1];
+	}
+
+	// Skip any that were stopped while waiting.
+	NSMutableArray* pending = [NSMutableArray arrayWithCapacity:[group count]];
+	for(ALSource* source in group)
+	{
+		if([source takeScheduledStart])
+		{
+			[pending addObject:source];
+		}
+	}
+	if([pending count] == 0)
+	{
+		return;
+	}
+
+	// Timers can fire late. Start that much further into the sound
+	// so that the sources stay in step with the device clock.
+	double lateness = (double)(device.deviceClock - [key longLongValue]) / 1000000000.0;
+	ALuint* sourceIds = malloc(sizeof(ALuint) * [pending count]);
+	ALsizei count = 0;
+	for(ALSource* source in pending)
+	{
+		if(lateness > 0.001)
+		{
+			float offset = (float)lateness * source.pitch;
+			if(source.looping && source.buffer.duration > 0)
+			{
+				offset = fmodf(offset, source.buffer.duration);
+			}
+			if(offset < source.buffer.duration)
+			{
+				source.offsetInSeconds = offset;
+			}
+		}
+		sourceIds[count++] = source.sourceId;
+	}
+
+	// One call, so that OpenAL starts them all in the same mix.
+	bool started = [ALWrapper sourcePlayv:sourceIds numSources:count];
+	free(sourceIds);
+	for(ALSource* source in pending)
+	{
+		[source notifyScheduledStart:started];
+	}
+}
+
+- (int64_t) nextScheduledSampleTime
+{
+	int64_t nextTime = INT64_MAX;
+	ALWAYS_LOCKED(self, &lock)
+	{
+		for(NSNumber* key in scheduledStarts)
+		{
+			nextTime = MIN(nextTime, [key longLongValue]);
+		}
+	}
+	if(INT64_MAX == nextTime)
+	{
+		return INT64_MAX;
+	}
+	// Keys were converted from sample times, so this rounds back to the same sample.
+	return llround((double)nextTime * (double)device.frequency / 1000000000.0);
+}
+
+- (void) startScheduledSourcesAtSampleTime:(int64_t) sampleTime
+{
+	double frequency = device.frequency;
+	NSArray* dueKeys = nil;
+	ALWAYS_LOCKED(self, &lock)
+	{
+		NSMutableArray* keys = [NSMutableArray arrayWithCapacity:[scheduledStarts count]];
+		for(NSNumber* key in scheduledStarts)
+		{
+			if(llround((double)[key longLongValue] * frequency / 1000000000.0) <= sampleTime)
+			{
+				[keys addObject:key];
+			}
+		}
+		dueKeys = [keys sortedArrayUsingSelector:@selector(compare:)];
+	}
+
+	for(NSNumber* key in dueKeys)
+	{
+		[self startScheduledSources:key];
+	}
+}
+
+/** Orders pointers by address, for comparing sets of sources. */
+static int comparePointers(const void* a, const void* b)
+{
+	uintptr_t first = (uintptr_t)*(void* const*)a;
+	uintptr_t second = (uintptr_t)*(void* const*)b;
+	return first < second ? -1 : first > second;
+}
+
+- (void) updateCulling
+{
+	if(!OAL_ATOMIC_LOAD(&cullingEnabled) || self.suspended)
+	{
+		return;
+	}
+
+	ALPoint listenerPosition = listener.position;
+	float listenerGain = listener.muted ? 0 : listener.gain;
+	ALenum distanceModel = self.distanceModel;
+	float cullBelow = self.cullingThreshold;
+	float restoreAbove = cullBelow * kALCullingHysteresis;
+	float radius = self.cullingRadius;
+
+	if(radius <= 0)
+	{
+		OPTIONALLY_LOCKED(sources, &sourcesLock)
+		{
+			for(ALSource* source in sources)
+			{
+				[source updateCullingWithListenerPosition:listenerPosition
+											 listenerGain:listenerGain
+											distanceModel:distanceModel
+												cullBelow:cullBelow
+											 restoreAbove:restoreAbove];
+			}
+		}
+		return;
+	}
+
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		if(0 == cullingPassCount++ % kALCullingFullPassInterval)
+		{
+			// Full pass. Anything outside the radius is culled, whatever its gain.
+			float radiusSquared = radius * radius;
+			OPTIONALLY_LOCKED(sources, &sourcesLock)
+			{
+				for(ALSource* source in sources)
+				{
+					bool nearby = YES;
+					if(!source.sourceRelative)
+					{
+						ALPoint position = source.position;
+						float dx = position.x - listenerPosition.x;
+						float dy = position.y - listenerPosition.y;
+						float dz = position.z - listenerPosition.z;
+						nearby = dx*dx + dy*dy + dz*dz <= radiusSquared;
+					}
+					[source updateCullingWithListenerPosition:listenerPosition
+												 listenerGain:listenerGain
+												distanceModel:distanceModel
+													cullBelow:nearby ? cullBelow : FLT_MAX
+												 restoreAbove:nearby ? restoreAbove : FLT_MAX];
+				}
+			}
+			nearbySourcesCount = [self querySpatialIndexAround:listenerPosition radius:radius];
+			memcpy(nearbySources, spatialResults, nearbySourcesCount * sizeof(*nearbySources));
+			qsort(nearbySources, nearbySourcesCount, sizeof(*nearbySources), comparePointers);
+			return;
+		}
+
+		// Only the sources near the listener can be heard.
+		size_t found = [self querySpatialIndexAround:listenerPosition radius:radius];
+		for(size_t i = 0; i < found; i++)
+		{
+			[ALSourceFromSpatialItem(spatialResults[i]) updateCullingWithListenerPosition:listenerPosition
+																			 listenerGain:listenerGain
+																			distanceModel:distanceModel
+																				cullBelow:cullBelow
+																			 restoreAbove:restoreAbove];
+		}
+		for(ALSource* source in relativeSources)
+		{
+			[source updateCullingWithListenerPosition:listenerPosition
+										 listenerGain:listenerGain
+										distanceModel:distanceModel
+											cullBelow:cullBelow
+										 restoreAbove:restoreAbove];
+		}
+
+		// Cull the ones that have left the radius since the last pass.
+		// Both lists are sorted, so one walk finds them.
+		qsort(spatialResults, found, sizeof(*spatialResults), comparePointers);
+		size_t current = 0;
+		for(size_t i = 0; i < nearbySourcesCount; i++)
+		{
+			void* previous = nearbySources[i];
+			while(current < found && (uintptr_t)spatialResults[current] < (uintptr_t)previous)
+			{
+				current++;
+			}
+			if(NULL == previous || (current < found && spatialResults[current] == previous))
+			{
+				continue;
+			}
+			[ALSourceFromSpatialItem(previous) updateCullingWithListenerPosition:listenerPosition
+																	listenerGain:listenerGain
+																   distanceModel:distanceModel
+																	   cullBelow:FLT_MAX
+																	restoreAbove:FLT_MAX];
+		}
+		memcpy(nearbySources, spatialResults, found * sizeof(*nearbySources));
+		nearbySourcesCount = found;
+	}
+}
+
+
+/** Orders occlusion candidates most in need of checking first. */
+static int compareOcclusionCandidates(const void* a, const void* b)
+{
+	float first = ((const struct ALOcclusionCandidate*)a)->score;
+	float second = ((const struct ALOcclusionCandidate*)b)->score;
+	return first > second ? -1 : first < second;
+}
+
+- (void) updateOcclusion
+{
+	ALOcclusionQuery query;
+	NSUInteger budget;
+	float smoothing;
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		query = as_retain(occlusionQuery);
+		budget = occlusionBudget;
+		smoothing = occlusionSmoothing;
+	}
+	if(nil == query || self.suspended)
+	{
+		as_release(query);
+		return;
+	}
+
+	ALPoint listenerPosition = listener.position;
+	ALWAYS_LOCKED(occlusionBatch, &occlusionLock)
+	{
+		double now = OALClockNow();
+		float elapsed = occlusionUpdateTime < 0 ? 0 : (float)(now - occlusionUpdateTime);
+		occlusionUpdateTime = now;
+
+		// Score every source that could be checked, and keep the ones that need it most.
+		size_t count = 0;
+		OPTIONALLY_LOCKED(sources, &sourcesLock)
+		{
+			NSUInteger numSources = [sources count];
+			if(occlusionCandidatesCapacity < numSources)
+			{
+				occlusionCandidatesCapacity = numSources + numSources / 2;
+				occlusionCandidates = realloc(occlusionCandidates, sizeof(*occlusionCandidates) * occlusionCandidatesCapacity);
+				occlusionPositions = realloc(occlusionPositions, sizeof(*occlusionPositions) * occlusionCandidatesCapacity);
+				occlusionResults = realloc(occlusionResults, sizeof(*occlusionResults) * 2 * occlusionCandidatesCapacity);
+			}
+
+			for(ALSource* source in sources)
+			{
+				struct ALOcclusionCandidate* candidate = &occlusionCandidates[count];
+				candidate->score = [source occlusionScoreAtListenerPosition:listenerPosition
+																	   time:now
+																   position:&candidate->position];
+				if(candidate->score > 0)
+				{
+					candidate->source = (as_bridge void*)source;
+					count++;
+				}
+			}
+
+			if(count > budget)
+			{
+				qsort(occlusionCandidates, count, sizeof(*occlusionCandidates), compareOcclusionCandidates);
+				count = budget;
+			}
+
+			// Hold on to the batch, since sources can go away while the query runs.
+			for(size_t i = 0; i < count; i++)
+			{
+				[occlusionBatch addObject:(as_bridge ALSource*)occlusionCandidates[i].source];
+				occlusionPositions[i] = occlusionCandidates[i].position;
+			}
+		}
+
+		if(count > 0)
+		{
+			float* occlusions = occlusionResults;
+			float* obstructions = occlusionResults + count;
+			memset(occlusionResults, 0, sizeof(*occlusionResults) * 2 * count);
+			query(listenerPosition, occlusionPositions, count, occlusions, obstructions);
+
+			size_t i = 0;
+			for(ALSource* source in occlusionBatch)
+			{
+				[source setOcclusionTarget:occlusions[i] obstruction:obstructions[i] time:now];
+				i++;
+			}
+			[occlusionBatch removeAllObjects];
+		}
+
+		// Glide everything toward its latest result. Sources that have arrived return right away.
+		float amount = smoothing > 0 ? 1.0f - expf(-elapsed / smoothing) : 1.0f;
+		if(amount > 0)
+		{
+			OPTIONALLY_LOCKED(sources, &sourcesLock)
+			{
+				for(ALSource* source in sources)
+				{
+					[source smoothOcclusion:amount];
+				}
+			}
+		}
+	}
+	as_release(query);
+}
+
+
+#pragma mark Spatial Queries
+
+- (NSArray*) sourcesWithinRadius:(float) radius ofPoint:(ALPoint) point
+{
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		size_t found = [self querySpatialIndexAround:point radius:radius];
+		NSMutableArray* result = [NSMutableArray arrayWithCapacity:found];
+		for(size_t i = 0; i < found; i++)
+		{
+			ALSource* source = ALSourceFromSpatialItem(spatialResults[i]);
+			if(nil != source)
+			{
+				[result addObject:source];
+			}
+		}
+		return result;
+	}
+}
+
+- (NSArray*) nearestSources:(NSUInteger) count toPoint:(ALPoint) point
+{
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		[self reserveSpatialCapacity:count];
+		size_t found = OALSpatialGridQueryNearest(spatialGrid, point.x, point.y, point.z, FLT_MAX, spatialResults, count);
+		NSMutableArray* result = [NSMutableArray arrayWithCapacity:found];
+		for(size_t i = 0; i < found; i++)
+		{
+			ALSource* source = ALSourceFromSpatialItem(spatialResults[i]);
+			if(nil != source)
+			{
+				[result addObject:source];
+			}
+		}
+		return result;
+	}
+}
+
+/** A source's place in a list of candidates, and its estimated gain. */
+typedef struct
+{
+	float gain;
+	NSUInteger index;
+} ALScoredSource;
+
+/** Orders scored sources loudest first. */
+static int compareScoredSources(const void* a, const void* b)
+{
+	float first = ((const ALScoredSource*)a)->gain;
+	float second = ((const ALScoredSource*)b)->gain;
+	return first > second ? -1 : first < second;
+}
+
+- (NSArray*) loudestSources:(NSUInteger) count withinRadius:(float) radius
+{
+	ALPoint listenerPosition = listener.position;
+	ALenum distanceModel = self.distanceModel;
+
+	NSMutableArray* candidates = nil;
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		size_t found = [self querySpatialIndexAround:listenerPosition radius:radius];
+		candidates = [NSMutableArray arrayWithCapacity:found + [relativeSources count]];
+		for(size_t i = 0; i < found; i++)
+		{
+			ALSource* source = ALSourceFromSpatialItem(spatialResults[i]);
+			if(nil != source)
+			{
+				[candidates addObject:source];
+			}
+		}
+		[candidates addObjectsFromArray:relativeSources];
+	}
+
+	// Scoring takes each source's lock, so do it outside of the index lock.
+	NSUInteger numCandidates = [candidates count];
+	if(0 == numCandidates || 0 == count)
+	{
+		return [NSArray array];
+	}
+	ALScoredSource* scores = malloc(sizeof(ALScoredSource) * numCandidates);
+	NSUInteger i = 0;
+	for(ALSource* source in candidates)
+	{
+		scores[i].gain = [source estimatedGainAtListenerPosition:listenerPosition distanceModel:distanceModel];
+		scores[i].index = i;
+		i++;
+	}
+	qsort(scores, numCandidates, sizeof(*scores), compareScoredSources);
+
+	NSUInteger numResults = MIN(count, numCandidates);
+	NSMutableArray* result = [NSMutableArray arrayWithCapacity:numResults];
+	for(i = 0; i < numResults; i++)
+	{
+		[result addObject:[candidates objectAtIndex:scores[i].index]];
+	}
+	free(scores);
+	return result;
+}
+
+- (void) indexSource:(ALSource*) source
+{
+	int32_t handle = source.spatialHandle;
+	if(source.sourceRelative)
+	{
+		// Its position is relative to the listener, so it doesn't belong in the index.
+		if(kOALSpatialGridNoHandle != handle)
+		{
+			OALSpatialGridRemove(spatialGrid, handle);
+			source.spatialHandle = kOALSpatialGridNoHandle;
+		}
+		if(NSNotFound == [relativeSources indexOfObjectIdenticalTo:source])
+		{
+			[relativeSources addObject:source];
+		}
+		return;
+	}
+
+	ALPoint position = source.position;
+	if(kOALSpatialGridNoHandle == handle)
+	{
+		[relativeSources removeObjectIdenticalTo:source];
+		source.spatialHandle = OALSpatialGridInsert(spatialGrid, source.spatialItem, position.x, position.y, position.z);
+	}
+	else
+	{
+		OALSpatialGridMove(spatialGrid, handle, position.x, position.y, position.z);
+	}
+}
+
+- (void) reserveSpatialCapacity:(size_t) count
+{
+	if(count <= spatialCapacity)
+	{
+		return;
+	}
+	spatialCapacity = MAX(count, spatialCapacity * 2);
+	nearbySources = realloc(nearbySources, sizeof(*nearbySources) * spatialCapacity);
+	spatialResults = realloc(spatialResults, sizeof(*spatialResults) * spatialCapacity);
+}
+
+- (size_t) querySpatialIndexAround:(ALPoint) point radius:(float) radius
+{
+	size_t found = OALSpatialGridQueryRadius(spatialGrid, point.x, point.y, point.z, radius, spatialResults, spatialCapacity);
+	if(found > spatialCapacity)
+	{
+		[self reserveSpatialCapacity:found];
+		found = OALSpatialGridQueryRadius(spatialGrid, point.x, point.y, point.z, radius, spatialResults, spatialCapacity);
+	}
+	return found;
+}
+
+
+#pragma mark Bulk Updates
+
+- (void) updateSources:(NSArray*) sourcesIn
+			 positionX:(const float*) positionX
+			 positionY:(const float*) positionY
+			 positionZ:(const float*) positionZ
+			 velocityX:(const float*) velocityX
+			 velocityY:(const float*) velocityY
+			 velocityZ:(const float*) velocityZ
+{
+	if(self.suspended)
+	{
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return;
+	}
+
+	NSUInteger count = [sourcesIn count];
+	if(0 == count)
+	{
+		return;
+	}
+
+	ALWAYS_LOCKED(self, &bulkLock)
+	{
+		if(count > bulkCapacity)
+		{
+			free(bulkSourceIds);
+			free(bulkValues);
+			free(bulkSources);
+			free(bulkSequences);
+			bulkCapacity = count;
+			bulkSourceIds = malloc(sizeof(ALuint) * 2 * bulkCapacity);
+			bulkValues = malloc(sizeof(float) * 6 * bulkCapacity);
+			bulkSources = malloc(sizeof(void*) * bulkCapacity);
+			bulkSequences = malloc(sizeof(uint32_t) * bulkCapacity);
+		}
+
+		ALuint* positionIds = bulkSourceIds;
+		ALuint* velocityIds = bulkSourceIds + bulkCapacity;
+		float* posX = bulkValues;
+		float* posY = posX + bulkCapacity;
+		float* posZ = posY + bulkCapacity;
+		float* velX = posZ + bulkCapacity;
+		float* velY = velX + bulkCapacity;
+		float* velZ = velY + bulkCapacity;
+		ALsizei numPositions = 0;
+		ALsizei numVelocities = 0;
+		NSUInteger numChanged = 0;
+
+		// Update the shadow values and the spatial index, and gather the ones that changed.
+		NSUInteger i = 0;
+		ALWAYS_LOCKED(relativeSources, &spatialLock)
+		{
+			for(ALSource* source in sourcesIn)
+			{
+				ALPoint position = {0, 0, 0};
+				ALVector velocity = {0, 0, 0};
+				if(NULL != positionX)
+				{
+					position.x = positionX[i];
+					position.y = positionY[i];
+					position.z = positionZ[i];
+				}
+				if(NULL != velocityX)
+				{
+					velocity.x = velocityX[i];
+					velocity.y = velocityY[i];
+					velocity.z = velocityZ[i];
+				}
+				i++;
+
+				uint32_t sequence;
+				uint32_t changed = [source storePosition:NULL != positionX ? &position : NULL
+												velocity:NULL != velocityX ? &velocity : NULL
+												sequence:&sequence];
+				if(0 == changed)
+				{
+					continue;
+				}
+				bulkSources[numChanged] = (as_bridge void*)source;
+				bulkSequences[numChanged] = sequence;
+				numChanged++;
+
+				ALuint sid = source.sourceId;
+				if(changed & kALSourcePositionChanged)
+				{
+					positionIds[numPositions] = sid;
+					posX[numPositions] = position.x;
+					posY[numPositions] = position.y;
+					posZ[numPositions] = position.z;
+					numPositions++;
+					[self indexSource:source];
+				}
+				if(changed & kALSourceVelocityChanged)
+				{
+					velocityIds[numVelocities] = sid;
+					velX[numVelocities] = velocity.x;
+					velY[numVelocities] = velocity.y;
+					velZ[numVelocities] = velocity.z;
+					numVelocities++;
+				}
+			}
+		}
+
+		if(0 == numPositions && 0 == numVelocities)
+		{
+			return;
+		}
+
+		// Send them all in one batch.
+		[ALWrapper beginDeferredUpdates:context];
+		if(numPositions > 0)
+		{
+			[ALWrapper sources3f:positionIds count:numPositions parameter:AL_POSITION x:posX y:posY z:posZ];
+		}
+		if(numVelocities > 0)
+		{
+			[ALWrapper sources3f:velocityIds count:numVelocities parameter:AL_VELOCITY x:velX y:velY z:velZ];
+		}
+
+		// A setter may have changed a source between storing and sending, in
+		// which case the batch just overwrote its newer value.
+		for(NSUInteger j = 0; j < numChanged; j++)
+		{
+			[(as_bridge ALSource*)bulkSources[j] resendMotionIfChangedSince:bulkSequences[j]];
+		}
+		[ALWrapper endDeferredUpdates:context];
+	}
+}
+
+#pragma mark Extensions
+
+- (bool) isExtensionPresent:(NSString*) name
+{
+	return [ALWrapper isExtensionPresent:name];
+}
+
+- (void*) getProcAddress:(NSString*) functionName
+{
+	return [ALWrapper getProcAddress:functionName];
+}
+
+
+- (void) cacheAttributes
+{
+	int buffSize = [ALWrapper getInteger:device.device attribute:ALC_ATTRIBUTES_SIZE];
+	if(buffSize <= 0)
+	{
+		return;
+	}
+
+	ALCint* attributesList = malloc(sizeof(ALCint) * (unsigned long)buffSize);
+	if([ALWrapper getIntegerv:device.device attribute:ALC_ALL_ATTRIBUTES size:buffSize data:attributesList])
+	{
+		OPTIONALLY_LOCKED(self, &lock)
+		{
+			[attributes removeAllObjects];
+			for(int i = 0; i < buffSize; i++)
+			{
+				[attributes addObject:[NSNumber numberWithInt:attributesList[i]]];
+			}
+		}
+	}
+	free(attributesList);
+}
+
+
+#pragma mark Internal Use
+
+- (void) notifySourceInitializing:(ALSource*) source
+{
+	OPTIONALLY_LOCKED(sources, &sourcesLock)
+	{
+		[sources addObject:source];
+	}
+}
+
+- (void) notifySourceDeallocating:(ALSource*) source
+{
+	// The spatial index first, since that's what other threads query without
+	// holding the source.
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		if(kOALSpatialGridNoHandle != source.spatialHandle)
+		{
+			OALSpatialGridRemove(spatialGrid, source.spatialHandle);
+			source.spatialHandle = kOALSpatialGridNoHandle;
+		}
+		[relativeSources removeObjectIdenticalTo:source];
+		for(size_t i = 0; i < nearbySourcesCount; i++)
+		{
+			if(nearbySources[i] == source.spatialItem)
+			{
+				nearbySources[i] = NULL;
+			}
+		}
+	}
+	OPTIONALLY_LOCKED(sources, &sourcesLock)
+	{
+		[sources removeObject:source];
+	}
+	OPTIONALLY_LOCKED(dirtySources, &dirtySourcesLock)
+	{
+		[dirtySources removeObjectIdenticalTo:source];
+	}
+	ALWAYS_LOCKED(self, &lock)
+	{
+		[loopSwitchSources removeObjectIdenticalTo:source];
+	}
+}
+
+- (void) notifySourceDirty:(ALSource*) source
+{
+	OPTIONALLY_LOCKED(dirtySources, &dirtySourcesLock)
+	{
+		[dirtySources addObject:source];
+	}
+}
+
+- (void) notifyDeviceReset
+{
+	// The device may have picked different attributes (HRTF, frequency, and so on).
+	[self cacheAttributes];
+}
+
+- (void) notifySourceMoved:(ALSource*) source
+{
+	ALWAYS_LOCKED(relativeSources, &spatialLock)
+	{
+		[self indexSource:source];
+	}
+}
+
+- (void) notifySourceLoopPending:(ALSource*) source
+{
+	ALWAYS_LOCKED(self, &lock)
+	{
+		if(NSNotFound == [loopSwitchSources indexOfObjectIdenticalTo:source])
+		{
+			[loopSwitchSources addObject:source];
+		}
 	}
 }
 
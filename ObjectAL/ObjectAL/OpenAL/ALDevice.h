@@ -46,6 +46,27 @@
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
+
+	/** If true, this device mixes into memory rather than to an audio device. */
+	bool loopback;
+	/** The frequency a loopback device mixes at. */
+	int loopbackFrequency;
+	/** The channel layout a loopback device mixes to. */
+	ALCenum channelLayout;
+	/** The sample type a loopback device mixes to. */
+	ALCenum sampleType;
+	/** Bytes per sample frame of a loopback device. */
+	int frameSize;
+	/** Sample frames mixed so far by a loopback device. */
+	int64_t renderedFrames;
+	/** How long the last offline render took, in seconds. */
+	NSTimeInterval lastRenderTime;
+	/** FNV-1a hash of the samples from the last offline render. */
+	uint64_t lastRenderChecksum;
+	/** Software scheduled starts waiting on this device's contexts. Loopback
+	 * devices start them as they render, so they only look when this isn't 0.
+	 */
+	int32_t pendingScheduledStarts;
 }
 
 
@@ -66,6 +87,91 @@
 /** The specification revision for this implementation (minor version). */
 @property(nonatomic,readonly,assign) int minorVersion;
 
+/** The frequency this device mixes at, in Hz. */
+@property(nonatomic,readonly,assign) int frequency;
+
+/** If true, this is a loopback device, which mixes into memory when asked to
+ * instead of playing through an audio device (see initLoopbackWithFrequency:channels:sampleType:).
+ */
+@property(nonatomic,readonly,assign) bool loopback;
+
+/** The channel layout a loopback device mixes to (ALC_MONO_SOFT, ALC_STEREO_SOFT,
+ * ALC_QUAD_SOFT, ALC_5POINT1_SOFT, ALC_6POINT1_SOFT or ALC_7POINT1_SOFT).
+ * 0 for other devices.
+ */
+@property(nonatomic,readonly,assign) ALCenum channelLayout;
+
+/** The number of channels a loopback device mixes to. 0 for other devices. */
+@property(nonatomic,readonly,assign) int channelCount;
+
+/** The sample type a loopback device mixes to (ALC_BYTE_SOFT, ALC_UNSIGNED_BYTE_SOFT,
+ * ALC_SHORT_SOFT, ALC_UNSIGNED_SHORT_SOFT, ALC_INT_SOFT, ALC_UNSIGNED_INT_SOFT or
+ * ALC_FLOAT_SOFT). 0 for other devices.
+ */
+@property(nonatomic,readonly,assign) ALCenum sampleType;
+
+/** The size of one sample frame (one sample for every channel) from a loopback
+ * device, in bytes. 0 for other devices.
+ */
+@property(nonatomic,readonly,assign) int frameSize;
+
+/** The number of sample frames a loopback device has mixed so far. */
+@property(nonatomic,readonly,assign) int64_t renderedFrames;
+
+/** How long the last call to renderToWAVFile:duration: took, in wall clock seconds.
+ * Divide the rendered duration by this to get the speed relative to realtime.
+ */
+@property(nonatomic,readonly,assign) NSTimeInterval lastRenderTime;
+
+/** A hash of everything the last call to renderToWAVFile:duration: mixed.
+ * Rendering is deterministic, so setting up the same scene and rendering it
+ * again gives the same checksum. Compare them to check that a scene doesn't
+ * depend on anything outside the render (wall clock timers and the like).
+ */
+@property(nonatomic,readonly,assign) uint64_t lastRenderChecksum;
+
+/** If true, the OpenAL implementation exposes the device's own clock (ALC_SOFT_device_clock).
+ * Otherwise, deviceClock and sampleClock are estimated from the system clock.
+ */
+@property(nonatomic,readonly,assign) bool hasDeviceClock;
+
+/** The device clock: How long the device has been mixing, in nanoseconds. */
+@property(nonatomic,readonly,assign) int64_t deviceClock;
+
+/** The total output latency: how long audio mixed now takes to be heard, in nanoseconds
+ * (ALC_SOFT_device_clock). Without the extension, iOS estimates it from the audio
+ * session's output latency and I/O buffer duration. 0 if unknown, and for loopback devices.
+ */
+@property(nonatomic,readonly,assign) int64_t latency;
+
+/** The device clock, in sample frames at the device's frequency.
+ * Use this as the base for scheduling sources to start at a particular sample
+ * (see ALSource.playAtSampleTime: and ALContext.playSources:atSampleTime:).
+ */
+@property(nonatomic,readonly,assign) int64_t sampleClock;
+
+/** If true, the OpenAL implementation can render binaural audio for headphones
+ * using HRTF (ALC_SOFT_HRTF).
+ */
+@property(nonatomic,readonly,assign) bool hrtfSupported;
+
+/** The names of the HRTF datasets that this device can use (NSString*).
+ * Empty if HRTF isn't supported.
+ */
+@property(nonatomic,readonly,retain) NSArray* hrtfSpecifiers;
+
+/** If true, this device is currently rendering with HRTF. */
+@property(nonatomic,readonly,assign) bool hrtfEnabled;
+
+/** Why HRTF is or isn't being used (ALC_HRTF_ENABLED_SOFT, ALC_HRTF_DISABLED_SOFT,
+ * ALC_HRTF_DENIED_SOFT, ALC_HRTF_REQUIRED_SOFT, ALC_HRTF_HEADPHONES_DETECTED_SOFT
+ * or ALC_HRTF_UNSUPPORTED_FORMAT_SOFT).
+ */
+@property(nonatomic,readonly,assign) int hrtfStatus;
+
+/** The name of the HRTF dataset in use, or nil if HRTF isn't enabled. */
+@property(nonatomic,readonly,retain) NSString* hrtfSpecifier;
+
 
 #pragma mark Object Management
 
@@ -83,6 +189,50 @@
  */
 - (id) initWithDeviceSpecifier:(NSString*) deviceSpecifier;
 
+/** Open a loopback device, which needs no audio hardware. It mixes into memory
+ * only when renderSamples:frames: or renderToWAVFile:duration: is called
+ * (ALC_SOFT_loopback). <br>
+ * Contexts, sources and OALSimpleAudio (see OALSimpleAudio.sharedInstanceWithDevice:sources:)
+ * work on it just as they do on other devices.
+ *
+ * @param frequency The frequency to mix at, in Hz.
+ * @param channels The channel layout to mix to (see channelLayout).
+ * @param sampleType The sample type to mix to (see sampleType).
+ * @return A new device, or nil if the format or loopback devices aren't supported.
+ */
++ (id) loopbackDeviceWithFrequency:(int) frequency
+						  channels:(ALCenum) channels
+						sampleType:(ALCenum) sampleType;
+
+/** Initialize a loopback device, which needs no audio hardware. It mixes into memory
+ * only when renderSamples:frames: or renderToWAVFile:duration: is called
+ * (ALC_SOFT_loopback). <br>
+ * Contexts, sources and OALSimpleAudio (see OALSimpleAudio.sharedInstanceWithDevice:sources:)
+ * work on it just as they do on other devices.
+ *
+ * @param frequency The frequency to mix at, in Hz.
+ * @param channels The channel layout to mix to (see channelLayout).
+ * @param sampleType The sample type to mix to (see sampleType).
+ * @return The initialized device, or nil if the format or loopback devices aren't supported.
+ */
+- (id) initLoopbackWithFrequency:(int) frequency
+						channels:(ALCenum) channels
+					  sampleType:(ALCenum) sampleType;
+
+/** Open a loopback device that mixes to 32-bit float stereo, for offline rendering.
+ *
+ * @param frequency The frequency to mix at, in Hz.
+ * @return A new device, or nil if loopback devices aren't supported.
+ */
++ (id) offlineDeviceWithFrequency:(int) frequency;
+
+/** Initialize a loopback device that mixes to 32-bit float stereo, for offline rendering.
+ *
+ * @param frequency The frequency to mix at, in Hz.
+ * @return The initialized device, or nil if loopback devices aren't supported.
+ */
+- (id) initOfflineWithFrequency:(int) frequency;
+
 
 #pragma mark Extensions
 
@@ -101,6 +251,93 @@
 - (void*) getProcAddress:(NSString*) functionName;
 
 
+#pragma mark Clock
+
+/** Read deviceClock and latency in one atomic step (ALC_DEVICE_CLOCK_LATENCY_SOFT),
+ * so that they describe the same moment. The audio being heard at that moment was
+ * mixed at clock - latency.
+ *
+ * @param clock Receives the device clock, in nanoseconds.
+ * @param latency Receives the total output latency, in nanoseconds.
+ */
+- (void) getDeviceClock:(int64_t*) clock latency:(int64_t*) latency;
+
+
+#pragma mark HRTF
+
+/** Build the context attributes that ask for HRTF, for use with
+ * ALContext.contextOnDevice:attributes: or resetWithAttributes:.
+ *
+ * @param mode ALC_TRUE to ask for HRTF, ALC_FALSE to turn it off, or
+ *        ALC_DONT_CARE_SOFT to let OpenAL decide (it usually enables HRTF
+ *        when it detects headphones).
+ * @param specifier The HRTF dataset to use (one of hrtfSpecifiers, nil = default).
+ * @return The attributes (NSNumber*, in attribute id/value pairs).
+ */
+- (NSArray*) hrtfAttributesWithMode:(int) mode specifier:(NSString*) specifier;
+
+/** Reset this device with new attributes, without losing its contexts, sources or
+ * buffers (ALC_SOFT_HRTF). Playback glitches briefly while the device restarts.
+ *
+ * @param attributes An array of NSNumber in ordered pairs (attribute id followed by integer value).
+ * @return TRUE if the device was reset.
+ */
+- (bool) resetWithAttributes:(NSArray*) attributes;
+
+/** Turn HRTF on or off, or switch datasets, by resetting this device. <br>
+ * Check hrtfEnabled and hrtfStatus afterwards, since OpenAL may not honor the request
+ * (for example when the output isn't stereo).
+ *
+ * @param mode ALC_TRUE, ALC_FALSE or ALC_DONT_CARE_SOFT (see hrtfAttributesWithMode:specifier:).
+ * @param specifier The HRTF dataset to use (one of hrtfSpecifiers, nil = default).
+ * @return TRUE if the device was reset.
+ */
+- (bool) setHRTFMode:(int) mode specifier:(NSString*) specifier;
+
+
+#pragma mark Loopback Rendering
+
+/** Mix the next sample frames of a loopback device into a buffer. <br><br>
+ *
+ * This is the pull side of a loopback device: call it from your own audio callback
+ * to embed ObjectAL's output in another engine, or from any loop to run without
+ * audio hardware. Sources scheduled with ALContext.playSources:atSampleTime: are
+ * started from here, on their exact sample. Otherwise it takes no locks of its own
+ * and allocates nothing, so it is safe to call from a realtime audio thread.
+ * Actions and the control thread keep running on their usual clocks; for lockstep
+ * offline rendering, see renderToWAVFile:duration:.
+ *
+ * @param buffer Where to put the samples (at least frames * frameSize bytes),
+ *        interleaved, in the device's channelLayout and sampleType.
+ * @param frames The number of sample frames to mix.
+ * @return TRUE if the samples were mixed.
+ */
+- (bool) renderSamples:(void*) buffer frames:(int) frames;
+
+/** Mix the contexts on a loopback device, as fast as possible, and write the result
+ * to a WAV file in the device's format. The sample type must be ALC_UNSIGNED_BYTE_SOFT,
+ * ALC_SHORT_SOFT, ALC_INT_SOFT or ALC_FLOAT_SOFT, which are the types WAV can hold. <br><br>
+ *
+ * While rendering, OALClockNow() runs on a virtual clock that advances with the
+ * rendered samples, and the action manager is stepped manually along with it, so
+ * fades and other actions land where they would have in realtime. Culling, occlusion,
+ * loop points and deferred source updates are handled on the same schedule, so the control
+ * thread should not be running. Scripted scenes can be set up beforehand (actions
+ * and sources started, sources scheduled on sampleClock), and rendering can be
+ * continued by calling this method again. The clock and action scheduling are
+ * restored afterwards. Nothing depends on the wall clock, so the same scene always
+ * renders to the same samples (see lastRenderChecksum). <br><br>
+ *
+ * Output is streamed to the file in small blocks, so memory use doesn't grow
+ * with the duration.
+ *
+ * @param path The file to write (nil = discard the output, to measure mixing cost only).
+ * @param duration How much audio to render, in seconds.
+ * @return TRUE if the audio was rendered.
+ */
+- (bool) renderToWAVFile:(NSString*) path duration:(float) duration;
+
+
 #pragma mark Utility
 
 /** Clear all buffers being used by sources of contexts opened on this device.
@@ -122,6 +359,21 @@
  * @param context The context that is deallocating.
  */
 - (void) notifyContextDeallocating:(ALContext*) context;
+
+/** (INTERNAL USE) Used by ALContext to add the attributes this device needs
+ * its contexts to be created with (the mixing format of loopback devices).
+ *
+ * @param attributes The attributes asked for (NSNumber*, in attribute id/value pairs).
+ * @return The attributes to create the context with.
+ */
+- (NSArray*) contextAttributes:(NSArray*) attributes;
+
+/** (INTERNAL USE) Used by ALContext to announce software scheduled starts
+ * being added or taken, so that a loopback device knows to start them.
+ *
+ * @param delta How many start times were added (positive) or taken (negative).
+ */
+- (void) notifyScheduledStartsChanged:(int32_t) delta;
 /** \endcond */
 
 @end
@@ -33,6 +33,159 @@
 #import "ARCSafe_MemMgmt.h"
 #import "ALWrapper.h"
 #import "OpenALManager.h"
+#import "OALClock.h"
+#import "OALActionManager.h"
+#import <stdio.h>
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+#import <AVFoundation/AVFoundation.h>
+#endif
+
+
+/** Sample frames mixed per block when rendering offline.
+ * Actions and source updates are applied between blocks.
+ */
+#define kALOfflineRenderFrames 256
+
+/** The largest sample frame a loopback device can produce (8 channels of 32 bits). */
+#define kALMaxFrameSize 32
+
+/** Size of the WAV header written by writeWAVHeader(). */
+#define kALWAVHeaderSize 58
+
+
+#pragma mark Sample Formats
+
+/** \cond */
+static int channelsInLayout(ALCenum layout)
+{
+	switch(layout)
+	{
+		case ALC_MONO_SOFT:
+			return 1;
+		case ALC_STEREO_SOFT:
+			return 2;
+		case ALC_QUAD_SOFT:
+			return 4;
+		case ALC_5POINT1_SOFT:
+			return 6;
+		case ALC_6POINT1_SOFT:
+			return 7;
+		case ALC_7POINT1_SOFT:
+			return 8;
+		default:
+			return 0;
+	}
+}
+
+static int bytesPerSample(ALCenum type)
+{
+	switch(type)
+	{
+		case ALC_BYTE_SOFT:
+		case ALC_UNSIGNED_BYTE_SOFT:
+			return 1;
+		case ALC_SHORT_SOFT:
+		case ALC_UNSIGNED_SHORT_SOFT:
+			return 2;
+		case ALC_INT_SOFT:
+		case ALC_UNSIGNED_INT_SOFT:
+		case ALC_FLOAT_SOFT:
+			return 4;
+		default:
+			return 0;
+	}
+}
+/** \endcond */
+
+
+#pragma mark WAV Output
+
+/** \cond */
+static void writeLE16(uint8_t* dst, uint16_t value)
+{
+	dst[0] = (uint8_t)value;
+	dst[1] = (uint8_t)(value >> 8);
+}
+
+static void writeLE32(uint8_t* dst, uint32_t value)
+{
+	dst[0] = (uint8_t)value;
+	dst[1] = (uint8_t)(value >> 8);
+	dst[2] = (uint8_t)(value >> 16);
+	dst[3] = (uint8_t)(value >> 24);
+}
+
+/** Check if WAV files can hold samples of a type. 8-bit WAV is unsigned,
+ * and wider integers are signed.
+ */
+static bool wavSupportsType(ALCenum type)
+{
+	return ALC_UNSIGNED_BYTE_SOFT == type
+	|| ALC_SHORT_SOFT == type
+	|| ALC_INT_SOFT == type
+	|| ALC_FLOAT_SOFT == type;
+}
+
+/** Write the header of a WAV file, at the start of the file.
+ * Called once with 0 frames before the data, then again with the real count.
+ */
+static bool writeWAVHeader(FILE* file, int channels, ALCenum type, int frequency, uint32_t frames)
+{
+	uint32_t bits = (uint32_t)bytesPerSample(type) * 8;
+	uint32_t blockAlign = (uint32_t)channels * bits / 8;
+	uint32_t dataSize = frames * blockAlign;
+	uint8_t header[kALWAVHeaderSize];
+
+	memcpy(header, "RIFF", 4);
+	writeLE32(header + 4, kALWAVHeaderSize - 8 + dataSize);
+	memcpy(header + 8, "WAVE", 4);
+
+	memcpy(header + 12, "fmt ", 4);
+	writeLE32(header + 16, 18);
+	writeLE16(header + 20, ALC_FLOAT_SOFT == type ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+	writeLE16(header + 22, (uint16_t)channels);
+	writeLE32(header + 24, (uint32_t)frequency);
+	writeLE32(header + 28, (uint32_t)frequency * blockAlign);
+	writeLE16(header + 32, (uint16_t)blockAlign);
+	writeLE16(header + 34, (uint16_t)bits);
+	writeLE16(header + 36, 0);
+
+	// Float needs a fact chunk. PCM readers skip it.
+	memcpy(header + 38, "fact", 4);
+	writeLE32(header + 42, 4);
+	writeLE32(header + 46, frames);
+
+	memcpy(header + 50, "data", 4);
+	writeLE32(header + 54, dataSize);
+
+	return 0 == fseek(file, 0, SEEK_SET) && 1 == fwrite(header, sizeof(header), 1, file);
+}
+
+/** Continue an FNV-1a hash over some bytes. */
+static uint64_t hashBytes(uint64_t hash, const uint8_t* bytes, size_t size)
+{
+	for(size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+	}
+	return hash;
+}
+/** \endcond */
+
+
+/**
+ * (INTERNAL USE) Private methods for ALDevice.
+ */
+@interface ALDevice ()
+
+/** (INTERNAL USE) Start any software scheduled sources that are due by
+ * renderedFrames, on a loopback device.
+ *
+ * @return The sample time of the next scheduled start, or INT64_MAX if there is none.
+ */
+- (int64_t) startDueScheduledSources;
+
+@end
 
 
 @implementation ALDevice
@@ -71,6 +224,76 @@ initFailed:
     return nil;
 }
 
++ (id) loopbackDeviceWithFrequency:(int) frequency
+						  channels:(ALCenum) channels
+						sampleType:(ALCenum) sampleTypeIn
+{
+	return as_autorelease([[self alloc] initLoopbackWithFrequency:frequency
+														 channels:channels
+													   sampleType:sampleTypeIn]);
+}
+
++ (id) offlineDeviceWithFrequency:(int) frequency
+{
+	return as_autorelease([[self alloc] initOfflineWithFrequency:frequency]);
+}
+
+- (id) initOfflineWithFrequency:(int) frequency
+{
+	return [self initLoopbackWithFrequency:frequency channels:ALC_STEREO_SOFT sampleType:ALC_FLOAT_SOFT];
+}
+
+- (id) initLoopbackWithFrequency:(int) frequency
+						channels:(ALCenum) channels
+					  sampleType:(ALCenum) sampleTypeIn
+{
+	if(nil != (self = [super init]))
+	{
+		suspendHandler = [[OALSuspendHandler alloc] initWithTarget:nil selector:nil];
+		
+		contexts = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:5];
+			
+		[[OpenALManager sharedInstance] notifyDeviceInitializing:self];
+		[[OpenALManager sharedInstance] addSuspendListener:self];
+		
+		OAL_LOG_DEBUG(@"%@: Init loopback device at %d Hz, channels 0x%x, type 0x%x",
+					  self, frequency, channels, sampleTypeIn);
+		
+		loopback = YES;
+		loopbackFrequency = frequency;
+		channelLayout = channels;
+		sampleType = sampleTypeIn;
+		frameSize = channelsInLayout(channels) * bytesPerSample(sampleTypeIn);
+		if(0 == frameSize)
+		{
+			OAL_LOG_ERROR(@"%@: Unknown channel layout 0x%x or sample type 0x%x", self, channels, sampleTypeIn);
+            goto initFailed;
+		}
+		
+		device = [ALWrapper openLoopbackDevice:nil];
+		if(nil == device)
+		{
+			OAL_LOG_ERROR(@"%@: Failed to create loopback OpenAL device", self);
+            goto initFailed;
+		}
+		
+		if(![ALWrapper isRenderFormatSupported:device
+									 frequency:frequency
+									  channels:channels
+										  type:sampleTypeIn])
+		{
+			OAL_LOG_ERROR(@"%@: Can't render channels 0x%x, type 0x%x at %d Hz",
+						  self, channels, sampleTypeIn, frequency);
+            goto initFailed;
+		}
+	}
+	return self;
+
+initFailed:
+    as_release(self);
+    return nil;
+}
+
 - (void) dealloc
 {
 	OAL_LOG_DEBUG(@"%@: Dealloc", self);
@@ -78,7 +301,10 @@ initFailed:
 	[[OpenALManager sharedInstance] removeSuspendListener:self];
 	[[OpenALManager sharedInstance] notifyDeviceDeallocating:self];
 
-    [ALWrapper closeDevice:device];
+	if(NULL != device)
+	{
+		[ALWrapper closeDevice:device];
+	}
 	
 	as_release(contexts);
 	as_release(suspendHandler);
@@ -107,6 +333,231 @@ initFailed:
 	return [ALWrapper getInteger:device attribute:ALC_MINOR_VERSION];
 }
 
+@synthesize loopback;
+
+@synthesize channelLayout;
+
+@synthesize sampleType;
+
+@synthesize frameSize;
+
+- (int) channelCount
+{
+	return channelsInLayout(channelLayout);
+}
+
+@synthesize renderedFrames;
+
+@synthesize lastRenderTime;
+@synthesize lastRenderChecksum;
+
+- (int) frequency
+{
+	if(loopback)
+	{
+		return loopbackFrequency;
+	}
+
+	int result = [ALWrapper getInteger:device attribute:ALC_FREQUENCY];
+	if(result <= 0)
+	{
+		// Not all implementations report the device frequency. 44100 is the usual default.
+		result = 44100;
+	}
+	return result;
+}
+
+- (bool) hasDeviceClock
+{
+	return [ALWrapper isExtensionPresent:device name:@"ALC_SOFT_device_clock"];
+}
+
+- (int64_t) deviceClock
+{
+	ALint64SOFT_OAL clock = 0;
+	if([ALWrapper getInteger64v:device attribute:ALC_DEVICE_CLOCK_SOFT size:1 data:&clock])
+	{
+		return clock;
+	}
+	if(loopback)
+	{
+		// Loopback time only moves as samples get mixed.
+		return (int64_t)((double)renderedFrames * 1000000000.0 / loopbackFrequency);
+	}
+	return (int64_t)(OALClockMonotonicSeconds() * 1000000000.0);
+}
+
+- (int64_t) latency
+{
+	ALint64SOFT_OAL value = 0;
+	if([ALWrapper getInteger64v:device attribute:ALC_DEVICE_LATENCY_SOFT size:1 data:&value])
+	{
+		return value;
+	}
+	if(loopback)
+	{
+		return 0;
+	}
+#if defined(__IPHONE_OS_VERSION_MAX_ALLOWED) && !defined(__TV_OS_VERSION_MIN_REQUIRED)
+	// What's queued in the I/O buffer, plus what the hardware route adds.
+	AVAudioSession* session = [AVAudioSession sharedInstance];
+	return (int64_t)((session.outputLatency + session.IOBufferDuration) * 1000000000.0);
+#else
+	return 0;
+#endif
+}
+
+- (int64_t) sampleClock
+{
+	if(loopback)
+	{
+		return renderedFrames;
+	}
+	return (int64_t)((double)self.deviceClock * (double)self.frequency / 1000000000.0);
+}
+
+- (bool) hrtfSupported
+{
+	return [ALWrapper isExtensionPresent:device name:@"ALC_SOFT_HRTF"];
+}
+
+- (NSArray*) hrtfSpecifiers
+{
+	if(!self.hrtfSupported)
+	{
+		return [NSArray array];
+	}
+
+	int count = [ALWrapper getInteger:device attribute:ALC_NUM_HRTF_SPECIFIERS_SOFT];
+	NSMutableArray* result = [NSMutableArray arrayWithCapacity:(NSUInteger)MAX(count, 0)];
+	for(int i = 0; i < count; i++)
+	{
+		NSString* specifier = [ALWrapper getString:device attribute:ALC_HRTF_SPECIFIER_SOFT index:i];
+		if(nil != specifier)
+		{
+			[result addObject:specifier];
+		}
+	}
+	return result;
+}
+
+- (bool) hrtfEnabled
+{
+	if(!self.hrtfSupported)
+	{
+		return NO;
+	}
+	return ALC_TRUE == [ALWrapper getInteger:device attribute:ALC_HRTF_SOFT];
+}
+
+- (int) hrtfStatus
+{
+	if(!self.hrtfSupported)
+	{
+		return ALC_HRTF_DISABLED_SOFT;
+	}
+	return [ALWrapper getInteger:device attribute:ALC_HRTF_STATUS_SOFT];
+}
+
+- (NSString*) hrtfSpecifier
+{
+	if(!self.hrtfEnabled)
+	{
+		return nil;
+	}
+	return [ALWrapper getString:device attribute:ALC_HRTF_SPECIFIER_SOFT];
+}
+
+
+#pragma mark Clock
+
+- (void) getDeviceClock:(int64_t*) clock latency:(int64_t*) latencyOut
+{
+	ALint64SOFT_OAL values[2];
+	if([ALWrapper getInteger64v:device attribute:ALC_DEVICE_CLOCK_LATENCY_SOFT size:2 data:values])
+	{
+		*clock = values[0];
+		*latencyOut = values[1];
+		return;
+	}
+	*clock = self.deviceClock;
+	*latencyOut = self.latency;
+}
+
+
+#pragma mark HRTF
+
+- (NSArray*) hrtfAttributesWithMode:(int) mode specifier:(NSString*) specifier
+{
+	NSMutableArray* result = [NSMutableArray arrayWithObjects:
+							  [NSNumber numberWithInt:ALC_HRTF_SOFT],
+							  [NSNumber numberWithInt:mode],
+							  nil];
+	if(nil != specifier)
+	{
+		NSUInteger index = [self.hrtfSpecifiers indexOfObject:specifier];
+		if(NSNotFound == index)
+		{
+			OAL_LOG_WARNING(@"%@: No HRTF dataset named %@. Using the default", self, specifier);
+		}
+		else
+		{
+			[result addObject:[NSNumber numberWithInt:ALC_HRTF_ID_SOFT]];
+			[result addObject:[NSNumber numberWithInt:(int)index]];
+		}
+	}
+	return result;
+}
+
+- (bool) resetWithAttributes:(NSArray*) attributes
+{
+	if(self.suspended)
+	{
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return NO;
+	}
+
+	attributes = [self contextAttributes:attributes];
+
+	// Zero terminated, as alcResetDeviceSOFT expects.
+	ALCint* attributesList = (ALCint*)malloc(sizeof(ALCint) * ([attributes count] + 1));
+	ALCint* attributePtr = attributesList;
+	for(NSNumber* number in attributes)
+	{
+		*attributePtr++ = [number intValue];
+	}
+	*attributePtr = 0;
+
+	bool result = [ALWrapper resetDevice:device attributes:attributesList];
+	free(attributesList);
+	if(!result)
+	{
+		OAL_LOG_ERROR(@"%@: Failed to reset device with attributes %@", self, attributes);
+		return NO;
+	}
+
+	OPTIONALLY_SYNCHRONIZED(contexts)
+	{
+		for(ALContext* context in contexts)
+		{
+			[context notifyDeviceReset];
+		}
+	}
+	return YES;
+}
+
+- (bool) setHRTFMode:(int) mode specifier:(NSString*) specifier
+{
+	// Attributes left out of a reset go back to their defaults, so keep the mixing frequency.
+	NSMutableArray* attributes = [NSMutableArray arrayWithObjects:
+								  [NSNumber numberWithInt:ALC_FREQUENCY],
+								  [NSNumber numberWithInt:self.frequency],
+								  nil];
+	[attributes addObjectsFromArray:[self hrtfAttributesWithMode:mode specifier:specifier]];
+	return [self resetWithAttributes:attributes];
+}
+
+
 #pragma mark Suspend Handler
 
 - (void) addSuspendListener:(id<OALSuspendListener>) listener
@@ -158,6 +609,176 @@ initFailed:
 }
 
 
+#pragma mark Loopback Rendering
+
+- (bool) renderSamples:(void*) buffer frames:(int) frames
+{
+	if(!loopback)
+	{
+		OAL_LOG_ERROR(@"%@: Only loopback devices can render samples", self);
+		return NO;
+	}
+
+	uint8_t* output = buffer;
+	while(frames > 0)
+	{
+		int chunk = frames;
+		if(OAL_ATOMIC_LOAD(&pendingScheduledStarts) > 0)
+		{
+			// Stop this mix short at the next start, so that it lands on its sample.
+			// (0 if another one was scheduled for now meanwhile. It starts next time round.)
+			int64_t nextStart = [self startDueScheduledSources];
+			if(nextStart - renderedFrames < chunk)
+			{
+				chunk = (int)MAX(nextStart - renderedFrames, 0);
+			}
+		}
+
+		if(chunk > 0 && ![ALWrapper renderSamples:device buffer:output frames:chunk])
+		{
+			return NO;
+		}
+		renderedFrames += chunk;
+		output += (size_t)chunk * (size_t)frameSize;
+		frames -= chunk;
+	}
+	return YES;
+}
+
+- (int64_t) startDueScheduledSources
+{
+	NSArray* contextsNow = nil;
+	OPTIONALLY_SYNCHRONIZED(contexts)
+	{
+		contextsNow = [NSArray arrayWithArray:contexts];
+	}
+
+	int64_t nextStart = INT64_MAX;
+	for(ALContext* context in contextsNow)
+	{
+		[context startScheduledSourcesAtSampleTime:renderedFrames];
+		nextStart = MIN(nextStart, [context nextScheduledSampleTime]);
+	}
+	return nextStart;
+}
+
+- (bool) renderToWAVFile:(NSString*) path duration:(float) duration
+{
+	if(!loopback)
+	{
+		OAL_LOG_ERROR(@"%@: Only loopback devices can render to a file", self);
+		return NO;
+	}
+	if(self.suspended)
+	{
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return NO;
+	}
+	if(nil != path && !wavSupportsType(sampleType))
+	{
+		OAL_LOG_ERROR(@"%@: WAV files can't hold samples of type 0x%x", self, sampleType);
+		return NO;
+	}
+
+	int64_t totalFrames = (int64_t)((double)duration * loopbackFrequency + 0.5);
+	if(totalFrames > (int64_t)((UINT32_MAX - kALWAVHeaderSize) / (uint32_t)frameSize))
+	{
+		OAL_LOG_ERROR(@"%@: %f seconds is too long for a WAV file", self, duration);
+		return NO;
+	}
+
+	FILE* file = NULL;
+	if(nil != path)
+	{
+		file = fopen([path fileSystemRepresentation], "wb");
+		if(NULL == file || !writeWAVHeader(file, self.channelCount, sampleType, loopbackFrequency, 0))
+		{
+			OAL_LOG_ERROR(@"%@: Could not write to %@", self, path);
+			if(NULL != file)
+			{
+				fclose(file);
+			}
+			return NO;
+		}
+	}
+
+	// Run actions on a clock that only moves as samples get mixed.
+	OALActionManager* actionManager = [OALActionManager sharedInstance];
+	OALActionScheduling oldScheduling = actionManager.scheduling;
+	OALClockSource oldClockSource = OALClockGetSource();
+	OALClockSetSource(kOALClockSourceVirtual);
+	actionManager.scheduling = OALActionSchedulingManual;
+
+	uint8_t samples[kALOfflineRenderFrames * kALMaxFrameSize];
+	double secondsPerFrame = 1.0 / loopbackFrequency;
+	double startTime = OALClockMonotonicSeconds();
+	uint64_t checksum = 0xcbf29ce484222325ULL;
+	bool result = YES;
+
+	// Whatever happens in the actions and callbacks run from here, put the
+	// clock and the action manager back the way they were.
+	@try
+	{
+		for(int64_t framesDone = 0; framesDone < totalFrames && result; )
+		{
+			int frames = (int)MIN(totalFrames - framesDone, kALOfflineRenderFrames);
+
+			// Do what the action manager and control thread would have done by now.
+			[actionManager stepWithClock];
+			NSArray* contextsNow = nil;
+			OPTIONALLY_SYNCHRONIZED(contexts)
+			{
+				contextsNow = [NSArray arrayWithArray:contexts];
+			}
+			for(ALContext* context in contextsNow)
+			{
+				[context updateCulling];
+				[context updateOcclusion];
+				[context updateLoopPoints];
+				[context commitDeferredUpdates];
+			}
+
+			result = [self renderSamples:samples frames:frames];
+			if(result)
+			{
+				checksum = hashBytes(checksum, samples, (size_t)frames * (size_t)frameSize);
+			}
+			if(result && NULL != file)
+			{
+				result = (size_t)frames == fwrite(samples, (size_t)frameSize, (size_t)frames, file);
+			}
+
+			framesDone += frames;
+			OALClockAdvanceVirtualTime(frames * secondsPerFrame);
+		}
+	}
+	@finally
+	{
+		lastRenderTime = OALClockMonotonicSeconds() - startTime;
+		lastRenderChecksum = checksum;
+
+		actionManager.scheduling = oldScheduling;
+		OALClockSetSource(oldClockSource);
+
+		if(NULL != file)
+		{
+			// Now that the length is known, go back and fill it in.
+			result = result && writeWAVHeader(file, self.channelCount, sampleType, loopbackFrequency, (uint32_t)totalFrames);
+			result = (0 == fclose(file)) && result;
+		}
+	}
+
+	if(!result)
+	{
+		OAL_LOG_ERROR(@"%@: Failed to render to %@", self, path);
+		return NO;
+	}
+
+	OAL_LOG_DEBUG(@"%@: Rendered %f seconds in %f seconds", self, duration, lastRenderTime);
+	return YES;
+}
+
+
 #pragma mark Utility
 
 - (void) clearBuffers
@@ -194,4 +815,39 @@ initFailed:
 	}
 }
 
+- (NSArray*) contextAttributes:(NSArray*) attributes
+{
+	if(!loopback)
+	{
+		return attributes;
+	}
+
+	// The device decides the mixing format, so leave out any the caller asked for.
+	NSMutableArray* result = [NSMutableArray arrayWithObjects:
+							  [NSNumber numberWithInt:ALC_FORMAT_CHANNELS_SOFT],
+							  [NSNumber numberWithInt:channelLayout],
+							  [NSNumber numberWithInt:ALC_FORMAT_TYPE_SOFT],
+							  [NSNumber numberWithInt:sampleType],
+							  [NSNumber numberWithInt:ALC_FREQUENCY],
+							  [NSNumber numberWithInt:loopbackFrequency],
+							  nil];
+	for(NSUInteger i = 0; i + 1 < [attributes count]; i += 2)
+	{
+		int attribute = [[attributes objectAtIndex:i] intValue];
+		if(ALC_FORMAT_CHANNELS_SOFT != attribute
+		   && ALC_FORMAT_TYPE_SOFT != attribute
+		   && ALC_FREQUENCY != attribute)
+		{
+			[result addObject:[attributes objectAtIndex:i]];
+			[result addObject:[attributes objectAtIndex:i + 1]];
+		}
+	}
+	return result;
+}
+
+- (void) notifyScheduledStartsChanged:(int32_t) delta
+{
+	OAL_ATOMIC_ADD(&pendingScheduledStarts, delta);
+}
+
 @end
@@ -0,0 +1,195 @@
+//
+//  ALEffects.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALWrapper.h"
+#import "OALLock.h"
+
+@class ALContext;
+
+
+#pragma mark ALEffects
+
+/**
+ * Effects for a context, using the EFX extension (ALC_EXT_EFX) as found in
+ * OpenAL Soft. <br>
+ *
+ * Auxiliary effect slots and filters are kept in pools: They are generated
+ * the first time they are needed, and handed out again once released, so
+ * changing an effect or filter parameter never creates OpenAL objects. <br>
+ *
+ * The reverb uses a single reverb effect loaded into a pooled effect slot,
+ * with presets matching ALListener's room types, so that the listener and
+ * source reverb properties behave the same when Apple's ASA extension is not
+ * available. <br>
+ *
+ * Only valid when this object's context is the current context.
+ */
+@interface ALEffects : NSObject
+{
+	/** The context these effects belong to (weak reference). */
+	ALContext* context;
+
+	/** Every effect slot generated so far. */
+	ALuint* slots;
+	/** Number of effect slots generated so far. */
+	NSUInteger slotCount;
+	/** Capacity of the slots and freeSlots arrays. */
+	NSUInteger slotCapacity;
+	/** Effect slots that are not in use. */
+	ALuint* freeSlots;
+	/** Number of effect slots that are not in use. */
+	NSUInteger freeSlotCount;
+
+	/** Every filter generated so far. */
+	ALuint* filters;
+	/** Number of filters generated so far. */
+	NSUInteger filterCount;
+	/** Capacity of the filters and freeFilters arrays. */
+	NSUInteger filterCapacity;
+	/** Filters that are not in use. */
+	ALuint* freeFilters;
+	/** Number of filters that are not in use. */
+	NSUInteger freeFilterCount;
+
+	/** The reverb effect (AL_EFFECT_NULL until reverb is first used). */
+	ALuint reverbEffect;
+	/** The effect slot the reverb plays through (AL_EFFECTSLOT_NULL until reverb is first used). */
+	ALuint reverbSlot;
+
+	bool reverbOn;
+	float reverbLevel;
+	int reverbRoomType;
+	float reverbEQGain;
+	float reverbEQBandwidth;
+	float reverbEQFrequency;
+
+	/** Protects these effects (see OBJECTAL_CFG_LOCK_POLICY). */
+	OALLock lock;
+}
+
+
+#pragma mark Properties
+
+/** If true, the EFX extension is available and these effects do something. */
+@property(nonatomic,readonly,assign) bool supported;
+
+/** The maximum number of auxiliary sends per source on this context's device. */
+@property(nonatomic,readonly,assign) int maxAuxiliarySends;
+
+/** The effect slot that reverb plays through. Connect a source's auxiliary
+ * send to this slot to make it reverberate.
+ * Returns AL_EFFECTSLOT_NULL if EFX is not supported.
+ */
+@property(nonatomic,readonly,assign) ALuint reverbSlot;
+
+/** Turns on reverb. <br>
+ * Default value: NO
+ */
+@property(nonatomic,readwrite,assign) bool reverbOn;
+
+/** The overall reverb level (from -40.0db to 40.0db).
+ * EFX can't amplify, so anything above 0db is played at 0db. <br>
+ * Default value: 0.0
+ */
+@property(nonatomic,readwrite,assign) float reverbLevel;
+
+/** The room type to simulate (one of the ALC_ASA_REVERB_ROOM_TYPE_XYZ values). <br>
+ * Default value: ALC_ASA_REVERB_ROOM_TYPE_MediumRoom
+ */
+@property(nonatomic,readwrite,assign) int reverbRoomType;
+
+/** The equalizer gain for reverb (in db).
+ * EFX's standard reverb has no equalizer, so this scales the reverb's high
+ * frequency gain instead. <br>
+ * Default value: 0.0
+ */
+@property(nonatomic,readwrite,assign) float reverbEQGain;
+
+/** The equalizer bandwidth for reverb.
+ * Kept for compatibility with ALListener only; EFX's standard reverb has no equivalent.
+ */
+@property(nonatomic,readwrite,assign) float reverbEQBandwidth;
+
+/** The equalizer frequency for reverb.
+ * Kept for compatibility with ALListener only; EFX's standard reverb has no equivalent.
+ */
+@property(nonatomic,readwrite,assign) float reverbEQFrequency;
+
+
+#pragma mark Object Management
+
+/** \cond */
+/** (INTERNAL USE) Create the effects for a context.
+ * Use ALContext.effects to get a context's effects.
+ *
+ * @param context The context the effects belong to.
+ * @return The initialized effects.
+ */
+- (id) initWithContext:(ALContext*) context;
+/** \endcond */
+
+
+#pragma mark Pools
+
+/** Get an unused auxiliary effect slot from the pool.
+ * There are only a few effect slots per context, so release it when done.
+ *
+ * @return An effect slot, or AL_EFFECTSLOT_NULL if none are available.
+ */
+- (ALuint) acquireEffectSlot;
+
+/** Return an effect slot to the pool. Its effect is removed and its gain reset.
+ *
+ * @param slot The effect slot to return.
+ */
+- (void) releaseEffectSlot:(ALuint) slot;
+
+/** Get an unused filter from the pool. The filter's type and parameters are
+ * whatever the last user left them at.
+ *
+ * @return A filter, or AL_FILTER_NULL if none could be generated.
+ */
+- (ALuint) acquireFilter;
+
+/** Return a filter to the pool.
+ *
+ * @param filter The filter to return.
+ */
+- (void) releaseFilter:(ALuint) filter;
+
+
+#pragma mark Internal Use
+
+/** \cond */
+/** (INTERNAL USE) Used by ALContext to delete all OpenAL objects before the
+ * context is destroyed. The context must be current.
+ */
+- (void) close;
+/** \endcond */
+
+@end
@@ -0,0 +1,500 @@
+//
+//  ALEffects.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALEffects.h"
+#import "ALContext.h"
+#import "ALDevice.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+
+
+/** Number of pool entries to grow by when a pool runs out. */
+#define kALEffectsPoolGrowth 8
+
+
+/** Standard reverb parameters, taken from OpenAL Soft's efx-presets.h. */
+typedef struct
+{
+	float density;
+	float diffusion;
+	float gain;
+	float gainHF;
+	float decayTime;
+	float decayHFRatio;
+	float reflectionsGain;
+	float reflectionsDelay;
+	float lateReverbGain;
+	float lateReverbDelay;
+	float airAbsorptionGainHF;
+	float roomRolloffFactor;
+	int decayHFLimit;
+} ALReverbPreset;
+
+/** Reverb presets, indexed by ASA room type (ALC_ASA_REVERB_ROOM_TYPE_XYZ).
+ * ASA's rooms are its own, so each gets the closest sounding EFX preset.
+ */
+static const ALReverbPreset kALReverbPresets[] =
+{
+	/* SmallRoom: EFX_REVERB_PRESET_ROOM */
+	{0.4287f, 1.0f, 0.3162f, 0.5929f, 0.40f, 0.83f, 0.1503f, 0.002f, 1.0629f, 0.003f, 0.9943f, 0.0f, 1},
+	/* MediumRoom: EFX_REVERB_PRESET_GENERIC */
+	{1.0f, 1.0f, 0.3162f, 0.8913f, 1.49f, 0.83f, 0.0500f, 0.007f, 1.2589f, 0.011f, 0.9943f, 0.0f, 1},
+	/* LargeRoom: EFX_REVERB_PRESET_STONEROOM */
+	{1.0f, 1.0f, 0.3162f, 0.7079f, 2.31f, 0.64f, 0.4411f, 0.012f, 1.1003f, 0.017f, 0.9943f, 0.0f, 1},
+	/* MediumHall: EFX_REVERB_PRESET_CONCERTHALL */
+	{1.0f, 1.0f, 0.3162f, 0.5623f, 3.92f, 0.70f, 0.2427f, 0.020f, 0.9977f, 0.029f, 0.9943f, 0.0f, 1},
+	/* LargeHall: EFX_REVERB_PRESET_AUDITORIUM */
+	{1.0f, 1.0f, 0.3162f, 0.5781f, 4.32f, 0.59f, 0.4032f, 0.020f, 0.7170f, 0.030f, 0.9943f, 0.0f, 1},
+	/* Plate: EFX_REVERB_PRESET_BATHROOM */
+	{0.1715f, 1.0f, 0.3162f, 0.2512f, 1.49f, 0.54f, 0.6531f, 0.007f, 3.2734f, 0.011f, 0.9943f, 0.0f, 1},
+	/* MediumChamber: EFX_REVERB_PRESET_HALLWAY */
+	{0.3645f, 1.0f, 0.3162f, 0.7079f, 1.49f, 0.59f, 0.2458f, 0.007f, 1.6615f, 0.011f, 0.9943f, 0.0f, 1},
+	/* LargeChamber: EFX_REVERB_PRESET_CAVE */
+	{1.0f, 1.0f, 0.3162f, 1.0000f, 2.91f, 1.30f, 0.5000f, 0.015f, 0.7063f, 0.022f, 0.9943f, 0.0f, 0},
+	/* Cathedral: EFX_REVERB_PRESET_ARENA */
+	{1.0f, 1.0f, 0.3162f, 0.4477f, 7.24f, 0.33f, 0.2612f, 0.020f, 1.0186f, 0.030f, 0.9943f, 0.0f, 1},
+	/* LargeRoom2: EFX_REVERB_PRESET_STONEROOM */
+	{1.0f, 1.0f, 0.3162f, 0.7079f, 2.31f, 0.64f, 0.4411f, 0.012f, 1.1003f, 0.017f, 0.9943f, 0.0f, 1},
+	/* MediumHall2: EFX_REVERB_PRESET_CONCERTHALL */
+	{1.0f, 1.0f, 0.3162f, 0.5623f, 3.92f, 0.70f, 0.2427f, 0.020f, 0.9977f, 0.029f, 0.9943f, 0.0f, 1},
+	/* MediumHall3: EFX_REVERB_PRESET_CHAPEL */
+	{1.0f, 0.84f, 0.3162f, 0.5623f, 4.62f, 0.64f, 0.4467f, 0.032f, 0.7943f, 0.049f, 0.9943f, 0.0f, 1},
+	/* LargeHall2: EFX_REVERB_PRESET_HANGAR */
+	{1.0f, 1.0f, 0.3162f, 0.3162f, 10.05f, 0.23f, 0.5000f, 0.020f, 1.2560f, 0.030f, 0.9943f, 0.0f, 1},
+};
+
+#define kALReverbPresetCount ((int)(sizeof(kALReverbPresets) / sizeof(*kALReverbPresets)))
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for ALEffects.
+ */
+@interface ALEffects (Private)
+
+/** (INTERNAL USE) Create the reverb effect and get its effect slot, if that
+ * hasn't been done yet. Call only with the lock held.
+ *
+ * @return TRUE if reverb is ready to use.
+ */
+- (bool) prepareReverb;
+
+/** (INTERNAL USE) Load the current room type and EQ gain into the reverb effect,
+ * and reattach it so the effect slot picks up the change. Call only with the lock held.
+ */
+- (void) loadReverbPreset;
+
+/** (INTERNAL USE) Attach the reverb effect to its slot, or detach it when reverb
+ * is off. Call only with the lock held.
+ */
+- (void) attachReverb;
+
+/** (INTERNAL USE) Set the reverb slot's gain from the reverb level. Call only with the lock held.
+ */
+- (void) applyReverbLevel;
+
+@end
+/** \endcond */
+
+
+@implementation ALEffects
+
+#pragma mark Object Management
+
+- (id) initWithContext:(ALContext*) contextIn
+{
+	if(nil != (self = [super init]))
+	{
+		OALLockInit(&lock);
+		context = contextIn;
+		reverbEffect = AL_EFFECT_NULL;
+		reverbSlot = AL_EFFECTSLOT_NULL;
+		reverbRoomType = ALC_ASA_REVERB_ROOM_TYPE_MediumRoom;
+
+		if(![ALWrapper efxSupported] && ![ALWrapper asaSupported])
+		{
+			OAL_LOG_WARNING(@"%@: Neither EFX nor ASA is available. Reverb and filters will be ignored.", self);
+		}
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	if(0 != slotCount + filterCount)
+	{
+		OAL_LOG_WARNING(@"%@: Deallocated without being closed. Leaking %lu OpenAL objects", self,
+						(unsigned long)(slotCount + filterCount));
+	}
+	free(slots);
+	free(freeSlots);
+	free(filters);
+	free(freeFilters);
+	OALLockDestroy(&lock);
+	as_superdealloc();
+}
+
+- (void) close
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		for(NSUInteger i = 0; i < slotCount; i++)
+		{
+			[ALWrapper deleteAuxiliaryEffectSlot:slots[i]];
+		}
+		slotCount = freeSlotCount = 0;
+		reverbSlot = AL_EFFECTSLOT_NULL;
+
+		for(NSUInteger i = 0; i < filterCount; i++)
+		{
+			[ALWrapper deleteFilter:filters[i]];
+		}
+		filterCount = freeFilterCount = 0;
+
+		if(AL_EFFECT_NULL != reverbEffect)
+		{
+			[ALWrapper deleteEffect:reverbEffect];
+			reverbEffect = AL_EFFECT_NULL;
+		}
+	}
+}
+
+
+#pragma mark Properties
+
+- (bool) supported
+{
+	return [ALWrapper efxSupported];
+}
+
+- (int) maxAuxiliarySends
+{
+	if(![ALWrapper efxSupported])
+	{
+		return 0;
+	}
+	return [ALWrapper getInteger:context.device.device attribute:ALC_MAX_AUXILIARY_SENDS];
+}
+
+- (ALuint) reverbSlot
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[self prepareReverb];
+		return reverbSlot;
+	}
+}
+
+- (bool) reverbOn
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return reverbOn;
+	}
+}
+
+- (void) setReverbOn:(bool) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		reverbOn = value;
+		if([self prepareReverb])
+		{
+			[self attachReverb];
+		}
+	}
+}
+
+- (float) reverbLevel
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return reverbLevel;
+	}
+}
+
+- (void) setReverbLevel:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		reverbLevel = value;
+		if(AL_EFFECTSLOT_NULL != reverbSlot)
+		{
+			[self applyReverbLevel];
+		}
+	}
+}
+
+- (int) reverbRoomType
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return reverbRoomType;
+	}
+}
+
+- (void) setReverbRoomType:(int) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(value < 0 || value >= kALReverbPresetCount)
+		{
+			OAL_LOG_ERROR(@"%@: Unknown reverb room type %d", self, value);
+			return;
+		}
+		reverbRoomType = value;
+		if(AL_EFFECT_NULL != reverbEffect)
+		{
+			[self loadReverbPreset];
+		}
+	}
+}
+
+- (float) reverbEQGain
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return reverbEQGain;
+	}
+}
+
+- (void) setReverbEQGain:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		reverbEQGain = value;
+		if(AL_EFFECT_NULL != reverbEffect)
+		{
+			[self loadReverbPreset];
+		}
+	}
+}
+
+- (float) reverbEQBandwidth
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return reverbEQBandwidth;
+	}
+}
+
+- (void) setReverbEQBandwidth:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		reverbEQBandwidth = value;
+	}
+}
+
+- (float) reverbEQFrequency
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return reverbEQFrequency;
+	}
+}
+
+- (void) setReverbEQFrequency:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		reverbEQFrequency = value;
+	}
+}
+
+
+#pragma mark Pools
+
+- (ALuint) acquireEffectSlot
+{
+	if(![ALWrapper efxSupported])
+	{
+		return AL_EFFECTSLOT_NULL;
+	}
+
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(freeSlotCount > 0)
+		{
+			return freeSlots[--freeSlotCount];
+		}
+
+		ALuint slot = [ALWrapper genAuxiliaryEffectSlot];
+		if((ALuint)AL_INVALID == slot)
+		{
+			OAL_LOG_ERROR(@"%@: No more effect slots available (%lu in use)", self, (unsigned long)slotCount);
+			return AL_EFFECTSLOT_NULL;
+		}
+		if(slotCount == slotCapacity)
+		{
+			slotCapacity += kALEffectsPoolGrowth;
+			slots = realloc(slots, sizeof(*slots) * slotCapacity);
+			freeSlots = realloc(freeSlots, sizeof(*freeSlots) * slotCapacity);
+		}
+		slots[slotCount++] = slot;
+		return slot;
+	}
+}
+
+- (void) releaseEffectSlot:(ALuint) slot
+{
+	if(AL_EFFECTSLOT_NULL == slot)
+	{
+		return;
+	}
+
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[ALWrapper auxiliaryEffectSloti:slot parameter:AL_EFFECTSLOT_EFFECT value:AL_EFFECT_NULL];
+		[ALWrapper auxiliaryEffectSlotf:slot parameter:AL_EFFECTSLOT_GAIN value:1.0f];
+		freeSlots[freeSlotCount++] = slot;
+	}
+}
+
+- (ALuint) acquireFilter
+{
+	if(![ALWrapper efxSupported])
+	{
+		return AL_FILTER_NULL;
+	}
+
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(freeFilterCount > 0)
+		{
+			return freeFilters[--freeFilterCount];
+		}
+
+		ALuint filter = [ALWrapper genFilter];
+		if((ALuint)AL_INVALID == filter)
+		{
+			OAL_LOG_ERROR(@"%@: Could not generate filter", self);
+			return AL_FILTER_NULL;
+		}
+		if(filterCount == filterCapacity)
+		{
+			filterCapacity += kALEffectsPoolGrowth;
+			filters = realloc(filters, sizeof(*filters) * filterCapacity);
+			freeFilters = realloc(freeFilters, sizeof(*freeFilters) * filterCapacity);
+		}
+		filters[filterCount++] = filter;
+		return filter;
+	}
+}
+
+- (void) releaseFilter:(ALuint) filter
+{
+	if(AL_FILTER_NULL == filter)
+	{
+		return;
+	}
+
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		freeFilters[freeFilterCount++] = filter;
+	}
+}
+
+
+#pragma mark Reverb
+
+- (bool) prepareReverb
+{
+	if(AL_EFFECTSLOT_NULL != reverbSlot)
+	{
+		return true;
+	}
+	if(![ALWrapper efxSupported])
+	{
+		return false;
+	}
+
+	if(AL_EFFECT_NULL == reverbEffect)
+	{
+		reverbEffect = [ALWrapper genEffect];
+		if((ALuint)AL_INVALID == reverbEffect)
+		{
+			OAL_LOG_ERROR(@"%@: Could not generate reverb effect", self);
+			reverbEffect = AL_EFFECT_NULL;
+			return false;
+		}
+		[ALWrapper effecti:reverbEffect parameter:AL_EFFECT_TYPE value:AL_EFFECT_REVERB];
+	}
+
+	reverbSlot = [self acquireEffectSlot];
+	if(AL_EFFECTSLOT_NULL == reverbSlot)
+	{
+		return false;
+	}
+	[self applyReverbLevel];
+	[self loadReverbPreset];
+	return true;
+}
+
+- (void) loadReverbPreset
+{
+	const ALReverbPreset* preset = &kALReverbPresets[reverbRoomType];
+	float gainHF = preset->gainHF * powf(10.0f, reverbEQGain / 20.0f);
+
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_DENSITY value:preset->density];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_DIFFUSION value:preset->diffusion];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_GAIN value:preset->gain];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_GAINHF value:MIN(gainHF, 1.0f)];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_DECAY_TIME value:preset->decayTime];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_DECAY_HFRATIO value:preset->decayHFRatio];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_REFLECTIONS_GAIN value:preset->reflectionsGain];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_REFLECTIONS_DELAY value:preset->reflectionsDelay];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_LATE_REVERB_GAIN value:preset->lateReverbGain];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_LATE_REVERB_DELAY value:preset->lateReverbDelay];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_AIR_ABSORPTION_GAINHF value:preset->airAbsorptionGainHF];
+	[ALWrapper effectf:reverbEffect parameter:AL_REVERB_ROOM_ROLLOFF_FACTOR value:preset->roomRolloffFactor];
+	[ALWrapper effecti:reverbEffect parameter:AL_REVERB_DECAY_HFLIMIT value:preset->decayHFLimit];
+
+	// A slot copies its effect's parameters when the effect is attached.
+	if(AL_EFFECTSLOT_NULL != reverbSlot)
+	{
+		[self attachReverb];
+	}
+}
+
+- (void) attachReverb
+{
+	[ALWrapper auxiliaryEffectSloti:reverbSlot
+						  parameter:AL_EFFECTSLOT_EFFECT
+							  value:reverbOn ? (ALint)reverbEffect : AL_EFFECT_NULL];
+}
+
+- (void) applyReverbLevel
+{
+	float slotGain = powf(10.0f, reverbLevel / 20.0f);
+	[ALWrapper auxiliaryEffectSlotf:reverbSlot parameter:AL_EFFECTSLOT_GAIN value:MIN(slotGain, 1.0f)];
+}
+
+@end
@@ -30,6 +30,7 @@
 #import <Foundation/Foundation.h>
 #import "ALTypes.h"
 #import "OALSuspendHandler.h"
+#import "OALLock.h"
 
 @class ALContext;
 
@@ -49,6 +50,9 @@
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
+
+	/** Protects this listener (see OBJECTAL_CFG_LOCK_POLICY). */
+	OALLock lock;
 }
 
 
@@ -83,6 +87,9 @@
 @property(nonatomic,readwrite,assign) ALVector velocity;
 
 /** Turns on reverb. (iOS 5.0+)
+ *
+ * The reverb properties use Apple's ASA extension where it is available,
+ * and the context's EFX reverb (see ALEffects) everywhere else.
  */
 @property(nonatomic,readwrite,assign) bool reverbOn;
 
@@ -56,6 +56,7 @@
 {
 	if(nil != (self = [super init]))
 	{
+		OALLockInit(&lock);
         if(contextIn == nil)
         {
             OAL_LOG_ERROR(@"%@: Could not init listener: Context is nil", self);
@@ -76,6 +77,7 @@ initFailed:
 - (void) dealloc
 {
 	as_release(suspendHandler);
+	OALLockDestroy(&lock);
 	as_superdealloc();
 }
 
@@ -90,7 +92,7 @@ initFailed:
 
 - (void) setMuted:(bool) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -111,7 +113,7 @@ initFailed:
 
 - (void) setGain:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -131,7 +133,7 @@ initFailed:
 - (ALOrientation) orientation
 {
 	ALOrientation result;
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		[ALWrapper getListenerfv:AL_ORIENTATION values:(float*)&result];
 	}
@@ -140,7 +142,7 @@ initFailed:
 
 - (void) setOrientation:(ALOrientation) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -155,7 +157,7 @@ initFailed:
 - (ALPoint) position
 {
 	ALPoint result;
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		[ALWrapper getListener3f:AL_POSITION v1:&result.x v2:&result.y v3:&result.z];
 	}
@@ -164,7 +166,7 @@ initFailed:
 
 - (void) setPosition:(ALPoint) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -179,7 +181,7 @@ initFailed:
 - (ALVector) velocity
 {
 	ALVector result;
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		[ALWrapper getListener3f:AL_VELOCITY v1:&result.x v2:&result.y v3:&result.z];
 	}
@@ -188,7 +190,7 @@ initFailed:
 
 - (void) setVelocity:(ALVector) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -202,15 +204,19 @@ initFailed:
 
 - (bool) reverbOn
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        return [ALWrapper asaGetListenerb:ALC_ASA_REVERB_ON];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetListenerb:ALC_ASA_REVERB_ON];
+		}
+		return context.effects.reverbOn;
 	}
 }
 
 - (void) setReverbOn:(bool) reverbOn
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -218,21 +224,32 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaListenerb:ALC_ASA_REVERB_ON value:reverbOn];
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaListenerb:ALC_ASA_REVERB_ON value:reverbOn];
+		}
+		else
+		{
+			context.effects.reverbOn = reverbOn;
+		}
 	}
 }
 
 - (float) globalReverbLevel
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_GLOBAL_LEVEL];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_GLOBAL_LEVEL];
+		}
+		return context.effects.reverbLevel;
 	}
 }
 
 - (void) setGlobalReverbLevel:(float) globalReverbLevel
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -240,21 +257,32 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaListenerf:ALC_ASA_REVERB_GLOBAL_LEVEL value:globalReverbLevel];
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaListenerf:ALC_ASA_REVERB_GLOBAL_LEVEL value:globalReverbLevel];
+		}
+		else
+		{
+			context.effects.reverbLevel = globalReverbLevel;
+		}
 	}
 }
 
 - (int) reverbRoomType
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        return [ALWrapper asaGetListeneri:ALC_ASA_REVERB_ROOM_TYPE];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetListeneri:ALC_ASA_REVERB_ROOM_TYPE];
+		}
+		return context.effects.reverbRoomType;
 	}
 }
 
 - (void) setReverbRoomType:(int) reverbRoomType
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -262,21 +290,32 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaListeneri:ALC_ASA_REVERB_ROOM_TYPE value:reverbRoomType];
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaListeneri:ALC_ASA_REVERB_ROOM_TYPE value:reverbRoomType];
+		}
+		else
+		{
+			context.effects.reverbRoomType = reverbRoomType;
+		}
 	}
 }
 
 - (float) reverbEQGain
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_EQ_GAIN];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_EQ_GAIN];
+		}
+		return context.effects.reverbEQGain;
 	}
 }
 
 - (void) setReverbEQGain:(float) reverbEQGain
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -284,21 +323,32 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaListenerf:ALC_ASA_REVERB_EQ_GAIN value:reverbEQGain];
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaListenerf:ALC_ASA_REVERB_EQ_GAIN value:reverbEQGain];
+		}
+		else
+		{
+			context.effects.reverbEQGain = reverbEQGain;
+		}
 	}
 }
 
 - (float) reverbEQBandwidth
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_EQ_BANDWITH];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_EQ_BANDWITH];
+		}
+		return context.effects.reverbEQBandwidth;
 	}
 }
 
 - (void) setReverbEQBandwidth:(float) reverbEQBandwidth
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -306,21 +356,32 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaListenerf:ALC_ASA_REVERB_EQ_BANDWITH value:reverbEQBandwidth];
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaListenerf:ALC_ASA_REVERB_EQ_BANDWITH value:reverbEQBandwidth];
+		}
+		else
+		{
+			context.effects.reverbEQBandwidth = reverbEQBandwidth;
+		}
 	}
 }
 
 - (float) reverbEQFrequency
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_EQ_FREQ];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetListenerf:ALC_ASA_REVERB_EQ_FREQ];
+		}
+		return context.effects.reverbEQFrequency;
 	}
 }
 
 - (void) setReverbEQFrequency:(float) reverbEQFrequency
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -328,7 +389,14 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaListenerf:ALC_ASA_REVERB_EQ_FREQ value:reverbEQFrequency];
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaListenerf:ALC_ASA_REVERB_EQ_FREQ value:reverbEQFrequency];
+		}
+		else
+		{
+			context.effects.reverbEQFrequency = reverbEQFrequency;
+		}
 	}
 }
 
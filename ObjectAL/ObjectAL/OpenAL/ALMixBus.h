@@ -0,0 +1,195 @@
+//
+//  ALMixBus.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "OALAction.h"
+#import "OALLock.h"
+
+@class ALSource;
+
+
+#pragma mark ALMixBus
+
+/**
+ * A node in a tree of mixing buses (master -> category -> channel -> voice). <br>
+ *
+ * Each bus holds a gain, a pitch multiplier and a mute switch. The effective
+ * values of a bus are its own values combined with those of all of its
+ * parents. Sources (voices) attached to a bus have their own gain and pitch
+ * scaled by the bus's effective values. <br>
+ *
+ * Changing a bus marks it and its subtree dirty, and only the voices below it
+ * get their OpenAL parameters recomputed. Fading a bus is a single action, no
+ * matter how many voices are attached.
+ */
+@interface ALMixBus : NSObject
+{
+	/** The bus this bus feeds into (nil for a master bus). */
+	ALMixBus* parent;
+	/** Buses feeding into this one (weak references). */
+	NSMutableArray* children;
+	/** Sources attached to this bus (weak references). */
+	NSMutableArray* voices;
+	NSString* name;
+
+	float gain;
+	float pitch;
+	bool muted;
+
+	/** Cached gain, combined with all parents. */
+	float effectiveGain;
+	/** Cached pitch multiplier, combined with all parents. */
+	float effectivePitch;
+	/** Cached mute state, combined with all parents. */
+	bool effectivelyMuted;
+	/** If true, the cached effective values must be recomputed. */
+	bool dirty;
+
+	/** Current action operating on the gain control. */
+	OALRampAction* gainAction;
+	/** Current action operating on the pitch control. */
+	OALRampAction* pitchAction;
+
+	/** Protects this bus (see OBJECTAL_CFG_LOCK_POLICY). */
+	OALLock lock;
+}
+
+
+#pragma mark Properties
+
+/** The bus this bus feeds into (nil for a master bus). */
+@property(nonatomic,readwrite,retain) ALMixBus* parent;
+
+/** A name for this bus, for debugging purposes. */
+@property(nonatomic,readwrite,copy) NSString* name;
+
+/** Gain applied to everything on this bus (0.0 = silent, 1.0 = unchanged). <br>
+ * Default value: 1.0
+ */
+@property(nonatomic,readwrite,assign) float gain;
+
+/** Pitch multiplier applied to everything on this bus. <br>
+ * Default value: 1.0
+ */
+@property(nonatomic,readwrite,assign) float pitch;
+
+/** If true, everything on this bus is silenced. <br>
+ * Default value: NO
+ */
+@property(nonatomic,readwrite,assign) bool muted;
+
+/** The gain of this bus combined with all of its parents. */
+@property(nonatomic,readonly,assign) float effectiveGain;
+
+/** The pitch multiplier of this bus combined with all of its parents. */
+@property(nonatomic,readonly,assign) float effectivePitch;
+
+/** If true, this bus or one of its parents is muted. */
+@property(nonatomic,readonly,assign) bool effectivelyMuted;
+
+
+#pragma mark Object Management
+
+/** Create a new master bus (a bus with no parent).
+ *
+ * @return A new bus.
+ */
++ (id) bus;
+
+/** Create a new bus feeding into another bus.
+ *
+ * @param parent The bus to feed into.
+ * @return A new bus.
+ */
++ (id) busWithParent:(ALMixBus*) parent;
+
+/** Initialize a bus feeding into another bus.
+ *
+ * @param parent The bus to feed into (nil for a master bus).
+ * @return The initialized bus.
+ */
+- (id) initWithParent:(ALMixBus*) parent;
+
+
+#pragma mark Actions
+
+/** Fade this bus's gain to the specified value over a duration.
+ *
+ * @param value The value to fade to.
+ * @param duration The duration of the fade operation in seconds.
+ * @param target The target to notify when the fade completes (can be nil).
+ * @param selector The selector to call when the fade completes. The selector must accept
+ * a single parameter, which will be the object that performed the fade.
+ */
+- (void) fadeTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector;
+
+/** Stop the currently running fade operation, if any.
+ */
+- (void) stopFade;
+
+/** Gradually change this bus's pitch multiplier to the specified value over a duration.
+ *
+ * @param value The value to change to.
+ * @param duration The duration of the operation in seconds.
+ * @param target The target to notify when the operation completes (can be nil).
+ * @param selector The selector to call when the operation completes. The selector must accept
+ * a single parameter, which will be the object that performed the operation.
+ */
+- (void) pitchTo:(float) value
+		duration:(float) duration
+		  target:(id) target
+		selector:(SEL) selector;
+
+/** Stop the currently running pitch operation, if any.
+ */
+- (void) stopPitch;
+
+/** Stop any currently running actions on this bus.
+ */
+- (void) stopActions;
+
+
+#pragma mark Internal Use
+
+/** \cond */
+/** (INTERNAL USE) Used by ALSource to attach itself to this bus.
+ *
+ * @param voice The source to attach.
+ */
+- (void) addVoice:(ALSource*) voice;
+
+/** (INTERNAL USE) Used by ALSource to detach itself from this bus.
+ *
+ * @param voice The source to detach.
+ */
+- (void) removeVoice:(ALSource*) voice;
+/** \endcond */
+
+@end
@@ -0,0 +1,389 @@
+//
+//  ALMixBus.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALMixBus.h"
+#import "ALSource.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "NSMutableArray+WeakReferences.h"
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for ALMixBus.
+ */
+@interface ALMixBus (Private)
+
+/** (INTERNAL USE) Called by a child bus when it attaches itself. */
+- (void) addChild:(ALMixBus*) child;
+
+/** (INTERNAL USE) Called by a child bus when it detaches itself. */
+- (void) removeChild:(ALMixBus*) child;
+
+/** (INTERNAL USE) Mark this bus and everything below it as needing
+ * its effective values recomputed.
+ */
+- (void) invalidate;
+
+/** (INTERNAL USE) Recompute the effective values if they are dirty.
+ * Must be called with this bus locked.
+ */
+- (void) recalculate;
+
+@end
+/** \endcond */
+
+
+@implementation ALMixBus
+
+#pragma mark Object Management
+
++ (id) bus
+{
+	return as_autorelease([[self alloc] initWithParent:nil]);
+}
+
++ (id) busWithParent:(ALMixBus*) parent
+{
+	return as_autorelease([[self alloc] initWithParent:parent]);
+}
+
+- (id) init
+{
+	return [self initWithParent:nil];
+}
+
+- (id) initWithParent:(ALMixBus*) parentIn
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init with parent %@", self, parentIn);
+		OALLockInit(&lock);
+
+		children = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:8];
+		voices = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:32];
+		gain = 1.0f;
+		pitch = 1.0f;
+		dirty = YES;
+
+		self.parent = parentIn;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+
+	[gainAction cancel];
+	as_release(gainAction);
+	[pitchAction cancel];
+	as_release(pitchAction);
+
+	[parent removeChild:self];
+	as_release(parent);
+	as_release(children);
+	as_release(voices);
+	as_release(name);
+	OALLockDestroy(&lock);
+	as_superdealloc();
+}
+
+- (NSString*) description
+{
+	return [NSString stringWithFormat:@"<%@: %p: %@>", [self class], self, name];
+}
+
+
+#pragma mark Properties
+
+@synthesize name;
+
+- (ALMixBus*) parent
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return as_autorelease(as_retain(parent));
+	}
+}
+
+- (void) setParent:(ALMixBus*) value
+{
+	ALMixBus* oldParent;
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(value == parent)
+		{
+			return;
+		}
+		for(ALMixBus* ancestor = value; nil != ancestor; ancestor = ancestor.parent)
+		{
+			if(ancestor == self)
+			{
+				OAL_LOG_ERROR(@"%@: Cannot feed into %@: it would create a loop", self, value);
+				return;
+			}
+		}
+		oldParent = parent;
+		parent = as_retain(value);
+	}
+
+	[oldParent removeChild:self];
+	as_release(oldParent);
+	[value addChild:self];
+	[self invalidate];
+}
+
+- (float) gain
+{
+	return gain;
+}
+
+- (void) setGain:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(value == gain)
+		{
+			return;
+		}
+		gain = value;
+	}
+	[self invalidate];
+}
+
+- (float) pitch
+{
+	return pitch;
+}
+
+- (void) setPitch:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(value == pitch)
+		{
+			return;
+		}
+		pitch = value;
+	}
+	[self invalidate];
+}
+
+- (bool) muted
+{
+	return muted;
+}
+
+- (void) setMuted:(bool) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(value == muted)
+		{
+			return;
+		}
+		muted = value;
+	}
+	[self invalidate];
+}
+
+- (void) recalculate
+{
+	if(!dirty)
+	{
+		return;
+	}
+
+	// Parent locks are always taken after child locks, never the other way around.
+	effectiveGain = gain;
+	effectivePitch = pitch;
+	effectivelyMuted = muted;
+	if(nil != parent)
+	{
+		effectiveGain *= parent.effectiveGain;
+		effectivePitch *= parent.effectivePitch;
+		effectivelyMuted |= parent.effectivelyMuted;
+	}
+	dirty = NO;
+}
+
+- (float) effectiveGain
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[self recalculate];
+		return effectiveGain;
+	}
+}
+
+- (float) effectivePitch
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[self recalculate];
+		return effectivePitch;
+	}
+}
+
+- (bool) effectivelyMuted
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[self recalculate];
+		return effectivelyMuted;
+	}
+}
+
+- (void) invalidate
+{
+	NSArray* affectedChildren;
+	NSArray* affectedVoices;
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		dirty = YES;
+		affectedChildren = [NSArray arrayWithArray:children];
+		affectedVoices = [NSArray arrayWithArray:voices];
+	}
+
+	// Notify outside of the lock, since voices call back into effectiveGain etc
+	// while holding their own locks.
+	for(ALMixBus* child in affectedChildren)
+	{
+		[child invalidate];
+	}
+	for(ALSource* voice in affectedVoices)
+	{
+		[voice notifyBusChanged];
+	}
+}
+
+
+#pragma mark Actions
+
+- (void) fadeTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector
+{
+	float startValue;
+	// Must always be synchronized
+	ALWAYS_LOCKED(self, &lock)
+	{
+		if(nil == gainAction)
+		{
+			gainAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"gain"];
+		}
+		startValue = self.gain;
+	}
+
+	// Ramps go through the action manager's lock, so start them outside of ours.
+	[gainAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
+}
+
+- (void) stopFade
+{
+	// Must always be synchronized
+	ALWAYS_LOCKED(self, &lock)
+	{
+		[gainAction cancel];
+	}
+}
+
+- (void) pitchTo:(float) value
+		duration:(float) duration
+		  target:(id) target
+		selector:(SEL) selector
+{
+	float startValue;
+	// Must always be synchronized
+	ALWAYS_LOCKED(self, &lock)
+	{
+		if(nil == pitchAction)
+		{
+			pitchAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"pitch"];
+		}
+		startValue = self.pitch;
+	}
+
+	[pitchAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
+}
+
+- (void) stopPitch
+{
+	// Must always be synchronized
+	ALWAYS_LOCKED(self, &lock)
+	{
+		[pitchAction cancel];
+	}
+}
+
+- (void) stopActions
+{
+	[self stopFade];
+	[self stopPitch];
+}
+
+
+#pragma mark Internal Use
+
+- (void) addChild:(ALMixBus*) child
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[children addObject:child];
+	}
+}
+
+- (void) removeChild:(ALMixBus*) child
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[children removeObjectIdenticalTo:child];
+	}
+}
+
+- (void) addVoice:(ALSource*) voice
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[voices addObject:voice];
+	}
+}
+
+- (void) removeVoice:(ALSource*) voice
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[voices removeObjectIdenticalTo:voice];
+	}
+}
+
+@end
@@ -116,19 +116,19 @@
  */
 @property(nonatomic,readwrite,assign) float pan;
 
-/** Reverb send level (how much reverb affects this source). (iOS 5.0+)
+/** Reverb send level (how much reverb affects this source). (iOS 5.0+ or EFX)
  * 0.0 = fully dry, 1.0 = fully wet.
  * Default 0.
  */
 @property(nonatomic,readwrite,assign) float reverbSendLevel;
 
-/** Reverb occlusion (wall/door between listener and source). (iOS 5.0+)
+/** Reverb occlusion (wall/door between listener and source). (iOS 5.0+ or EFX)
  * -100.0db (most occlusion) to 0.0 (no occlusion).
  * Default 0.
  */
 @property(nonatomic,readwrite,assign) float reverbOcclusion;
 
-/** Reverb obstruction (object between listener and source). (iOS 5.0+)
+/** Reverb obstruction (object between listener and source). (iOS 5.0+ or EFX)
  * -100.0db (most obstruction) to 0.0 (no obstruction).
  * Default 0.
  */
@@ -170,6 +170,16 @@
 					 pan:(float) pan
 					loop:(bool) loop;
 
+/** Play a sound, starting at an exact sample on the device clock.
+ * Sounds scheduled for the same sample time start together, to the sample.
+ *
+ * @param buffer the buffer to play.
+ * @param loop If TRUE, the sound will loop until you call "stop" on the returned sound source.
+ * @param sampleTime The time to start at, in sample frames on ALDevice.sampleClock.
+ * @return the source playing the sound, or nil if the sound could not be played.
+ */
+- (id<ALSoundSource>) play:(ALBuffer*) buffer loop:(bool) loop atSampleTime:(int64_t) sampleTime;
+
 /** Stop playing the current sound.
  */
 - (void) stop;
@@ -28,6 +28,7 @@
 //
 
 #import "ALSoundSource.h"
+#import "OALLock.h"
 
 
 #pragma mark ALSoundSourcePool
@@ -39,6 +40,9 @@
 {
 	/** All sources managed by this pool (id<ALSoundSource>). */
 	NSMutableArray* sources;
+
+	/** Protects this pool (see OBJECTAL_CFG_LOCK_POLICY). */
+	OALLock lock;
 }
 
 
@@ -47,6 +51,9 @@
 /** All sources managed by this pool (id<ALSoundSource>). */
 @property(nonatomic,readonly,retain) NSArray* sources;
 
+/** The lock protecting this pool. ALChannelSource holds it while working on the pool's sources. */
+@property(nonatomic,readonly,assign) OALLock* lock;
+
 
 #pragma mark Object Management
 
@@ -65,6 +65,7 @@
 	if(nil != (self = [super init]))
 	{
         OAL_LOG_DEBUG(@"%@: Init", self);
+		OALLockInit(&lock);
 		sources = [[NSMutableArray alloc] initWithCapacity:10];
 	}
 	return self;
@@ -74,6 +75,7 @@
 {
 	OAL_LOG_DEBUG(@"%@: Dealloc", self);
 	as_release(sources);
+	OALLockDestroy(&lock);
 	as_superdealloc();
 }
 
@@ -82,12 +84,17 @@
 
 @synthesize sources;
 
+- (OALLock*) lock
+{
+	return &lock;
+}
+
 
 #pragma mark Source Management
 
 - (void) addSource:(id<ALSoundSource>) source
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		[sources addObject:source];
 	}
@@ -95,7 +102,7 @@
 
 - (void) removeSource:(id<ALSoundSource>) source
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		[sources removeObject:source];
 	}
@@ -103,7 +110,7 @@
 
 - (void) moveToHead:(int) index
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		id source = as_retain([sources objectAtIndex:(NSUInteger)index]);
 		[sources removeObjectAtIndex:(NSUInteger)index];
@@ -116,7 +123,7 @@
 {
 	int index = 0;
 	
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		// Try to find any free source.
 		for(id<ALSoundSource> source in sources)
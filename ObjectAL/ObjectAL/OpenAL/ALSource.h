@@ -33,13 +33,55 @@
 #import "ALBuffer.h"
 #import "OALAction.h"
 #import "OALSuspendHandler.h"
+#import "OALLock.h"
+#import "ARCSafe_MemMgmt.h"
 
 @class ALContext;
 @class ALSource;
+@class ALMixBus;
 
 
 typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificationID, ALvoid* userData);
 
+/** \cond */
+/** (INTERNAL USE) Shadow copy of a source's OpenAL parameters.
+ * Getters read from here, and setters only talk to OpenAL when a value changes.
+ */
+typedef struct
+{
+	float pitch;
+	float maxDistance;
+	float rolloffFactor;
+	float referenceDistance;
+	float minGain;
+	float maxGain;
+	float coneOuterGain;
+	float coneInnerAngle;
+	float coneOuterAngle;
+	ALPoint position;
+	ALVector velocity;
+	ALVector direction;
+	int sourceRelative;
+	bool looping;
+} ALSourceParameters;
+/** \endcond */
+
+/** \cond */
+/** (INTERNAL USE) Number of notification types a source can have a callback for
+ * (AL_SOURCE_STATE, AL_BUFFERS_PROCESSED and AL_QUEUE_HAS_LOOPED).
+ */
+#define kALSourceNotificationTypes 3
+/** \endcond */
+
+/** \cond */
+/** (INTERNAL USE) Values returned by storePosition:velocity:sequence:. */
+enum
+{
+	kALSourcePositionChanged = 1 << 0,
+	kALSourceVelocityChanged = 1 << 1,
+};
+/** \endcond */
+
 #pragma mark ALSource
 
 /**
@@ -64,20 +106,103 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
 	 */
 	bool abortPlaybackResume;
 
+	/** True while this source is waiting for a scheduled start. */
+	int startPending;
+
+	/** True while this source is culled by its context: Paused in OpenAL because
+	 * it can't be heard, but still counted as playing.
+	 */
+	bool virtualized;
+
+	/** Playback offset (in seconds) at the time this source was virtualized. */
+	float virtualOffset;
+
+	/** Time (OALClockMonotonicSeconds) at which this source was virtualized. */
+	double virtualStartTime;
+
+	/** This source's handle in its context's spatial index.
+	 * Only touched by the context, under its spatial index lock.
+	 */
+	int32_t spatialHandle;
+
+	/** A zeroing weak reference to this source. The spatial index stores its
+	 * address rather than the source, so that a query racing dealloc finds nil
+	 * instead of a source that can no longer be retained.
+	 */
+	as_weak id spatialRef;
+
 	ALBuffer* buffer;
 	ALContext* context;
 
+	/** Slices of buffer before and between its loop points, played instead of buffer
+	 * while looping when OpenAL can't loop part of a buffer by itself.
+	 */
+	ALBuffer* introBuffer;
+	ALBuffer* loopBuffer;
+
+	/** True while playing introBuffer, before the switch to looping loopBuffer. */
+	bool loopSwitchPending;
+
+	/** True while a backup check for the loop switch is waiting to run. */
+	bool loopCheckScheduled;
+
+	/** The mixing bus this source feeds into. */
+	ALMixBus* bus;
+
 	/** Current action operating on the gain control. */
-	OALAction* gainAction;
+	OALRampAction* gainAction;
 
 	/** Current action operating on the pan control. */
-	OALAction* panAction;
+	OALRampAction* panAction;
 
 	/** Current action operating on the pitch control. */
-	OALAction* pitchAction;
+	OALRampAction* pitchAction;
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
+
+	/** Shadow copy of the parameters stored in OpenAL. */
+	ALSourceParameters parameters;
+
+	/** Parameters that have changed since the last commit. */
+	uint32_t dirtyFlags;
+
+	/** Incremented whenever the position or velocity changes. */
+	uint32_t motionSequence;
+
+	/** Reverb values, kept here when they go through EFX instead of ASA. */
+	float reverbSendLevel;
+	float reverbOcclusion;
+	float reverbObstruction;
+	float lowPassGainHF;
+	float highPassGainLF;
+
+	/** EFX filter on the dry path (AL_FILTER_NULL until needed). */
+	ALuint directFilter;
+
+	/** EFX filter on the reverb send (AL_FILTER_NULL until needed). */
+	ALuint sendFilter;
+
+	/** How often the context's occlusion query looks at this source, relative to others. */
+	float occlusionPriority;
+
+	/** Occlusion and obstruction (in db) last reported by the context's occlusion query.
+	 * reverbOcclusion and reverbObstruction glide toward these.
+	 */
+	float occlusionTarget;
+	float obstructionTarget;
+
+	/** True while reverbOcclusion and reverbObstruction haven't reached their targets. */
+	bool occlusionGliding;
+
+	/** Time (OALClockNow) of the last occlusion query for this source (negative = never). */
+	double occlusionQueryTime;
+
+	/** Registered notification callbacks (retained blocks, or NULL), one per notification type. */
+	void* notificationCallbacks[kALSourceNotificationTypes];
+
+	/** Protects this source (see OBJECTAL_CFG_LOCK_POLICY). */
+	OALLock lock;
 }
 
 
@@ -97,6 +222,13 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
 /** The context this source was opened on. */
 @property(nonatomic,readonly,retain) ALContext* context;
 
+/** The mixing bus this source feeds into (nil for none).
+ * The bus's effective gain and pitch are multiplied with this source's own
+ * gain and pitch, and muting the bus silences this source. <br>
+ * Default value: The context's masterBus
+ */
+@property(nonatomic,readwrite,retain) ALMixBus* bus;
+
 /** The offset into the current buffer (in bytes). */
 @property(nonatomic,readwrite,assign) float offsetInBytes;
 
@@ -106,12 +238,45 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
 /** The offset into the current buffer (in seconds). */
 @property(nonatomic,readwrite,assign) float offsetInSeconds;
 
+/** The offset into the current buffer and the output latency, read in one atomic
+ * step (AL_SOFT_source_latency). offset - latency is the part of the buffer being
+ * heard right now. <br>
+ * Without AL_SOFT_source_latency, offset is offsetInSeconds and latency is
+ * ALDevice.latency, read one after the other.
+ */
+@property(nonatomic,readonly,assign) ALOffsetLatency offsetWithLatency;
+
 /** OpenAL's ID for this source. */
 @property(nonatomic,readonly,assign) ALuint sourceId;
 
+/** If true, this source is playing, but is too quiet to hear, so its context
+ * has taken it out of the mixer (see ALContext.cullingEnabled). It goes back in,
+ * at the offset it would have reached, once it's loud enough again.
+ */
+@property(nonatomic,readonly,assign) bool virtualized;
+
 /** The state of this source. */
 @property(nonatomic,readwrite,assign) int state;
 
+/** High frequency gain of this source's dry path (0.0 = muffled, 1.0 = unfiltered).
+ * Only available with the EFX extension. <br>
+ * Default value: 1.0
+ */
+@property(nonatomic,readwrite,assign) float lowPassGainHF;
+
+/** Low frequency gain of this source's dry path (0.0 = thin, 1.0 = unfiltered).
+ * Only available with the EFX extension. <br>
+ * Default value: 1.0
+ */
+@property(nonatomic,readwrite,assign) float highPassGainLF;
+
+/** How often the context's occlusion query (see ALContext.occlusionQuery) checks this
+ * source, relative to other sources at the same distance. A source with priority 2 is
+ * checked twice as often as one with priority 1. <br>
+ * Default value: 1.0
+ */
+@property(nonatomic,readwrite,assign) float occlusionPriority;
+
 
 #pragma mark Object Management
 
@@ -144,6 +309,16 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
  */
 - (id<ALSoundSource>) play;
 
+/** Play the currently attached buffer, starting at an exact sample on the device clock.
+ * The source counts as playing from the time this is called.
+ *
+ * @param sampleTime The time to start at, in sample frames on ALDevice.sampleClock.
+ * @return the source playing the sound, or nil if the sound could not be played.
+ *
+ * @see ALContext.playSources:atSampleTime:
+ */
+- (id<ALSoundSource>) playAtSampleTime:(int64_t) sampleTime;
+
 
 #pragma mark Queued Playback
 
@@ -220,4 +395,141 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
  */
 - (void) unregisterAllNotifications;
 
+
+#pragma mark Internal Use
+
+/** \cond */
+/** (INTERNAL USE) This source's handle in its context's spatial index. */
+@property(nonatomic,readwrite,assign) int32_t spatialHandle;
+
+/** (INTERNAL USE) What this source's context stores in its spatial index.
+ * Turn it back into the source with ALSourceFromSpatialItem().
+ */
+@property(nonatomic,readonly,assign) void* spatialItem;
+
+/** (INTERNAL USE) Send any changed parameters to OpenAL.
+ * Called by ALContext when committing deferred updates.
+ */
+- (void) commitParameters;
+
+/** (INTERNAL USE) Called by ALMixBus when the effective values of the bus
+ * this source feeds into have changed.
+ */
+- (void) notifyBusChanged;
+
+/** (INTERNAL USE) Get ready for a scheduled start: Stop anything currently playing
+ * and send all parameters to OpenAL. Called by ALContext.
+ *
+ * @return TRUE if the source can be started.
+ */
+- (bool) prepareScheduledStart;
+
+/** (INTERNAL USE) Claim a pending scheduled start. Called by ALContext when the
+ * start time arrives.
+ *
+ * @return TRUE if the start is still pending (it wasn't cancelled by stop or rewind).
+ */
+- (bool) takeScheduledStart;
+
+/** (INTERNAL USE) Called by ALContext once a scheduled start has been handed to OpenAL.
+ *
+ * @param started TRUE if OpenAL accepted the start.
+ */
+- (void) notifyScheduledStart:(bool) started;
+
+/** (INTERNAL USE) Once the intro slice of a buffer with software loop points has
+ * played, drop it and loop the rest. Called by ALContext.updateLoopPoints and a
+ * backup timer.
+ *
+ * @return TRUE if the intro is still playing and this needs calling again.
+ */
+- (bool) serviceLoopQueue;
+
+/** (INTERNAL USE) Update the shadowed position and velocity without sending them
+ * to OpenAL. Called by ALContext, which sends them for many sources at once.
+ *
+ * @param position The new position, or NULL to leave it alone.
+ * @param velocity The new velocity, or NULL to leave it alone.
+ * @param sequence Receives motionSequence as of this change, for resendMotionIfChangedSince:.
+ * @return The parameters that changed (kALSourcePositionChanged, kALSourceVelocityChanged),
+ *         which the caller must now send to OpenAL.
+ */
+- (uint32_t) storePosition:(const ALPoint*) position
+				  velocity:(const ALVector*) velocity
+				  sequence:(uint32_t*) sequence;
+
+/** (INTERNAL USE) Send the current position and velocity to OpenAL if either
+ * has changed since storePosition:velocity:sequence:. ALContext calls this
+ * after sending a batch, in case a setter ran in between and the batch
+ * overwrote its newer value.
+ *
+ * @param sequence The sequence storePosition:velocity:sequence: gave.
+ */
+- (void) resendMotionIfChangedSince:(uint32_t) sequence;
+
+/** (INTERNAL USE) Estimate how loud this source is at the listener, following the
+ * OpenAL distance and cone model, and including bus gain and muting.
+ *
+ * @param listenerPosition The listener's position.
+ * @param distanceModel The context's distance model.
+ * @return The estimated gain (not including the listener's gain).
+ */
+- (float) estimatedGainAtListenerPosition:(ALPoint) listenerPosition
+							distanceModel:(ALenum) distanceModel;
+
+/** (INTERNAL USE) Estimate how loud this source is at the listener, and virtualize or
+ * restore it accordingly. Called by ALContext on every culling pass.
+ *
+ * @param listenerPosition The listener's position.
+ * @param listenerGain The listener's gain.
+ * @param distanceModel The context's distance model.
+ * @param cullThreshold Virtualize the source if its estimated gain is below this.
+ * @param restoreThreshold Restore a virtualized source if its estimated gain is at or above this.
+ */
+- (void) updateCullingWithListenerPosition:(ALPoint) listenerPosition
+							  listenerGain:(float) listenerGain
+							 distanceModel:(ALenum) distanceModel
+								 cullBelow:(float) cullThreshold
+							  restoreAbove:(float) restoreThreshold;
+
+/** (INTERNAL USE) How badly this source needs a new occlusion query. Grows with the time
+ * since the last query and with occlusionPriority, and shrinks with distance.
+ *
+ * @param listenerPosition The listener's position.
+ * @param now The current time (OALClockNow).
+ * @param position Receives this source's position.
+ * @return The score, or 0 if this source doesn't need occlusion (not playing,
+ *         virtualized or source-relative).
+ */
+- (float) occlusionScoreAtListenerPosition:(ALPoint) listenerPosition
+									  time:(double) now
+								  position:(ALPoint*) position;
+
+/** (INTERNAL USE) Store the result of an occlusion query. reverbOcclusion and
+ * reverbObstruction glide toward it on the following calls to smoothOcclusion:.
+ *
+ * @param occlusion The occlusion in db.
+ * @param obstruction The obstruction in db.
+ * @param now The current time (OALClockNow).
+ */
+- (void) setOcclusionTarget:(float) occlusion obstruction:(float) obstruction time:(double) now;
+
+/** (INTERNAL USE) Move reverbOcclusion and reverbObstruction part of the way toward
+ * the last occlusion query result.
+ *
+ * @param amount How much of the remaining distance to cover (0.0 - 1.0).
+ */
+- (void) smoothOcclusion:(float) amount;
+/** \endcond */
+
 @end
+
+
+/** \cond */
+/** (INTERNAL USE) The source behind an item from its context's spatial index.
+ *
+ * @param item A source's spatialItem.
+ * @return The source (autoreleased under MRC), or nil if it is being deallocated.
+ */
+ALSource* ALSourceFromSpatialItem(void* item);
+/** \endcond */
@@ -28,13 +28,83 @@
 //
 
 #import "ALSource.h"
+#include <sched.h>
+#import <objc/runtime.h>
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
 #import "ALWrapper.h"
 #import "OpenALManager.h"
-#import "OALAudioActions.h"
-#import "OALUtilityActions.h"
-#import "NSMutableDictionary+WeakReferences.h"
+#import "ALMixBus.h"
+#import "OALClock.h"
+#import "OALSpatialGrid.h"
+#import "OALWeakReference.h"
+
+
+/** An occlusion glide stops once it is this close (in db) to its target. */
+#define kALOcclusionSnapDistance 0.1f
+
+/** Extra time (in seconds) to wait past the end of an intro slice before checking that it finished. */
+#define kLoopSwitchMargin 0.05
+
+/** How often (in seconds) the backup timer looks again while an intro slice is still playing. */
+#define kLoopCheckInterval 0.25
+
+/** Seconds of loop slice copies queued behind an intro slice. The switch to looping
+ * can come this late without the source running dry.
+ */
+#define kLoopQueueSeconds 2.0
+
+/** The most copies of a loop slice to queue behind an intro slice. */
+#define kMaxLoopCopies 64
+
+
+/** \cond */
+/** (INTERNAL USE) Flags marking which shadowed parameters still need to be sent to OpenAL. */
+enum
+{
+	kDirtyGain              = 1 << 0,
+	kDirtyPitch             = 1 << 1,
+	kDirtyMaxDistance       = 1 << 2,
+	kDirtyRolloffFactor     = 1 << 3,
+	kDirtyReferenceDistance = 1 << 4,
+	kDirtyMinGain           = 1 << 5,
+	kDirtyMaxGain           = 1 << 6,
+	kDirtyConeOuterGain     = 1 << 7,
+	kDirtyConeInnerAngle    = 1 << 8,
+	kDirtyConeOuterAngle    = 1 << 9,
+	kDirtyPosition          = 1 << 10,
+	kDirtyVelocity          = 1 << 11,
+	kDirtyDirection         = 1 << 12,
+	kDirtySourceRelative    = 1 << 13,
+	kDirtyLooping           = 1 << 14,
+};
+/** \endcond */
+
+/** Synthesizes a property that is read from the shadow parameters and
+ * only marked for commit when its value actually changes.
+ */
+#define SYNTHESIZE_SHADOWED_PROPERTY(NAME, CAPSNAME, TYPE, DIRTYFLAG) \
+- (TYPE) NAME \
+{ \
+	return parameters.NAME; \
+} \
+ \
+- (void) set##CAPSNAME:(TYPE) value \
+{ \
+	OPTIONALLY_LOCKED(self, &lock) \
+	{ \
+		if(self.suspended) \
+		{ \
+			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self); \
+			return; \
+		} \
+		if(parameters.NAME != value) \
+		{ \
+			parameters.NAME = value; \
+			[self markDirty:DIRTYFLAG]; \
+		} \
+	} \
+}
 
 
 #pragma mark -
@@ -54,33 +124,226 @@
  * get around OpenAL bug.
  */
 - (void) delayedResumePlayback;
-/** \endcond */
 
-- (void) receiveNotification:(ALuint) notificationID userData:(void*) userData;
+/** (INTERNAL USE) Read the current parameter values from OpenAL into the shadow copy.
+ */
+- (void) loadParameters;
+
+/** (INTERNAL USE) Set up this source's EFX filters and reverb send from the
+ * reverb and filter properties. Filters come from the context's pool the
+ * first time they are needed, and are updated in place after that.
+ */
+- (void) applyEffects;
+
+/** (INTERNAL USE) Send reverbOcclusion and reverbObstruction to ASA or EFX.
+ */
+- (void) applyOcclusion;
+
+/** (INTERNAL USE) Mark shadowed parameters as changed. They get sent to OpenAL
+ * immediately, or on the next commit if the context is deferring updates.
+ *
+ * @param flags The parameters that changed.
+ */
+- (void) markDirty:(uint32_t) flags;
+
+/** (INTERNAL USE) The offset (in seconds) a virtualized source would have reached by now.
+ */
+- (float) currentVirtualOffset;
+
+/** (INTERNAL USE) Take this source out of the virtualized state, moving OpenAL's
+ * offset to where playback would have reached. The source stays paused in OpenAL.
+ *
+ * @return FALSE if the sound would have ended already.
+ */
+- (bool) devirtualize;
+
+/** (INTERNAL USE) Start playing in OpenAL, going through prepareLoopPoints first.
+ *
+ * @return TRUE if playback started.
+ */
+- (bool) sourcePlay;
+
+/** (INTERNAL USE) Attach the buffer to the OpenAL source for the next play.
+ * If the buffer has loop points that OpenAL can't handle and the source is
+ * looping, queue slices of it instead: The part before the loop start, then
+ * the looped part. The source must be stopped.
+ */
+- (void) prepareLoopPoints;
+
+/** (INTERNAL USE) Have serviceLoopQueue called once the intro slice finishes:
+ * From ALContext.updateLoopPoints, and from a timer in case nothing calls that.
+ */
+- (void) scheduleLoopSwitch;
+
+/** (INTERNAL USE) Call runLoopCheck after a delay. The wait doesn't keep
+ * the source alive.
+ *
+ * @param delay How long to wait, in seconds.
+ */
+- (void) scheduleLoopCheck:(double) delay;
+
+/** (INTERNAL USE) Call serviceLoopQueue, and schedule another check if the
+ * intro is still playing. Stops while paused or suspended, until playback
+ * resumes and calls scheduleLoopSwitch again.
+ */
+- (void) runLoopCheck;
+
+/** (INTERNAL USE) Release the loop point slices. They must not be attached to the source.
+ */
+- (void) releaseLoopSlices;
+
+/** (INTERNAL USE) Called from OpenAL's notification thread. Runs the callback
+ * registered for this kind of notification, if there is one.
+ *
+ * @param notificationID The kind of notification.
+ * @param index Index of notificationID in notificationCallbacks.
+ * @param userData The pointer given when the callback was registered.
+ */
+- (void) receiveNotification:(ALuint) notificationID index:(int) index userData:(void*) userData;
 
-@property(nonatomic, readwrite, retain) NSMutableDictionary* notificationCallbacks;
+/** (INTERNAL USE) Take the callback out of a slot in notificationCallbacks and
+ * stop OpenAL from sending its notification. Only call while holding the source lock.
+ *
+ * @param index Index of the slot in notificationCallbacks.
+ */
+- (void) removeNotificationAtIndex:(int) index;
+/** \endcond */
 
 @end
 
 
 @implementation ALSource
 
-static NSMutableDictionary* g_allSourcesByID;
+/** \cond */
+/** (INTERNAL USE) Number of bits used to index the source table. */
+#define kSourceTableBits 10
 
-static ALvoid alSourceNotification(ALuint sid, ALuint notificationID, ALvoid* userData)
+/** (INTERNAL USE) Capacity of the source table. This must be larger than the
+ * number of sources OpenAL can have allocated at once.
+ */
+#define kSourceTableCapacity (1 << kSourceTableBits)
+
+/** (INTERNAL USE) Marks a slot that has never been used (0 is never a valid source id). */
+#define kSourceTableEmptySlot 0
+
+/** (INTERNAL USE) Marks a slot whose source has been removed. */
+#define kSourceTableRemovedSlot ((ALuint)AL_INVALID)
+
+/** (INTERNAL USE) Maps an OpenAL source id to its ALSource. */
+typedef struct
+{
+	ALuint sourceId;
+	void* source;
+} OALSourceTableSlot;
+/** \endcond */
+
+/** Open addressed table of all live sources, keyed by source id.
+ * Registering and removing sources takes g_sourceTableLock, but lookups are
+ * lock-free and allocation-free so that they can run in the notification callback.
+ */
+static OALSourceTableSlot g_sourceTable[kSourceTableCapacity];
+static OALLock g_sourceTableLock;
+
+static inline ALuint sourceTableIndex(ALuint sid)
+{
+	return (sid * 2654435769u) >> (32 - kSourceTableBits);
+}
+
+static void* sourceTableLookup(ALuint sid)
+{
+	ALuint index = sourceTableIndex(sid);
+	for(int i = 0; i < kSourceTableCapacity; i++)
+	{
+		OALSourceTableSlot* slot = &g_sourceTable[index];
+		ALuint slotId = __atomic_load_n(&slot->sourceId, __ATOMIC_ACQUIRE);
+		if(slotId == sid)
+		{
+			void* source = __atomic_load_n(&slot->source, __ATOMIC_ACQUIRE);
+			// Make sure the slot wasn't recycled while we were reading it.
+			if(__atomic_load_n(&slot->sourceId, __ATOMIC_ACQUIRE) != sid)
+			{
+				return NULL;
+			}
+			return source;
+		}
+		if(kSourceTableEmptySlot == slotId)
+		{
+			return NULL;
+		}
+		index = (index + 1) & (kSourceTableCapacity - 1);
+	}
+	return NULL;
+}
+
+/** The notification types a source can have callbacks for, in notificationCallbacks order. */
+static const ALuint g_notificationTypes[kALSourceNotificationTypes] =
+{
+	AL_SOURCE_STATE,
+	AL_BUFFERS_PROCESSED,
+	AL_QUEUE_HAS_LOOPED,
+};
+
+/** Number of notification callbacks running right now, on any thread. */
+static int32_t g_notificationsInFlight;
+
+/** Number of notification callbacks running right now on this thread. */
+static __thread int32_t t_notificationsInFlight;
+
+static int notificationIndex(ALuint notificationID)
+{
+	for(int i = 0; i < kALSourceNotificationTypes; i++)
+	{
+		if(g_notificationTypes[i] == notificationID)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/** Wait until no notification callback is running, other than ones further
+ * up this thread's own stack. Anything removed from the source table or from a
+ * source's notificationCallbacks before calling this can no longer be in use
+ * by another thread once it returns.
+ */
+static void waitForNotificationsInFlight(void)
 {
-    ALSource* source = [g_allSourcesByID objectForKey:[NSNumber numberWithUnsignedInt:sid]];
-    [source receiveNotification:notificationID userData:userData];
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while(__atomic_load_n(&g_notificationsInFlight, __ATOMIC_ACQUIRE) > t_notificationsInFlight)
+	{
+		sched_yield();
+	}
 }
 
+static ALvoid alSourceNotification(ALuint sid, ALuint notificationID, ALvoid* userData)
+{
+	int index = notificationIndex(notificationID);
+	if(index < 0)
+	{
+		return;
+	}
+
+	// Counted before looking the source up, so that a source on its way out
+	// of the table can wait until we're done with it.
+	__atomic_add_fetch(&g_notificationsInFlight, 1, __ATOMIC_SEQ_CST);
+	t_notificationsInFlight++;
 
-@synthesize notificationCallbacks = _notificationCallbacks;
+	as_autoreleasepool_start(pool);
+	// Not retained: the source may already be deallocating, in which case it's
+	// waiting for us in notifySourceDeallocated.
+	as_unsafe_unretained ALSource* source = (as_bridge ALSource*) sourceTableLookup(sid);
+	[source receiveNotification:notificationID index:index userData:userData];
+	as_autoreleasepool_end(pool);
+
+	t_notificationsInFlight--;
+	__atomic_sub_fetch(&g_notificationsInFlight, 1, __ATOMIC_RELEASE);
+}
 
 + (void) initialize
 {
-    if(g_allSourcesByID == nil)
+    if(self == [ALSource class])
     {
-        g_allSourcesByID = [NSMutableDictionary newMutableDictionaryUsingWeakReferencesWithCapacity:32];
+        OALLockInit(&g_sourceTableLock);
     }
 }
 
@@ -106,6 +369,7 @@ static ALvoid alSourceNotification(ALuint sid, ALuint notificationID, ALvoid* us
 	if(nil != (self = [super init]))
 	{
 		OAL_LOG_DEBUG(@"%@: Init on context %@", self, contextIn);
+		OALLockInit(&lock);
 
 		if(nil == contextIn)
 		{
@@ -115,7 +379,6 @@ static ALvoid alSourceNotification(ALuint sid, ALuint notificationID, ALvoid* us
 		
 		suspendHandler = [[OALSuspendHandler alloc] initWithTarget:self selector:@selector(setSuspended:)];
 
-        self.notificationCallbacks = [NSMutableDictionary dictionary];
 		context = as_retain(contextIn);
 		@synchronized([OpenALManager sharedInstance])
 		{
@@ -131,9 +394,24 @@ static ALvoid alSourceNotification(ALuint sid, ALuint notificationID, ALvoid* us
 		}
 		OAL_LOG_DEBUG(@"%@: Created source %08x", self, sourceId);
 
+		spatialHandle = kOALSpatialGridNoHandle;
+#if __has_feature(objc_arc)
+		spatialRef = self;
+#else
+		objc_storeWeak(&spatialRef, self);
+#endif
+		occlusionQueryTime = -1;
 		[context notifySourceInitializing:self];
 		gain = [ALWrapper getSourcef:sourceId parameter:AL_GAIN];
-		shadowState = AL_INITIAL;
+		lowPassGainHF = 1.0f;
+		highPassGainLF = 1.0f;
+		occlusionPriority = 1.0f;
+		[self loadParameters];
+		bus = as_retain(context.masterBus);
+		[bus addVoice:self];
+		[self markDirty:kDirtyGain | kDirtyPitch];
+		[context notifySourceMoved:self];
+		OAL_ATOMIC_STORE(&shadowState, AL_INITIAL);
 		
 		[context addSuspendListener:self];
         [[self class] notifySourceAllocated:self];
@@ -147,21 +425,27 @@ initFailed:
 
 - (void) dealloc
 {
+	// Get out of the context's index before anything else. Until then its
+	// spatial queries can still find this source, but spatialRef reads as nil.
+	[context notifySourceDeallocating:self];
+#if !__has_feature(objc_arc)
+	objc_storeWeak(&spatialRef, nil);
+#endif
+	[bus removeVoice:self];
+
 	OAL_LOG_DEBUG(@"%@: Dealloc, sourceId = %08x", self, sourceId);
 
     [[self class] notifySourceDeallocated:self];
     [self unregisterAllNotifications];
 	[context removeSuspendListener:self];
-	[context notifySourceDeallocating:self];
 
-	[gainAction stopAction];
+	[gainAction cancel];
 	as_release(gainAction);
-	[panAction stopAction];
+	[panAction cancel];
 	as_release(panAction);
-	[pitchAction stopAction];
+	[pitchAction cancel];
 	as_release(pitchAction);
 	as_release(suspendHandler);
-    as_release(_notificationCallbacks);
 
     if((ALuint)AL_INVALID != sourceId)
     {
@@ -183,11 +467,21 @@ initFailed:
         }
     }
 
+	if(AL_FILTER_NULL != directFilter || AL_FILTER_NULL != sendFilter)
+	{
+		[context.effects releaseFilter:directFilter];
+		[context.effects releaseFilter:sendFilter];
+	}
+
+	as_release(bus);
 	as_release(context);
     as_release(buffer);
+	as_release(introBuffer);
+	as_release(loopBuffer);
 
     [NSObject cancelPreviousPerformRequestsWithTarget:self];
-    
+
+	OALLockDestroy(&lock);
 	as_superdealloc();
 }
 
@@ -201,7 +495,7 @@ initFailed:
 
 - (void) setBuffer:(ALBuffer *) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -212,6 +506,7 @@ initFailed:
 		[self stop];
         
 		[ALWrapper sourcei:sourceId parameter:AL_BUFFER value:(ALint)value.bufferId];
+		[self releaseLoopSlices];
         
         as_release(buffer);
 		buffer = as_retain(value);
@@ -228,87 +523,52 @@ initFailed:
 	return [ALWrapper getSourcei:sourceId parameter:AL_BUFFERS_PROCESSED];
 }
 
-- (float) coneInnerAngle
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_CONE_INNER_ANGLE];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(coneInnerAngle, ConeInnerAngle, float, kDirtyConeInnerAngle);
 
-- (void) setConeInnerAngle:(float) value
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		if(self.suspended)
-		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
-		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_CONE_INNER_ANGLE value:value];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(coneOuterAngle, ConeOuterAngle, float, kDirtyConeOuterAngle);
 
-- (float) coneOuterAngle
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_ANGLE];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(coneOuterGain, ConeOuterGain, float, kDirtyConeOuterGain);
 
-- (void) setConeOuterAngle:(float) value
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		if(self.suspended)
-		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
-		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_CONE_OUTER_ANGLE value:value];
-	}
-}
+@synthesize context;
 
-- (float) coneOuterGain
+- (ALMixBus*) bus
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_GAIN];
+		return as_autorelease(as_retain(bus));
 	}
 }
 
-- (void) setConeOuterGain:(float) value
+- (void) setBus:(ALMixBus*) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		if(self.suspended)
+		if(value == bus)
 		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
 			return;
 		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_CONE_OUTER_GAIN value:value];
+		[bus removeVoice:self];
+		as_release(bus);
+		bus = as_retain(value);
+		[bus addVoice:self];
+		[self markDirty:kDirtyGain | kDirtyPitch];
 	}
 }
 
-@synthesize context;
-
 - (ALVector) direction
 {
-	ALVector result;
-	OPTIONALLY_SYNCHRONIZED(self)
+	// More than one word, so read under the lock to never see half of a write.
+	ALVector value;
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		[ALWrapper getSource3f:sourceId parameter:AL_DIRECTION v1:&result.x v2:&result.y v3:&result.z];
+		value = parameters.direction;
 	}
-	return result;
+	return value;
 }
 
 - (void) setDirection:(ALVector) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -316,7 +576,13 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper source3f:sourceId parameter:AL_DIRECTION v1:value.x v2:value.y v3:value.z];
+		if(parameters.direction.x != value.x ||
+		   parameters.direction.y != value.y ||
+		   parameters.direction.z != value.z)
+		{
+			parameters.direction = value;
+			[self markDirty:kDirtyDirection];
+		}
 	}
 }
 
@@ -337,7 +603,7 @@ initFailed:
 
 - (void) setGain:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -345,104 +611,31 @@ initFailed:
 			return;
 		}
 		
-		gain = value;
-		if(muted)
-		{
-			value = 0;
-		}
-		[ALWrapper sourcef:sourceId parameter:AL_GAIN value:value];
-	}
-}
-
-@synthesize interruptible;
-
-- (bool) looping
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcei:sourceId parameter:AL_LOOPING];
-	}
-}
-
-- (void) setLooping:(bool) value
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		if(self.suspended)
+		if(gain != value)
 		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
+			gain = value;
+			[self markDirty:kDirtyGain];
 		}
-		
-		[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:value];
 	}
 }
 
-- (float) maxDistance
+- (bool) interruptible
 {
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_MAX_DISTANCE];
-	}
+	return OAL_ATOMIC_LOAD(&interruptible);
 }
 
-- (void) setMaxDistance:(float) value
+- (void) setInterruptible:(bool) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		if(self.suspended)
-		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
-		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_MAX_DISTANCE value:value];
-	}
+	OAL_ATOMIC_STORE(&interruptible, value);
 }
 
-- (float) maxGain
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_MAX_GAIN];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(looping, Looping, bool, kDirtyLooping);
 
-- (void) setMaxGain:(float) value
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		if(self.suspended)
-		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
-		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_MAX_GAIN value:value];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(maxDistance, MaxDistance, float, kDirtyMaxDistance);
 
-- (float) minGain
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_MIN_GAIN];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(maxGain, MaxGain, float, kDirtyMaxGain);
 
-- (void) setMinGain:(float) value
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		if(self.suspended)
-		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
-		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_MIN_GAIN value:value];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(minGain, MinGain, float, kDirtyMinGain);
 
 - (bool) muted
 {
@@ -451,7 +644,7 @@ initFailed:
 
 - (void) setMuted:(bool) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -465,13 +658,13 @@ initFailed:
 			[self stopActions];
 		}
 		// Force a re-evaluation of gain.
-		[self setGain:gain];
+		[self markDirty:kDirtyGain];
 	}
 }
 
 - (float) offsetInBytes
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		return [ALWrapper getSourcef:sourceId parameter:AL_BYTE_OFFSET];
 	}
@@ -479,7 +672,7 @@ initFailed:
 
 - (void) setOffsetInBytes:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -493,7 +686,7 @@ initFailed:
 
 - (float) offsetInSamples
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		return [ALWrapper getSourcef:sourceId parameter:AL_SAMPLE_OFFSET];
 	}
@@ -501,7 +694,7 @@ initFailed:
 
 - (void) setOffsetInSamples:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -515,31 +708,64 @@ initFailed:
 
 - (float) offsetInSeconds
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
+		if(virtualized)
+		{
+			return [self currentVirtualOffset];
+		}
 		return [ALWrapper getSourcef:sourceId parameter:AL_SEC_OFFSET];
 	}
 }
 
+- (ALOffsetLatency) offsetWithLatency
+{
+	ALOffsetLatency result = {0, 0};
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		ALdouble values[2];
+		if(!virtualized && [ALWrapper getSourcedv:sourceId parameter:AL_SEC_OFFSET_LATENCY_SOFT values:values])
+		{
+			result.offset = values[0];
+			result.latency = values[1];
+			return result;
+		}
+		result.offset = virtualized ? [self currentVirtualOffset] : [ALWrapper getSourcef:sourceId parameter:AL_SEC_OFFSET];
+	}
+	result.latency = (double)context.device.latency / 1000000000.0;
+	return result;
+}
+
 - (void) setOffsetInSeconds:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
 			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
 			return;
 		}
-		
+		if(virtualized)
+		{
+			virtualOffset = value;
+			virtualStartTime = OALClockMonotonicSeconds();
+			return;
+		}
+
 		[ALWrapper sourcef:sourceId parameter:AL_SEC_OFFSET value:value];
 	}
 }
 
+- (bool) virtualized
+{
+	return virtualized;
+}
+
 - (bool) paused
 {
 	if(self.suspended)
 	{
-		return AL_PAUSED == shadowState;
+		return AL_PAUSED == OAL_ATOMIC_LOAD(&shadowState);
 	}
 
 	return AL_PAUSED == self.state;
@@ -547,7 +773,7 @@ initFailed:
 
 - (void) setPaused:(bool) shouldPause
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -557,12 +783,17 @@ initFailed:
 		
 		if(shouldPause)
 		{
+			if(virtualized && ![self devirtualize])
+			{
+				[self stop];
+				return;
+			}
 			if(AL_PLAYING == self.state)
 			{
                 abortPlaybackResume = YES;
 				if([ALWrapper sourcePause:sourceId])
 				{
-					shadowState = AL_PAUSED;
+					OAL_ATOMIC_STORE(&shadowState, AL_PAUSED);
 				}
 			}
 		}
@@ -572,61 +803,51 @@ initFailed:
 			{
 				if([ALWrapper sourcePlay:sourceId])
                 {
-                    shadowState = AL_PLAYING;
+                    OAL_ATOMIC_STORE(&shadowState, AL_PLAYING);
+                    if(loopSwitchPending)
+                    {
+                        [self scheduleLoopSwitch];
+                    }
                 }
                 else
 				{
-					shadowState = AL_STOPPED;
+					OAL_ATOMIC_STORE(&shadowState, AL_STOPPED);
 				}
 			}
 		}
 	}
 }
 
-- (float) pitch
-{
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_PITCH];
-	}
-}
+SYNTHESIZE_SHADOWED_PROPERTY(pitch, Pitch, float, kDirtyPitch);
 
-- (void) setPitch:(float) value
+- (bool) playing
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	if(OAL_ATOMIC_LOAD(&startPending))
 	{
-		if(self.suspended)
-		{
-			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
-			return;
-		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_PITCH value:value];
+		return YES;
 	}
-}
-
-- (bool) playing
-{
 	if(self.suspended)
 	{
-		return AL_PLAYING == shadowState || AL_PAUSED == shadowState;
+		int currentState = OAL_ATOMIC_LOAD(&shadowState);
+		return AL_PLAYING == currentState || AL_PAUSED == currentState;
 	}
 	return AL_PLAYING == self.state || AL_PAUSED == self.state;
 }
 
 - (ALPoint) position
 {
-	ALPoint result;
-	OPTIONALLY_SYNCHRONIZED(self)
+	ALPoint value;
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		[ALWrapper getSource3f:sourceId parameter:AL_POSITION v1:&result.x v2:&result.y v3:&result.z];
+		value = parameters.position;
 	}
-	return result;
+	return value;
 }
 
 - (void) setPosition:(ALPoint) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	bool moved = NO;
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -634,7 +855,21 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper source3f:sourceId parameter:AL_POSITION v1:value.x v2:value.y v3:value.z];
+		if(parameters.position.x != value.x ||
+		   parameters.position.y != value.y ||
+		   parameters.position.z != value.z)
+		{
+			parameters.position = value;
+			motionSequence++;
+			[self markDirty:kDirtyPosition];
+			moved = YES;
+		}
+	}
+
+	// Outside of our lock, since the context locks its index before sources.
+	if(moved)
+	{
+		[context notifySourceMoved:self];
 	}
 }
 
@@ -654,39 +889,60 @@ initFailed:
 	self.position = alpoint(value, 0, 0);
 }
 
-- (float) referenceDistance
+SYNTHESIZE_SHADOWED_PROPERTY(referenceDistance, ReferenceDistance, float, kDirtyReferenceDistance);
+
+SYNTHESIZE_SHADOWED_PROPERTY(rolloffFactor, RolloffFactor, float, kDirtyRolloffFactor);
+
+@synthesize sourceId;
+
+- (int) sourceRelative
 {
-	OPTIONALLY_SYNCHRONIZED(self)
-	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_REFERENCE_DISTANCE];
-	}
+	return parameters.sourceRelative;
 }
 
-- (void) setReferenceDistance:(float) value
+- (void) setSourceRelative:(int) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	bool changed = NO;
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
 			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
 			return;
 		}
-		
-		[ALWrapper sourcef:sourceId parameter:AL_REFERENCE_DISTANCE value:value];
+		if(parameters.sourceRelative != value)
+		{
+			parameters.sourceRelative = value;
+			[self markDirty:kDirtySourceRelative];
+			changed = YES;
+		}
 	}
+
+	// Relative sources follow the listener, so they're kept out of the spatial index.
+	if(changed)
+	{
+		[context notifySourceMoved:self];
+	}
+}
+
+@synthesize spatialHandle;
+
+- (void*) spatialItem
+{
+	return (void*)&spatialRef;
 }
 
-- (float) rolloffFactor
+- (int) sourceType
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper getSourcef:sourceId parameter:AL_ROLLOFF_FACTOR];
+		return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_TYPE];
 	}
 }
 
-- (void) setRolloffFactor:(float) value
+- (void) setSourceType:(int) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -694,23 +950,33 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper sourcef:sourceId parameter:AL_ROLLOFF_FACTOR value:value];
+		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_TYPE value:value];
 	}
 }
 
-@synthesize sourceId;
-
-- (int) sourceRelative
+- (int) state
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_RELATIVE];
-	}
+		// Bug: Apple's OpenAL implementation is broken.
+		//return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
+		
+		int currentState = OAL_ATOMIC_LOAD(&shadowState);
+		if(AL_INITIAL == currentState || AL_STOPPED == currentState)
+		{
+			return currentState;
+		}
+		if(AL_STOPPED == [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE])
+		{
+			return AL_STOPPED;
+		}
+		return currentState;
+	}
 }
 
-- (void) setSourceRelative:(int) value
+- (void) setState:(int) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -718,21 +984,24 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_RELATIVE value:value];
+		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_STATE value:value];
+		OAL_ATOMIC_STORE(&shadowState, value);
 	}
 }
 
-- (int) sourceType
+- (ALVector) velocity
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	ALVector value;
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_TYPE];
+		value = parameters.velocity;
 	}
+	return value;
 }
 
-- (void) setSourceType:(int) value
+- (void) setVelocity:(ALVector) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -740,32 +1009,32 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_TYPE value:value];
+		if(parameters.velocity.x != value.x ||
+		   parameters.velocity.y != value.y ||
+		   parameters.velocity.z != value.z)
+		{
+			parameters.velocity = value;
+			motionSequence++;
+			[self markDirty:kDirtyVelocity];
+		}
 	}
 }
 
-- (int) state
+- (float) reverbSendLevel
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		// Bug: Apple's OpenAL implementation is broken.
-		//return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
-		
-		if(AL_INITIAL == shadowState || AL_STOPPED == shadowState)
+		if([ALWrapper asaSupported])
 		{
-			return shadowState;
-		}
-		if(AL_STOPPED == [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE])
-		{
-			return AL_STOPPED;
+			return [ALWrapper asaGetSourcef:sourceId property:ALC_ASA_REVERB_SEND_LEVEL];
 		}
-		return shadowState;
+		return reverbSendLevel;
 	}
 }
 
-- (void) setState:(int) value
+- (void) setReverbSendLevel:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -773,24 +1042,33 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_STATE value:value];
-		shadowState = value;
+		reverbSendLevel = value;
+		if([ALWrapper asaSupported])
+		{
+			[ALWrapper asaSourcef:sourceId property:ALC_ASA_REVERB_SEND_LEVEL value:value];
+		}
+		else
+		{
+			[self applyEffects];
+		}
 	}
 }
 
-- (ALVector) velocity
+- (float) reverbOcclusion
 {
-	ALVector result;
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		[ALWrapper getSource3f:sourceId parameter:AL_VELOCITY v1:&result.x v2:&result.y v3:&result.z];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetSourcef:sourceId property:ALC_ASA_OCCLUSION];
+		}
+		return reverbOcclusion;
 	}
-	return result;
 }
 
-- (void) setVelocity:(ALVector) value
+- (void) setReverbOcclusion:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -798,21 +1076,27 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper source3f:sourceId parameter:AL_VELOCITY v1:value.x v2:value.y v3:value.z];
+		reverbOcclusion = value;
+		occlusionGliding = NO;
+		[self applyOcclusion];
 	}
 }
 
-- (float) reverbSendLevel
+- (float) reverbObstruction
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper asaGetSourcef:sourceId property:ALC_ASA_REVERB_SEND_LEVEL];
+		if([ALWrapper asaSupported])
+		{
+			return [ALWrapper asaGetSourcef:sourceId property:ALC_ASA_OBSTRUCTION];
+		}
+		return reverbObstruction;
 	}
 }
 
-- (void) setReverbSendLevel:(float) reverbSendLevel
+- (void) setReverbObstruction:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -820,55 +1104,323 @@ initFailed:
 			return;
 		}
 		
-		[ALWrapper asaSourcef:sourceId property:ALC_ASA_REVERB_SEND_LEVEL value:reverbSendLevel];
+		reverbObstruction = value;
+		occlusionGliding = NO;
+		[self applyOcclusion];
 	}
 }
 
-- (float) reverbOcclusion
+- (float) occlusionPriority
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return occlusionPriority;
+	}
+}
+
+- (void) setOcclusionPriority:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper asaGetSourcef:sourceId property:ALC_ASA_OCCLUSION];
+		occlusionPriority = fmaxf(value, 0);
 	}
 }
 
-- (void) setReverbOcclusion:(float) reverbOcclusion
+- (float) lowPassGainHF
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		return lowPassGainHF;
+	}
+}
+
+- (void) setLowPassGainHF:(float) value
+{
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
 			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
 			return;
 		}
-		
-		[ALWrapper asaSourcef:sourceId property:ALC_ASA_OCCLUSION value:reverbOcclusion];
+
+		lowPassGainHF = value;
+		[self applyEffects];
 	}
 }
 
-- (float) reverbObstruction
+- (float) highPassGainLF
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-		return [ALWrapper asaGetSourcef:sourceId property:ALC_ASA_OBSTRUCTION];
+		return highPassGainLF;
 	}
 }
 
-- (void) setReverbObstruction:(float) reverbObstruction
+- (void) setHighPassGainLF:(float) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
 			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
 			return;
 		}
-		
+
+		highPassGainLF = value;
+		[self applyEffects];
+	}
+}
+
+- (void) applyOcclusion
+{
+	if([ALWrapper asaSupported])
+	{
+		[ALWrapper asaSourcef:sourceId property:ALC_ASA_OCCLUSION value:reverbOcclusion];
 		[ALWrapper asaSourcef:sourceId property:ALC_ASA_OBSTRUCTION value:reverbObstruction];
 	}
+	else
+	{
+		[self applyEffects];
+	}
+}
+
+- (void) applyEffects
+{
+	if(![ALWrapper efxSupported])
+	{
+		return;
+	}
+	ALEffects* effects = context.effects;
+
+	// Occlusion (a wall) muffles both the dry sound and its reverb.
+	// Obstruction (something in the way) only muffles the dry sound.
+	float occlusion = powf(10.0f, MIN(reverbOcclusion, 0.0f) / 20.0f);
+	float obstruction = powf(10.0f, MIN(reverbObstruction, 0.0f) / 20.0f);
+
+	float dryGain = powf(occlusion * obstruction, 0.25f);
+	float dryGainHF = lowPassGainHF * occlusion * obstruction;
+	ALint dryType;
+	if(highPassGainLF < 1.0f)
+	{
+		dryType = dryGainHF < 1.0f ? AL_FILTER_BANDPASS : AL_FILTER_HIGHPASS;
+	}
+	else
+	{
+		dryType = (dryGainHF < 1.0f || dryGain < 1.0f) ? AL_FILTER_LOWPASS : AL_FILTER_NULL;
+	}
+
+	if(AL_FILTER_NULL != dryType && AL_FILTER_NULL == directFilter)
+	{
+		directFilter = [effects acquireFilter];
+	}
+	if(AL_FILTER_NULL != directFilter)
+	{
+		[ALWrapper filteri:directFilter parameter:AL_FILTER_TYPE value:dryType];
+		switch(dryType)
+		{
+			case AL_FILTER_LOWPASS:
+				[ALWrapper filterf:directFilter parameter:AL_LOWPASS_GAIN value:dryGain];
+				[ALWrapper filterf:directFilter parameter:AL_LOWPASS_GAINHF value:dryGainHF];
+				break;
+			case AL_FILTER_HIGHPASS:
+				[ALWrapper filterf:directFilter parameter:AL_HIGHPASS_GAIN value:dryGain];
+				[ALWrapper filterf:directFilter parameter:AL_HIGHPASS_GAINLF value:highPassGainLF];
+				break;
+			case AL_FILTER_BANDPASS:
+				[ALWrapper filterf:directFilter parameter:AL_BANDPASS_GAIN value:dryGain];
+				[ALWrapper filterf:directFilter parameter:AL_BANDPASS_GAINLF value:highPassGainLF];
+				[ALWrapper filterf:directFilter parameter:AL_BANDPASS_GAINHF value:dryGainHF];
+				break;
+		}
+		// Sources copy their filter's parameters when it is attached.
+		[ALWrapper sourcei:sourceId parameter:AL_DIRECT_FILTER value:(ALint)directFilter];
+	}
+
+	if(reverbSendLevel <= 0.0f)
+	{
+		[ALWrapper source3i:sourceId
+				  parameter:AL_AUXILIARY_SEND_FILTER
+						 v1:AL_EFFECTSLOT_NULL
+						 v2:0
+						 v3:AL_FILTER_NULL];
+		return;
+	}
+
+	if(AL_FILTER_NULL == sendFilter)
+	{
+		sendFilter = [effects acquireFilter];
+	}
+	if(AL_FILTER_NULL != sendFilter)
+	{
+		[ALWrapper filteri:sendFilter parameter:AL_FILTER_TYPE value:AL_FILTER_LOWPASS];
+		[ALWrapper filterf:sendFilter parameter:AL_LOWPASS_GAIN value:MIN(reverbSendLevel, 1.0f) * powf(occlusion, 0.25f)];
+		[ALWrapper filterf:sendFilter parameter:AL_LOWPASS_GAINHF value:occlusion];
+	}
+	[ALWrapper source3i:sourceId
+			  parameter:AL_AUXILIARY_SEND_FILTER
+					 v1:(ALint)effects.reverbSlot
+					 v2:0
+					 v3:(ALint)sendFilter];
 }
 
 
+#pragma mark Shadowed Parameters
+
+- (void) loadParameters
+{
+	parameters.pitch = [ALWrapper getSourcef:sourceId parameter:AL_PITCH];
+	parameters.maxDistance = [ALWrapper getSourcef:sourceId parameter:AL_MAX_DISTANCE];
+	parameters.rolloffFactor = [ALWrapper getSourcef:sourceId parameter:AL_ROLLOFF_FACTOR];
+	parameters.referenceDistance = [ALWrapper getSourcef:sourceId parameter:AL_REFERENCE_DISTANCE];
+	parameters.minGain = [ALWrapper getSourcef:sourceId parameter:AL_MIN_GAIN];
+	parameters.maxGain = [ALWrapper getSourcef:sourceId parameter:AL_MAX_GAIN];
+	parameters.coneOuterGain = [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_GAIN];
+	parameters.coneInnerAngle = [ALWrapper getSourcef:sourceId parameter:AL_CONE_INNER_ANGLE];
+	parameters.coneOuterAngle = [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_ANGLE];
+	[ALWrapper getSource3f:sourceId
+				 parameter:AL_POSITION
+						v1:&parameters.position.x
+						v2:&parameters.position.y
+						v3:&parameters.position.z];
+	[ALWrapper getSource3f:sourceId
+				 parameter:AL_VELOCITY
+						v1:&parameters.velocity.x
+						v2:&parameters.velocity.y
+						v3:&parameters.velocity.z];
+	[ALWrapper getSource3f:sourceId
+				 parameter:AL_DIRECTION
+						v1:&parameters.direction.x
+						v2:&parameters.direction.y
+						v3:&parameters.direction.z];
+	parameters.sourceRelative = [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_RELATIVE];
+	parameters.looping = [ALWrapper getSourcei:sourceId parameter:AL_LOOPING];
+	dirtyFlags = 0;
+}
+
+- (void) markDirty:(uint32_t) flags
+{
+	bool wasClean = 0 == dirtyFlags;
+	dirtyFlags |= flags;
+	if(!context.deferUpdates)
+	{
+		[self commitParameters];
+	}
+	else if(wasClean)
+	{
+		[context notifySourceDirty:self];
+	}
+}
+
+- (void) commitParameters
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		uint32_t flags = dirtyFlags;
+		if(0 == flags)
+		{
+			return;
+		}
+		dirtyFlags = 0;
+
+		if(flags & kDirtyGain)
+		{
+			float effectiveGain = gain;
+			if(muted || bus.effectivelyMuted)
+			{
+				effectiveGain = 0;
+			}
+			else if(nil != bus)
+			{
+				effectiveGain *= bus.effectiveGain;
+			}
+			[ALWrapper sourcef:sourceId parameter:AL_GAIN value:effectiveGain];
+		}
+		if(flags & kDirtyPitch)
+		{
+			float effectivePitch = parameters.pitch;
+			if(nil != bus)
+			{
+				effectivePitch *= bus.effectivePitch;
+			}
+			[ALWrapper sourcef:sourceId parameter:AL_PITCH value:effectivePitch];
+		}
+		if(flags & kDirtyMaxDistance)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_MAX_DISTANCE value:parameters.maxDistance];
+		}
+		if(flags & kDirtyRolloffFactor)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_ROLLOFF_FACTOR value:parameters.rolloffFactor];
+		}
+		if(flags & kDirtyReferenceDistance)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_REFERENCE_DISTANCE value:parameters.referenceDistance];
+		}
+		if(flags & kDirtyMinGain)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_MIN_GAIN value:parameters.minGain];
+		}
+		if(flags & kDirtyMaxGain)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_MAX_GAIN value:parameters.maxGain];
+		}
+		if(flags & kDirtyConeOuterGain)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_CONE_OUTER_GAIN value:parameters.coneOuterGain];
+		}
+		if(flags & kDirtyConeInnerAngle)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_CONE_INNER_ANGLE value:parameters.coneInnerAngle];
+		}
+		if(flags & kDirtyConeOuterAngle)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_CONE_OUTER_ANGLE value:parameters.coneOuterAngle];
+		}
+		if(flags & kDirtyPosition)
+		{
+			[ALWrapper source3f:sourceId
+					  parameter:AL_POSITION
+							 v1:parameters.position.x
+							 v2:parameters.position.y
+							 v3:parameters.position.z];
+		}
+		if(flags & kDirtyVelocity)
+		{
+			[ALWrapper source3f:sourceId
+					  parameter:AL_VELOCITY
+							 v1:parameters.velocity.x
+							 v2:parameters.velocity.y
+							 v3:parameters.velocity.z];
+		}
+		if(flags & kDirtyDirection)
+		{
+			[ALWrapper source3f:sourceId
+					  parameter:AL_DIRECTION
+							 v1:parameters.direction.x
+							 v2:parameters.direction.y
+							 v3:parameters.direction.z];
+		}
+		if(flags & kDirtySourceRelative)
+		{
+			[ALWrapper sourcei:sourceId parameter:AL_SOURCE_RELATIVE value:parameters.sourceRelative];
+		}
+		if(flags & kDirtyLooping)
+		{
+			// While the intro slice is queued, looping would repeat it too.
+			[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:parameters.looping && nil == introBuffer];
+		}
+	}
+}
+
+- (void) notifyBusChanged
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		[self markDirty:kDirtyGain | kDirtyPitch];
+	}
+}
+
 
 #pragma mark Suspend Handler
 
@@ -910,11 +1462,16 @@ initFailed:
 
 - (void) setSuspended:(bool) value
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
         if(value)
         {
-            shadowState = self.state;
+            if(virtualized && ![self devirtualize])
+            {
+                [ALWrapper sourceStop:sourceId];
+                OAL_ATOMIC_STORE(&shadowState, AL_STOPPED);
+            }
+            OAL_ATOMIC_STORE(&shadowState, self.state);
             if(AL_PLAYING == shadowState)
             {
                 [ALWrapper sourcePause:sourceId];
@@ -936,11 +1493,11 @@ initFailed:
 
 - (void) delayedResumePlayback
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
-        if(!abortPlaybackResume)
+        if(!abortPlaybackResume && [ALWrapper sourcePlay:sourceId] && loopSwitchPending)
         {
-            [ALWrapper sourcePlay:sourceId];
+            [self scheduleLoopSwitch];
         }
     }
 }
@@ -950,7 +1507,7 @@ initFailed:
 
 - (void) preload:(ALBuffer*) bufferIn
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -971,7 +1528,7 @@ initFailed:
 
 - (id<ALSoundSource>) play
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -983,7 +1540,7 @@ initFailed:
 
 		if(self.playing)
 		{
-			if(!interruptible)
+			if(!self.interruptible)
 			{
 				return nil;
 			}
@@ -995,18 +1552,28 @@ initFailed:
 			[self stop];
 		}
 		
-		if([ALWrapper sourcePlay:sourceId])
+		[self commitParameters];
+		if([self sourcePlay])
 		{
-			shadowState = AL_PLAYING;
+			OAL_ATOMIC_STORE(&shadowState, AL_PLAYING);
 		}
 		else
 		{
-			shadowState = AL_STOPPED;
+			OAL_ATOMIC_STORE(&shadowState, AL_STOPPED);
 		}
 	}
 	return self;
 }
 
+- (id<ALSoundSource>) playAtSampleTime:(int64_t) sampleTime
+{
+	if(![context playSources:[NSArray arrayWithObject:self] atSampleTime:sampleTime])
+	{
+		return nil;
+	}
+	return self;
+}
+
 - (id<ALSoundSource>) play:(ALBuffer*) bufferIn
 {
 	return [self play:bufferIn loop:NO];
@@ -1014,7 +1581,7 @@ initFailed:
 
 - (id<ALSoundSource>) play:(ALBuffer*) bufferIn loop:(bool) loop
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1026,7 +1593,7 @@ initFailed:
 
 		if(self.playing)
 		{
-			if(!interruptible)
+			if(!self.interruptible)
 			{
 				return nil;
 			}
@@ -1036,13 +1603,14 @@ initFailed:
 		self.buffer = bufferIn;
 		self.looping = loop;
 		
-		if([ALWrapper sourcePlay:sourceId])
+		[self commitParameters];
+		if([self sourcePlay])
 		{
-			shadowState = AL_PLAYING;
+			OAL_ATOMIC_STORE(&shadowState, AL_PLAYING);
 		}
 		else
 		{
-			shadowState = AL_STOPPED;
+			OAL_ATOMIC_STORE(&shadowState, AL_STOPPED);
 		}
 	}
 	return self;
@@ -1050,7 +1618,7 @@ initFailed:
 
 - (id<ALSoundSource>) play:(ALBuffer*) bufferIn gain:(float) gainIn pitch:(float) pitchIn pan:(float) panIn loop:(bool) loopIn
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1062,7 +1630,7 @@ initFailed:
 
 		if(self.playing)
 		{
-			if(!interruptible)
+			if(!self.interruptible)
 			{
 				return nil;
 			}
@@ -1077,21 +1645,49 @@ initFailed:
 		self.pan = panIn;
 		self.looping = loopIn;
 		
-		if([ALWrapper sourcePlay:sourceId])
+		[self commitParameters];
+		if([self sourcePlay])
 		{
-			shadowState = AL_PLAYING;
+			OAL_ATOMIC_STORE(&shadowState, AL_PLAYING);
 		}
 		else
 		{
-			shadowState = AL_STOPPED;
+			OAL_ATOMIC_STORE(&shadowState, AL_STOPPED);
 		}
 	}		
 	return self;
 }
 
+- (id<ALSoundSource>) play:(ALBuffer*) bufferIn loop:(bool) loop atSampleTime:(int64_t) sampleTime
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(self.suspended)
+		{
+			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+			return nil;
+		}
+
+		[self stopActions];
+
+		if(self.playing)
+		{
+			if(!self.interruptible)
+			{
+				return nil;
+			}
+			[self stop];
+		}
+
+		self.buffer = bufferIn;
+		self.looping = loop;
+	}
+	return [self playAtSampleTime:sampleTime];
+}
+
 - (void) stop
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1100,15 +1696,18 @@ initFailed:
 		}
 		
 		abortPlaybackResume = YES;
+		OAL_ATOMIC_STORE(&startPending, NO);
+		virtualized = NO;
 		[self stopActions];
 		[ALWrapper sourceStop:sourceId];
-		shadowState = AL_STOPPED;
+		loopSwitchPending = NO;
+		OAL_ATOMIC_STORE(&shadowState, AL_STOPPED);
 	}
 }
 
 - (void) rewind
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1117,9 +1716,12 @@ initFailed:
 		}
 		
 		abortPlaybackResume = YES;
+		OAL_ATOMIC_STORE(&startPending, NO);
+		virtualized = NO;
 		[self stopActions];
 		[ALWrapper sourceRewind:sourceId];
-		shadowState = AL_INITIAL;
+		loopSwitchPending = NO;
+		OAL_ATOMIC_STORE(&shadowState, AL_INITIAL);
 	}
 }
 
@@ -1128,8 +1730,9 @@ initFailed:
 		 target:(id) target
 	   selector:(SEL) selector
 {
+	float startValue;
 	// Must always be synchronized
-	@synchronized(self)
+	ALWAYS_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1137,20 +1740,22 @@ initFailed:
 			return;
 		}
 		
-		[self stopFade];
-		gainAction = [OALSequentialActions actions:
-                      [OALPropertyAction gainActionWithDuration:duration endValue:value],
-                      [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                      nil];
-        gainAction = as_retain(gainAction);
-		[gainAction runWithTarget:self];
+		if(nil == gainAction)
+		{
+			gainAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"gain"];
+		}
+		startValue = self.gain;
 	}
+
+	// The ramp calls back into our setters from the action manager, so it
+	// is started outside of our lock (see OALActionManager).
+	[gainAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
 }
 
 - (void) stopFade
 {
 	// Must always be synchronized
-	@synchronized(self)
+	ALWAYS_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1158,9 +1763,7 @@ initFailed:
 			return;
 		}
 		
-		[gainAction stopAction];
-		as_release(gainAction);
-		gainAction = nil;
+		[gainAction cancel];
 	}
 }
 
@@ -1169,8 +1772,9 @@ initFailed:
 		 target:(id) target
 	   selector:(SEL) selector
 {
+	float startValue;
 	// Must always be synchronized
-	@synchronized(self)
+	ALWAYS_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1178,20 +1782,20 @@ initFailed:
 			return;
 		}
 		
-		[self stopPan];
-		panAction = [OALSequentialActions actions:
-                     [OALPropertyAction panActionWithDuration:duration endValue:value],
-                     [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                     nil];
-        panAction = as_retain(panAction);
-		[panAction runWithTarget:self];
+		if(nil == panAction)
+		{
+			panAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"pan"];
+		}
+		startValue = self.pan;
 	}
+
+	[panAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
 }
 
 - (void) stopPan
 {
 	// Must always be synchronized
-	@synchronized(self)
+	ALWAYS_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1199,9 +1803,7 @@ initFailed:
 			return;
 		}
 		
-		[panAction stopAction];
-		as_release(panAction);
-		panAction = nil;
+		[panAction cancel];
 	}
 }
 
@@ -1210,8 +1812,9 @@ initFailed:
 		target:(id) target
 	  selector:(SEL) selector
 {
+	float startValue;
 	// Must always be synchronized
-	@synchronized(self)
+	ALWAYS_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1219,20 +1822,20 @@ initFailed:
 			return;
 		}
 		
-		[self stopPitch];
-		pitchAction = [OALSequentialActions actions:
-                       [OALPropertyAction pitchActionWithDuration:duration endValue:value],
-					   [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-					   nil];
-        pitchAction = as_retain(pitchAction);
-		[pitchAction runWithTarget:self];
+		if(nil == pitchAction)
+		{
+			pitchAction = [[OALRampAction alloc] initWithTarget:self propertyKey:@"pitch"];
+		}
+		startValue = self.pitch;
 	}
+
+	[pitchAction rampFrom:startValue to:value duration:duration callTarget:target selector:selector];
 }
 
 - (void) stopPitch
 {
 	// Must always be synchronized
-	@synchronized(self)
+	ALWAYS_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1240,9 +1843,7 @@ initFailed:
 			return;
 		}
 		
-		[pitchAction stopAction];
-		as_release(pitchAction);
-		pitchAction = nil;
+		[pitchAction cancel];
 	}
 }
 
@@ -1255,7 +1856,7 @@ initFailed:
 
 - (void) clear
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		self.manuallySuspended = NO;
 		[self stop];
@@ -1264,6 +1865,175 @@ initFailed:
 }
 
 
+#pragma mark Loop Points
+
+- (bool) sourcePlay
+{
+	[self prepareLoopPoints];
+	if(![ALWrapper sourcePlay:sourceId])
+	{
+		return NO;
+	}
+	[self scheduleLoopSwitch];
+	return YES;
+}
+
+- (void) prepareLoopPoints
+{
+	if(!parameters.looping || !buffer.hasLoopPoints || buffer.nativeLoopPoints)
+	{
+		if(nil != introBuffer || nil != loopBuffer)
+		{
+			// Back to playing the whole buffer.
+			[ALWrapper sourcei:sourceId parameter:AL_BUFFER value:(ALint)buffer.bufferId];
+			[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:parameters.looping];
+			[self releaseLoopSlices];
+		}
+		return;
+	}
+
+	// The buffer keeps its slices, so replaying it doesn't make new buffers.
+	[ALWrapper sourcei:sourceId parameter:AL_BUFFER value:AL_NONE];
+	[self releaseLoopSlices];
+
+	ALint loopStart = buffer.loopStart;
+	loopBuffer = as_retain(buffer.loopSlice);
+	if(loopStart > 0)
+	{
+		introBuffer = as_retain(buffer.introSlice);
+	}
+	if(nil == loopBuffer || (loopStart > 0 && nil == introBuffer))
+	{
+		OAL_LOG_WARNING(@"%@: Could not slice %@ at its loop points. Looping the whole buffer", self, buffer);
+		[self releaseLoopSlices];
+		[ALWrapper sourcei:sourceId parameter:AL_BUFFER value:(ALint)buffer.bufferId];
+		[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:YES];
+		return;
+	}
+
+	if(nil == introBuffer)
+	{
+		[ALWrapper sourcei:sourceId parameter:AL_BUFFER value:(ALint)loopBuffer.bufferId];
+		[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:YES];
+		return;
+	}
+
+	// Queue the loop enough times behind the intro that it keeps going even
+	// if serviceLoopQueue gets to it late.
+	double loopSeconds = (double)loopBuffer.frames / (double)loopBuffer.frequency;
+	float pitch = parameters.pitch > 1 ? parameters.pitch : 1;
+	int copies = loopSeconds > 0 ? (int)ceil(kLoopQueueSeconds * pitch / loopSeconds) : 1;
+	copies = MAX(1, MIN(copies, kMaxLoopCopies));
+
+	ALuint bufferIds[kMaxLoopCopies + 1];
+	bufferIds[0] = introBuffer.bufferId;
+	for(int i = 1; i <= copies; i++)
+	{
+		bufferIds[i] = loopBuffer.bufferId;
+	}
+	[ALWrapper sourceQueueBuffers:sourceId numBuffers:copies + 1 bufferIds:bufferIds];
+	[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:NO];
+}
+
+- (void) scheduleLoopSwitch
+{
+	if(nil == introBuffer)
+	{
+		return;
+	}
+
+	loopSwitchPending = YES;
+	[context notifySourceLoopPending:self];
+	if(loopCheckScheduled)
+	{
+		return;
+	}
+	loopCheckScheduled = YES;
+
+	float pitch = parameters.pitch > 0 ? parameters.pitch : 1;
+	ALint played = [ALWrapper getSourcei:sourceId parameter:AL_SAMPLE_OFFSET];
+	double remaining = (double)(introBuffer.frames - played) / (double)introBuffer.frequency / pitch;
+	[self scheduleLoopCheck:MAX(remaining, 0) + kLoopSwitchMargin];
+}
+
+- (void) scheduleLoopCheck:(double) delay
+{
+	OALWeakReference* reference = [OALWeakReference referenceWithTarget:self];
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+				   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0),
+				   ^{
+					   [(ALSource*)reference.target runLoopCheck];
+				   });
+}
+
+- (void) runLoopCheck
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if([self serviceLoopQueue] && !self.suspended && !self.paused)
+		{
+			[self scheduleLoopCheck:kLoopCheckInterval];
+			return;
+		}
+		loopCheckScheduled = NO;
+	}
+}
+
+- (bool) serviceLoopQueue
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(!loopSwitchPending || nil == introBuffer)
+		{
+			loopSwitchPending = NO;
+			return NO;
+		}
+
+		ALint processed = [ALWrapper getSourcei:sourceId parameter:AL_BUFFERS_PROCESSED];
+		if(self.suspended || processed < 1)
+		{
+			// Still in the intro (or paused, or slowed down by pitch).
+			return YES;
+		}
+
+		// Past the intro, so the queue only holds copies of the loop now.
+		// Put back the ones that played, and loop the whole queue.
+		bool ranDry = AL_STOPPED == [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
+		ALuint bufferIds[kMaxLoopCopies + 1];
+		processed = MIN(processed, kMaxLoopCopies + 1);
+		[ALWrapper sourceUnqueueBuffers:sourceId numBuffers:processed bufferIds:bufferIds];
+		for(ALint i = 0; i < processed - 1; i++)
+		{
+			bufferIds[i] = loopBuffer.bufferId;
+		}
+		if(processed > 1)
+		{
+			[ALWrapper sourceQueueBuffers:sourceId numBuffers:processed - 1 bufferIds:bufferIds];
+		}
+		as_release(introBuffer);
+		introBuffer = nil;
+		loopSwitchPending = NO;
+		[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:parameters.looping];
+
+		if(ranDry)
+		{
+			OAL_LOG_WARNING(@"%@: Played all of the queued loop copies before switching to looping", self);
+			[ALWrapper sourcePlay:sourceId];
+		}
+	}
+	return NO;
+}
+
+- (void) releaseLoopSlices
+{
+	loopSwitchPending = NO;
+	as_release(introBuffer);
+	introBuffer = nil;
+	as_release(loopBuffer);
+	loopBuffer = nil;
+}
+
+
 #pragma mark Queued Playback
 
 - (bool) queueBuffer:(ALBuffer*) bufferIn
@@ -1273,7 +2043,7 @@ initFailed:
 
 - (bool) queueBuffer:(ALBuffer*) bufferIn repeats:(NSUInteger) repeats
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1306,7 +2076,7 @@ initFailed:
 
 - (bool) queueBuffers:(NSArray*) buffers repeats:(NSUInteger) repeats
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1341,7 +2111,7 @@ initFailed:
 
 - (bool) unqueueBuffer:(ALBuffer*) bufferIn
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1356,7 +2126,7 @@ initFailed:
 
 - (bool) unqueueBuffers:(NSArray*) buffers
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.suspended)
 		{
@@ -1386,30 +2156,68 @@ initFailed:
 
 + (void) notifySourceAllocated:(ALSource*) source
 {
-    @synchronized(g_allSourcesByID)
+    ALuint sid = source.sourceId;
+    OAL_LOCK_SCOPE(&g_sourceTableLock)
     {
-        [g_allSourcesByID setObject:source forKey:[NSNumber numberWithUnsignedInt:source.sourceId]];
+        ALuint index = sourceTableIndex(sid);
+        for(int i = 0; i < kSourceTableCapacity; i++)
+        {
+            OALSourceTableSlot* slot = &g_sourceTable[index];
+            ALuint slotId = slot->sourceId;
+            if(kSourceTableEmptySlot == slotId || kSourceTableRemovedSlot == slotId || sid == slotId)
+            {
+                // Publish the source before the id so that readers never see a stale source.
+                __atomic_store_n(&slot->source, (as_bridge void*) source, __ATOMIC_RELEASE);
+                __atomic_store_n(&slot->sourceId, sid, __ATOMIC_RELEASE);
+                return;
+            }
+            index = (index + 1) & (kSourceTableCapacity - 1);
+        }
     }
+    OAL_LOG_WARNING(@"%@: Source table is full. Notifications will not be delivered to this source", source);
 }
 
 + (void) notifySourceDeallocated:(ALSource*) source
 {
-    @synchronized(g_allSourcesByID)
+    ALuint sid = source.sourceId;
+    OAL_LOCK_SCOPE(&g_sourceTableLock)
     {
-        [g_allSourcesByID removeObjectForKey:[NSNumber numberWithUnsignedInt:source.sourceId]];
+        ALuint index = sourceTableIndex(sid);
+        for(int i = 0; i < kSourceTableCapacity; i++)
+        {
+            OALSourceTableSlot* slot = &g_sourceTable[index];
+            if(sid == slot->sourceId && (as_bridge void*) source == slot->source)
+            {
+                __atomic_store_n(&slot->sourceId, kSourceTableRemovedSlot, __ATOMIC_RELEASE);
+                __atomic_store_n(&slot->source, NULL, __ATOMIC_RELEASE);
+                break;
+            }
+            if(kSourceTableEmptySlot == slot->sourceId)
+            {
+                break;
+            }
+            index = (index + 1) & (kSourceTableCapacity - 1);
+        }
     }
+
+    // A notification may have found this source just before it left the table.
+    waitForNotificationsInFlight();
 }
 
 - (void) registerNotification:(ALuint) notificationID
                      callback:(OALSourceNotificationCallback) callback
                      userData:(void*) userData
 {
-    NSNumber* key = [NSNumber numberWithUnsignedInt:notificationID];
-    OPTIONALLY_SYNCHRONIZED(self)
+    int index = notificationIndex(notificationID);
+    if(index < 0)
     {
-        [self unregisterNotification:notificationID];
-        [self.notificationCallbacks setObject:as_autorelease([callback copy])
-                                       forKey:key];
+        OAL_LOG_WARNING(@"%@: Unsupported notification type %04x", self, notificationID);
+        return;
+    }
+    OPTIONALLY_LOCKED(self, &lock)
+    {
+        [self removeNotificationAtIndex:index];
+        __atomic_store_n(&notificationCallbacks[index], (as_bridge_retained void*)[callback copy], __ATOMIC_RELEASE);
         [ALWrapper addNotification:notificationID
                           onSource:self.sourceId
                           callback:alSourceNotification
@@ -1419,45 +2227,58 @@ initFailed:
 
 - (void) unregisterNotification:(ALuint) notificationID
 {
-    NSNumber* key = [NSNumber numberWithUnsignedInt:notificationID];
-    OPTIONALLY_SYNCHRONIZED(self)
+    int index = notificationIndex(notificationID);
+    if(index < 0)
     {
-        if([self.notificationCallbacks objectForKey:key] != nil)
-        {
-            [self.notificationCallbacks removeObjectForKey:key];
-            [ALWrapper removeNotification:notificationID
-                                 onSource:self.sourceId
-                                 callback:alSourceNotification
-                                 userData:NULL];
-        }
+        return;
+    }
+    OPTIONALLY_LOCKED(self, &lock)
+    {
+        [self removeNotificationAtIndex:index];
     }
 }
 
 - (void) unregisterAllNotifications
 {
-    OPTIONALLY_SYNCHRONIZED(self)
+    OPTIONALLY_LOCKED(self, &lock)
     {
-        for(NSNumber* key in [self.notificationCallbacks allKeys])
+        for(int i = 0; i < kALSourceNotificationTypes; i++)
         {
-            [ALWrapper removeNotification:[key unsignedIntValue]
-                                 onSource:self.sourceId
-                                 callback:alSourceNotification
-                                 userData:NULL];
+            [self removeNotificationAtIndex:i];
         }
-        [self.notificationCallbacks removeAllObjects];
     }
 }
 
-- (void) receiveNotification:(ALuint) notificationID userData:(void*) userData
+- (void) removeNotificationAtIndex:(int) index
 {
-    NSNumber* key = [NSNumber numberWithUnsignedInt:notificationID];
-    OPTIONALLY_SYNCHRONIZED(self)
+    void* callbackRef = __atomic_exchange_n(&notificationCallbacks[index], NULL, __ATOMIC_ACQ_REL);
+    if(NULL == callbackRef)
     {
-        OALSourceNotificationCallback callback = [self.notificationCallbacks objectForKey:key];
-        if(callback != nil)
-        {
-            callback(self, notificationID, userData);
-        }
+        return;
+    }
+
+    [ALWrapper removeNotification:g_notificationTypes[index]
+                         onSource:self.sourceId
+                         callback:alSourceNotification
+                         userData:NULL];
+
+    OALSourceNotificationCallback callback = (as_bridge_transfer OALSourceNotificationCallback) callbackRef;
+    if(t_notificationsInFlight > 0)
+    {
+        // This may be the callback that's running, so let it finish first.
+        as_autorelease(callback);
+        return;
+    }
+    waitForNotificationsInFlight();
+    as_release(callback);
+}
+
+- (void) receiveNotification:(ALuint) notificationID index:(int) index userData:(void*) userData
+{
+    void* callbackRef = __atomic_load_n(&notificationCallbacks[index], __ATOMIC_ACQUIRE);
+    if(NULL != callbackRef)
+    {
+        ((as_bridge OALSourceNotificationCallback) callbackRef)(self, notificationID, userData);
     }
 }
 
@@ -1466,7 +2287,7 @@ initFailed:
 
 - (bool) requestUnreserve:(bool) interrupt
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OPTIONALLY_LOCKED(self, &lock)
 	{
 		if(self.playing)
 		{
@@ -1481,5 +2302,379 @@ initFailed:
 	return YES;
 }
 
+- (bool) prepareScheduledStart
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(self.suspended)
+		{
+			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+			return NO;
+		}
+
+		[self stopActions];
+
+		if(self.playing)
+		{
+			if(!self.interruptible)
+			{
+				return NO;
+			}
+			[self stop];
+		}
+
+		if(self.paused)
+		{
+			[self stop];
+		}
+
+		[self commitParameters];
+		[self prepareLoopPoints];
+		OAL_ATOMIC_STORE(&startPending, YES);
+	}
+	return YES;
+}
+
+- (bool) takeScheduledStart
+{
+	return __atomic_exchange_n(&startPending, NO, __ATOMIC_ACQ_REL);
+}
+
+- (void) notifyScheduledStart:(bool) started
+{
+	OAL_ATOMIC_STORE(&startPending, NO);
+	OAL_ATOMIC_STORE(&shadowState, started ? AL_PLAYING : AL_STOPPED);
+	if(started)
+	{
+		OPTIONALLY_LOCKED(self, &lock)
+		{
+			[self scheduleLoopSwitch];
+		}
+	}
+}
+
+- (float) currentVirtualOffset
+{
+	float pitch = parameters.pitch;
+	if(nil != bus)
+	{
+		pitch *= bus.effectivePitch;
+	}
+	// Wall clock time, since OpenAL keeps playing in real time whatever
+	// OALClockSetTimeScale() is set to.
+	return virtualOffset + (float)(OALClockMonotonicSeconds() - virtualStartTime) * pitch;
+}
+
+- (bool) devirtualize
+{
+	float offset = [self currentVirtualOffset];
+	float duration = buffer.duration;
+	virtualized = NO;
+	if(duration > 0 && offset >= duration)
+	{
+		if(!parameters.looping)
+		{
+			return NO;
+		}
+		offset = fmodf(offset, duration);
+	}
+	[ALWrapper sourcef:sourceId parameter:AL_SEC_OFFSET value:offset];
+	return YES;
+}
+
+/** Estimate a source's gain at the listener, following the OpenAL 1.1 distance and cone model.
+ */
+static float estimateAudibleGain(const ALSourceParameters* p,
+								 float sourceGain,
+								 ALPoint listenerPosition,
+								 ALenum distanceModel)
+{
+	// Vector from the source to the listener.
+	float dx = -p->position.x;
+	float dy = -p->position.y;
+	float dz = -p->position.z;
+	if(!p->sourceRelative)
+	{
+		dx += listenerPosition.x;
+		dy += listenerPosition.y;
+		dz += listenerPosition.z;
+	}
+	float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+
+	float ref = p->referenceDistance;
+	float rolloff = p->rolloffFactor;
+	float maxDistance = p->maxDistance;
+	float attenuation = 1.0f;
+	switch(distanceModel)
+	{
+		case AL_INVERSE_DISTANCE_CLAMPED:
+		case AL_LINEAR_DISTANCE_CLAMPED:
+		case AL_EXPONENT_DISTANCE_CLAMPED:
+			distance = fmaxf(distance, ref);
+			distance = fminf(distance, maxDistance);
+			break;
+		default:
+			break;
+	}
+	switch(distanceModel)
+	{
+		case AL_INVERSE_DISTANCE:
+		case AL_INVERSE_DISTANCE_CLAMPED:
+		{
+			float denominator = ref + rolloff * (distance - ref);
+			if(denominator > 0)
+			{
+				attenuation = ref / denominator;
+			}
+			break;
+		}
+		case AL_LINEAR_DISTANCE:
+		case AL_LINEAR_DISTANCE_CLAMPED:
+			if(maxDistance > ref)
+			{
+				attenuation = 1.0f - rolloff * (distance - ref) / (maxDistance - ref);
+			}
+			break;
+		case AL_EXPONENT_DISTANCE:
+		case AL_EXPONENT_DISTANCE_CLAMPED:
+			if(distance > 0 && ref > 0)
+			{
+				attenuation = powf(distance / ref, -rolloff);
+			}
+			break;
+		default:
+			break;
+	}
+	attenuation = fmaxf(attenuation, 0);
+
+	// Directional sources are quieter outside their cone.
+	float cone = 1.0f;
+	float directionLength = sqrtf(p->direction.x*p->direction.x +
+								  p->direction.y*p->direction.y +
+								  p->direction.z*p->direction.z);
+	float toListenerLength = sqrtf(dx*dx + dy*dy + dz*dz);
+	if(directionLength > 0 && toListenerLength > 0)
+	{
+		float cosine = (p->direction.x*dx + p->direction.y*dy + p->direction.z*dz) / (directionLength * toListenerLength);
+		float angle = acosf(fmaxf(-1.0f, fminf(1.0f, cosine))) * (float)(360.0 / M_PI);
+		if(angle >= p->coneOuterAngle)
+		{
+			cone = p->coneOuterGain;
+		}
+		else if(angle > p->coneInnerAngle)
+		{
+			float t = (angle - p->coneInnerAngle) / (p->coneOuterAngle - p->coneInnerAngle);
+			cone = 1.0f + (p->coneOuterGain - 1.0f) * t;
+		}
+	}
+
+	float result = sourceGain * attenuation * cone;
+	return fminf(fmaxf(result, p->minGain), p->maxGain);
+}
+
+- (float) estimatedGainAtListenerPosition:(ALPoint) listenerPosition
+							distanceModel:(ALenum) distanceModel
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(muted || bus.effectivelyMuted)
+		{
+			return 0;
+		}
+		float sourceGain = gain;
+		if(nil != bus)
+		{
+			sourceGain *= bus.effectiveGain;
+		}
+		return estimateAudibleGain(&parameters, sourceGain, listenerPosition, distanceModel);
+	}
+}
+
+- (void) updateCullingWithListenerPosition:(ALPoint) listenerPosition
+							  listenerGain:(float) listenerGain
+							 distanceModel:(ALenum) distanceModel
+								 cullBelow:(float) cullThreshold
+							  restoreAbove:(float) restoreThreshold
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		// Queued buffers can't be restored to an offset, so streams are left alone.
+		if(self.suspended || nil == buffer || OAL_ATOMIC_LOAD(&startPending))
+		{
+			return;
+		}
+
+		float audibleGain = [self estimatedGainAtListenerPosition:listenerPosition distanceModel:distanceModel] * listenerGain;
+
+		if(virtualized)
+		{
+			if(!parameters.looping && [self currentVirtualOffset] >= buffer.duration)
+			{
+				// It would have finished by now.
+				[self stop];
+				return;
+			}
+			if(audibleGain >= restoreThreshold)
+			{
+				if([self devirtualize])
+				{
+					[ALWrapper sourcePlay:sourceId];
+				}
+				else
+				{
+					[self stop];
+				}
+			}
+			return;
+		}
+
+		if(audibleGain < cullThreshold &&
+		   AL_PLAYING == OAL_ATOMIC_LOAD(&shadowState) &&
+		   AL_PLAYING == self.state)
+		{
+			virtualOffset = [ALWrapper getSourcef:sourceId parameter:AL_SEC_OFFSET];
+			virtualStartTime = OALClockMonotonicSeconds();
+			virtualized = YES;
+			[ALWrapper sourcePause:sourceId];
+		}
+	}
+}
+
+- (float) occlusionScoreAtListenerPosition:(ALPoint) listenerPosition
+									  time:(double) now
+								  position:(ALPoint*) position
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(self.suspended || virtualized || parameters.sourceRelative ||
+		   AL_PLAYING != OAL_ATOMIC_LOAD(&shadowState))
+		{
+			return 0;
+		}
+
+		float dx = parameters.position.x - listenerPosition.x;
+		float dy = parameters.position.y - listenerPosition.y;
+		float dz = parameters.position.z - listenerPosition.z;
+		float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+
+		*position = parameters.position;
+		// Never queried yet: Go first.
+		float age = occlusionQueryTime < 0 ? FLT_MAX / 2 : (float)(now - occlusionQueryTime);
+		return age * occlusionPriority / fmaxf(distance, fmaxf(parameters.referenceDistance, 1.0f));
+	}
+}
+
+- (void) setOcclusionTarget:(float) occlusion obstruction:(float) obstruction time:(double) now
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		occlusionTarget = occlusion;
+		obstructionTarget = obstruction;
+		occlusionQueryTime = now;
+		occlusionGliding = occlusion != reverbOcclusion || obstruction != reverbObstruction;
+	}
+}
+
+- (void) smoothOcclusion:(float) amount
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(!occlusionGliding || self.suspended)
+		{
+			return;
+		}
+
+		reverbOcclusion += (occlusionTarget - reverbOcclusion) * amount;
+		reverbObstruction += (obstructionTarget - reverbObstruction) * amount;
+		if(fabsf(occlusionTarget - reverbOcclusion) < kALOcclusionSnapDistance &&
+		   fabsf(obstructionTarget - reverbObstruction) < kALOcclusionSnapDistance)
+		{
+			reverbOcclusion = occlusionTarget;
+			reverbObstruction = obstructionTarget;
+			occlusionGliding = NO;
+		}
+		[self applyOcclusion];
+	}
+}
+
+- (uint32_t) storePosition:(const ALPoint*) position
+				  velocity:(const ALVector*) velocity
+				  sequence:(uint32_t*) sequence
+{
+	uint32_t changed = 0;
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(self.suspended)
+		{
+			return 0;
+		}
+
+		if(NULL != position &&
+		   (parameters.position.x != position->x ||
+			parameters.position.y != position->y ||
+			parameters.position.z != position->z))
+		{
+			parameters.position = *position;
+			changed |= kALSourcePositionChanged;
+		}
+		if(NULL != velocity &&
+		   (parameters.velocity.x != velocity->x ||
+			parameters.velocity.y != velocity->y ||
+			parameters.velocity.z != velocity->z))
+		{
+			parameters.velocity = *velocity;
+			changed |= kALSourceVelocityChanged;
+		}
+
+		// The caller is sending these now, so a pending commit doesn't need to.
+		if(changed & kALSourcePositionChanged)
+		{
+			dirtyFlags &= ~(uint32_t)kDirtyPosition;
+		}
+		if(changed & kALSourceVelocityChanged)
+		{
+			dirtyFlags &= ~(uint32_t)kDirtyVelocity;
+		}
+		if(0 != changed)
+		{
+			motionSequence++;
+		}
+		*sequence = motionSequence;
+	}
+	return changed;
+}
+
+- (void) resendMotionIfChangedSince:(uint32_t) sequence
+{
+	OPTIONALLY_LOCKED(self, &lock)
+	{
+		if(sequence == motionSequence)
+		{
+			return;
+		}
+
+		dirtyFlags &= ~(uint32_t)(kDirtyPosition | kDirtyVelocity);
+		[ALWrapper source3f:sourceId
+				  parameter:AL_POSITION
+						 v1:parameters.position.x
+						 v2:parameters.position.y
+						 v3:parameters.position.z];
+		[ALWrapper source3f:sourceId
+				  parameter:AL_VELOCITY
+						 v1:parameters.velocity.x
+						 v2:parameters.velocity.y
+						 v3:parameters.velocity.z];
+	}
+}
+
+
+ALSource* ALSourceFromSpatialItem(void* item)
+{
+#if __has_feature(objc_arc)
+	return *(__weak id*)item;
+#else
+	return objc_loadWeak((id*)item);
+#endif
+}
 
 @end
@@ -69,6 +69,18 @@ typedef struct
 	ALVector up;
 } ALOrientation;
 
+/**
+ * A source's playback offset, and how long it takes for audio at that offset to
+ * be heard. The two are read together, so they describe the same moment.
+ */
+typedef struct
+{
+	/** The playback offset, in seconds. */
+	double offset;
+	/** The time until the audio at offset reaches the output, in seconds. */
+	double latency;
+} ALOffsetLatency;
+
 
 #pragma mark -
 #pragma mark Convenience Methods
@@ -37,6 +37,110 @@
 #endif
 
 
+#pragma mark OpenAL Soft Extension Tokens
+
+/* Tokens from OpenAL Soft extensions. Apple's OpenAL headers don't define these,
+ * so they are provided here for when ObjectAL runs on top of OpenAL Soft.
+ */
+
+/** 64-bit integer type used by OpenAL Soft extensions. */
+typedef int64_t ALint64SOFT_OAL;
+
+#ifndef ALC_DEVICE_CLOCK_SOFT
+/* ALC_SOFT_device_clock */
+#define ALC_DEVICE_CLOCK_SOFT 0x1600
+#define ALC_DEVICE_LATENCY_SOFT 0x1601
+#define ALC_DEVICE_CLOCK_LATENCY_SOFT 0x1602
+#define AL_SAMPLE_OFFSET_CLOCK_SOFT 0x1202
+#define AL_SEC_OFFSET_CLOCK_SOFT 0x1203
+#endif
+
+#ifndef AL_SEC_OFFSET_LATENCY_SOFT
+/* AL_SOFT_source_latency */
+#define AL_SAMPLE_OFFSET_LATENCY_SOFT 0x1200
+#define AL_SEC_OFFSET_LATENCY_SOFT 0x1201
+#endif
+
+#ifndef ALC_HRTF_SOFT
+/* ALC_SOFT_HRTF */
+#define ALC_HRTF_SOFT 0x1992
+#define ALC_DONT_CARE_SOFT 0x0002
+#define ALC_HRTF_STATUS_SOFT 0x1993
+#define ALC_HRTF_DISABLED_SOFT 0x0000
+#define ALC_HRTF_ENABLED_SOFT 0x0001
+#define ALC_HRTF_DENIED_SOFT 0x0002
+#define ALC_HRTF_REQUIRED_SOFT 0x0003
+#define ALC_HRTF_HEADPHONES_DETECTED_SOFT 0x0004
+#define ALC_HRTF_UNSUPPORTED_FORMAT_SOFT 0x0005
+#define ALC_NUM_HRTF_SPECIFIERS_SOFT 0x1994
+#define ALC_HRTF_SPECIFIER_SOFT 0x1995
+#define ALC_HRTF_ID_SOFT 0x1996
+#endif
+
+#ifndef AL_LOOP_POINTS_SOFT
+/* AL_SOFT_loop_points */
+#define AL_LOOP_POINTS_SOFT 0x2015
+#endif
+
+#ifndef ALC_FORMAT_CHANNELS_SOFT
+/* ALC_SOFT_loopback */
+#define ALC_FORMAT_CHANNELS_SOFT 0x1990
+#define ALC_FORMAT_TYPE_SOFT 0x1991
+#define ALC_BYTE_SOFT 0x1400
+#define ALC_UNSIGNED_BYTE_SOFT 0x1401
+#define ALC_SHORT_SOFT 0x1402
+#define ALC_UNSIGNED_SHORT_SOFT 0x1403
+#define ALC_INT_SOFT 0x1404
+#define ALC_UNSIGNED_INT_SOFT 0x1405
+#define ALC_FLOAT_SOFT 0x1406
+#define ALC_MONO_SOFT 0x1500
+#define ALC_STEREO_SOFT 0x1501
+#define ALC_QUAD_SOFT 0x1503
+#define ALC_5POINT1_SOFT 0x1504
+#define ALC_6POINT1_SOFT 0x1505
+#define ALC_7POINT1_SOFT 0x1506
+#endif
+
+#ifndef AL_EFFECT_TYPE
+/* ALC_EXT_EFX */
+#define ALC_MAX_AUXILIARY_SENDS 0x20003
+#define AL_DIRECT_FILTER 0x20005
+#define AL_AUXILIARY_SEND_FILTER 0x20006
+#define AL_EFFECT_TYPE 0x8001
+#define AL_EFFECT_NULL 0x0000
+#define AL_EFFECT_REVERB 0x0001
+#define AL_REVERB_DENSITY 0x0001
+#define AL_REVERB_DIFFUSION 0x0002
+#define AL_REVERB_GAIN 0x0003
+#define AL_REVERB_GAINHF 0x0004
+#define AL_REVERB_DECAY_TIME 0x0005
+#define AL_REVERB_DECAY_HFRATIO 0x0006
+#define AL_REVERB_REFLECTIONS_GAIN 0x0007
+#define AL_REVERB_REFLECTIONS_DELAY 0x0008
+#define AL_REVERB_LATE_REVERB_GAIN 0x0009
+#define AL_REVERB_LATE_REVERB_DELAY 0x000A
+#define AL_REVERB_AIR_ABSORPTION_GAINHF 0x000B
+#define AL_REVERB_ROOM_ROLLOFF_FACTOR 0x000C
+#define AL_REVERB_DECAY_HFLIMIT 0x000D
+#define AL_EFFECTSLOT_NULL 0x0000
+#define AL_EFFECTSLOT_EFFECT 0x0001
+#define AL_EFFECTSLOT_GAIN 0x0002
+#define AL_EFFECTSLOT_AUXILIARY_SEND_AUTO 0x0003
+#define AL_FILTER_TYPE 0x8001
+#define AL_FILTER_NULL 0x0000
+#define AL_FILTER_LOWPASS 0x0001
+#define AL_FILTER_HIGHPASS 0x0002
+#define AL_FILTER_BANDPASS 0x0003
+#define AL_LOWPASS_GAIN 0x0001
+#define AL_LOWPASS_GAINHF 0x0002
+#define AL_HIGHPASS_GAIN 0x0001
+#define AL_HIGHPASS_GAINLF 0x0002
+#define AL_BANDPASS_GAIN 0x0001
+#define AL_BANDPASS_GAINLF 0x0002
+#define AL_BANDPASS_GAINHF 0x0003
+#endif
+
+
 /**
  * A thin wrapper around the C OpenAL API, with a few convenience methods thrown in.
  * Wherever possible, methods return the requested data rather than requiring a pointer to be
@@ -388,6 +492,23 @@
 			   v2:(ALfloat) v2
 			   v3:(ALfloat) v3;
 
+/** Write a 3 float paramter to many sources at once, checking for errors only once.
+ *
+ * @param sourceIds The sources' IDs.
+ * @param count The number of sources.
+ * @param parameter The parameter to write to.
+ * @param x The first value for each source.
+ * @param y The second value for each source.
+ * @param z The third value for each source.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) sources3f:(const ALuint*) sourceIds
+			 count:(ALsizei) count
+		 parameter:(ALenum) parameter
+				 x:(const ALfloat*) x
+				 y:(const ALfloat*) y
+				 z:(const ALfloat*) z;
+
 /** Write a float array paramter to a source.
  *
  * @param sourceId The source's ID.
@@ -814,6 +935,20 @@
  */
 + (void) suspendContext:(ALCcontext*) context;
 
+/** Start batching source and listener changes on a context.
+ * Changes made until endDeferredUpdates is called will be applied together.
+ * Uses AL_SOFT_deferred_updates if available, or alcSuspendContext otherwise.
+ *
+ * @param context The context to batch changes on.
+ */
++ (void) beginDeferredUpdates:(ALCcontext*) context;
+
+/** Apply all changes batched since beginDeferredUpdates.
+ *
+ * @param context The context that changes were batched on.
+ */
++ (void) endDeferredUpdates:(ALCcontext*) context;
+
 /** Destroy a context.
  *
  * @param context The contect to destroy.
@@ -1146,4 +1281,222 @@
                    callback:(alSourceNotificationProc) callback
                    userData:(void*) userData;
 
+
+#pragma mark OpenAL Soft extensions
+
+/** Get a 64-bit integer array attribute (ALC_SOFT_device_clock).
+ *
+ * @param device The device to read the attribute from.
+ * @param attribute The attribute to read (such as ALC_DEVICE_CLOCK_SOFT).
+ * @param size the size of the receiving array.
+ * @param data An array to store the values.
+ * @return TRUE if the operation was successful, FALSE if it failed or isn't supported.
+ */
++ (bool) getInteger64v:(ALCdevice*) device
+			 attribute:(ALenum) attribute
+				  size:(ALsizei) size
+				  data:(ALint64SOFT_OAL*) data;
+
+/** Check if source offsets can be read along with the output latency (AL_SOFT_source_latency).
+ *
+ * @return TRUE if getSourcedv:parameter:values: is available.
+ */
++ (bool) sourceLatencySupported;
+
+/** Get a double precision array parameter from a source (AL_SOFT_source_latency).
+ *
+ * @param sourceId The source's ID.
+ * @param parameter The parameter to fetch (such as AL_SEC_OFFSET_LATENCY_SOFT).
+ * @param values An array to hold the result.
+ * @return TRUE if the operation was successful, FALSE if it failed or isn't supported.
+ */
++ (bool) getSourcedv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALdouble*) values;
+
+/** Check if sources can be started at a device clock time (AL_SOFT_source_start_delay).
+ *
+ * @return TRUE if sourcePlay:atTime: and sourcePlayv:numSources:atTime: are available.
+ */
++ (bool) canPlayAtTime;
+
+/** Start a source at a time on the device clock (AL_SOFT_source_start_delay).
+ *
+ * @param sourceId The ID of the source to play.
+ * @param deviceTime The device clock time to start at, in nanoseconds.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) sourcePlay:(ALuint) sourceId atTime:(ALint64SOFT_OAL) deviceTime;
+
+/** Start a bunch of sources together at a time on the device clock (AL_SOFT_source_start_delay).
+ *
+ * @param sourceIds The sources to play.
+ * @param numSources The number of sources in sourceIds.
+ * @param deviceTime The device clock time to start at, in nanoseconds.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) sourcePlayv:(ALuint*) sourceIds numSources:(ALsizei) numSources atTime:(ALint64SOFT_OAL) deviceTime;
+
+/** Get one string from an indexed list of strings (ALC_SOFT_HRTF).
+ *
+ * @param device The device to read the attribute from.
+ * @param attribute The list to read (such as ALC_HRTF_SPECIFIER_SOFT).
+ * @param index The index of the string in the list.
+ * @return The string, or nil if it failed or isn't supported.
+ */
++ (NSString*) getString:(ALCdevice*) device attribute:(ALenum) attribute index:(ALCsizei) index;
+
+/** Reset a device with new attributes, keeping its contexts, sources and buffers (ALC_SOFT_HRTF).
+ *
+ * @param device The device to reset.
+ * @param attributes The new attributes, zero terminated (NULL = default attributes).
+ * @return TRUE if the operation was successful.
+ */
++ (bool) resetDevice:(ALCdevice*) device attributes:(const ALCint*) attributes;
+
+/** Check if loopback devices are available (ALC_SOFT_loopback).
+ *
+ * @return TRUE if openLoopbackDevice: and renderSamples:buffer:frames: are available.
+ */
++ (bool) loopbackSupported;
+
+/** Open a loopback device, which mixes into memory instead of to an audio device
+ * (ALC_SOFT_loopback). Its contexts must be created with the ALC_FORMAT_CHANNELS_SOFT,
+ * ALC_FORMAT_TYPE_SOFT and ALC_FREQUENCY attributes.
+ *
+ * @param deviceName The name of the device to open (nil = default device).
+ * @return The device, or NULL if it failed or isn't supported.
+ */
++ (ALCdevice*) openLoopbackDevice:(NSString*) deviceName;
+
+/** Check if a loopback device can render in a format (ALC_SOFT_loopback).
+ *
+ * @param device The loopback device.
+ * @param frequency The sample rate, in Hz.
+ * @param channels The channel layout (such as ALC_STEREO_SOFT).
+ * @param type The sample type (such as ALC_FLOAT_SOFT).
+ * @return TRUE if the format is supported.
+ */
++ (bool) isRenderFormatSupported:(ALCdevice*) device
+					   frequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type;
+
+/** Mix the next frames of a loopback device into memory (ALC_SOFT_loopback). <br>
+ * Unlike the rest of this class, this doesn't take the wrapper's lock, so it may
+ * be called from an audio callback.
+ *
+ * @param device The loopback device.
+ * @param buffer Where to put the samples, in the format the device's context was created with.
+ * @param frames The number of sample frames to render.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) renderSamples:(ALCdevice*) device buffer:(ALCvoid*) buffer frames:(ALCsizei) frames;
+
+
+#pragma mark EFX extension
+
+/** Check if the EFX extension's functions are available (ALC_EXT_EFX).
+ *
+ * @return TRUE if effects, effect slots and filters can be used.
+ */
++ (bool) efxSupported;
+
+/** Check if Apple's ASA extension's functions are available (iOS 5.0+).
+ *
+ * @return TRUE if the asaXYZ methods can be used.
+ */
++ (bool) asaSupported;
+
+/** Generate an effect (ALC_EXT_EFX).
+ *
+ * @return The effect's ID, or AL_INVALID on failure.
+ */
++ (ALuint) genEffect;
+
+/** Delete an effect (ALC_EXT_EFX).
+ *
+ * @param effectId The effect to delete.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) deleteEffect:(ALuint) effectId;
+
+/** Write an integer parameter of an effect (ALC_EXT_EFX).
+ *
+ * @param effectId The effect.
+ * @param parameter The parameter to write to (such as AL_EFFECT_TYPE).
+ * @param value The value to write.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) effecti:(ALuint) effectId parameter:(ALenum) parameter value:(ALint) value;
+
+/** Write a float parameter of an effect (ALC_EXT_EFX).
+ *
+ * @param effectId The effect.
+ * @param parameter The parameter to write to (such as AL_REVERB_DECAY_TIME).
+ * @param value The value to write.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) effectf:(ALuint) effectId parameter:(ALenum) parameter value:(ALfloat) value;
+
+/** Generate an auxiliary effect slot (ALC_EXT_EFX).
+ *
+ * @return The slot's ID, or AL_INVALID on failure (there are only a few per context).
+ */
++ (ALuint) genAuxiliaryEffectSlot;
+
+/** Delete an auxiliary effect slot (ALC_EXT_EFX).
+ *
+ * @param slotId The slot to delete.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) deleteAuxiliaryEffectSlot:(ALuint) slotId;
+
+/** Write an integer parameter of an auxiliary effect slot (ALC_EXT_EFX).
+ *
+ * @param slotId The slot.
+ * @param parameter The parameter to write to (such as AL_EFFECTSLOT_EFFECT).
+ * @param value The value to write.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) auxiliaryEffectSloti:(ALuint) slotId parameter:(ALenum) parameter value:(ALint) value;
+
+/** Write a float parameter of an auxiliary effect slot (ALC_EXT_EFX).
+ *
+ * @param slotId The slot.
+ * @param parameter The parameter to write to (such as AL_EFFECTSLOT_GAIN).
+ * @param value The value to write.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) auxiliaryEffectSlotf:(ALuint) slotId parameter:(ALenum) parameter value:(ALfloat) value;
+
+/** Generate a filter (ALC_EXT_EFX).
+ *
+ * @return The filter's ID, or AL_INVALID on failure.
+ */
++ (ALuint) genFilter;
+
+/** Delete a filter (ALC_EXT_EFX).
+ *
+ * @param filterId The filter to delete.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) deleteFilter:(ALuint) filterId;
+
+/** Write an integer parameter of a filter (ALC_EXT_EFX).
+ *
+ * @param filterId The filter.
+ * @param parameter The parameter to write to (such as AL_FILTER_TYPE).
+ * @param value The value to write.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) filteri:(ALuint) filterId parameter:(ALenum) parameter value:(ALint) value;
+
+/** Write a float parameter of a filter (ALC_EXT_EFX).
+ *
+ * @param filterId The filter.
+ * @param parameter The parameter to write to (such as AL_LOWPASS_GAINHF).
+ * @param value The value to write.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) filterf:(ALuint) filterId parameter:(ALenum) parameter value:(ALfloat) value;
+
 @end
@@ -106,6 +106,64 @@ static alcASASetListenerProcPtr alcASASetListener = NULL;
 static alSourceAddNotificationProcPtr alSourceAddNotification = NULL;
 static alSourceRemoveNotificationProcPtr alSourceRemoveNotification = NULL;
 
+typedef ALvoid AL_APIENTRY (*alDeferUpdatesSOFTProcPtr) (void);
+typedef ALvoid AL_APIENTRY (*alProcessUpdatesSOFTProcPtr) (void);
+
+static alDeferUpdatesSOFTProcPtr alDeferUpdatesSOFT = NULL;
+static alProcessUpdatesSOFTProcPtr alProcessUpdatesSOFT = NULL;
+
+typedef ALCvoid ALC_APIENTRY (*alcGetInteger64vSOFTProcPtr) (ALCdevice* device, ALCenum pname, ALsizei size, ALint64SOFT_OAL* values);
+typedef ALvoid AL_APIENTRY (*alSourcePlayAtTimeSOFTProcPtr) (ALuint source, ALint64SOFT_OAL start_time);
+typedef ALvoid AL_APIENTRY (*alSourcePlayAtTimevSOFTProcPtr) (ALsizei n, const ALuint* sources, ALint64SOFT_OAL start_time);
+
+static alcGetInteger64vSOFTProcPtr alcGetInteger64vSOFT = NULL;
+static alSourcePlayAtTimeSOFTProcPtr alSourcePlayAtTimeSOFT = NULL;
+static alSourcePlayAtTimevSOFTProcPtr alSourcePlayAtTimevSOFT = NULL;
+
+typedef ALvoid AL_APIENTRY (*alGetSourcedvSOFTProcPtr) (ALuint source, ALenum param, ALdouble* values);
+
+static alGetSourcedvSOFTProcPtr alGetSourcedvSOFT = NULL;
+
+typedef const ALCchar* ALC_APIENTRY (*alcGetStringiSOFTProcPtr) (ALCdevice* device, ALCenum paramName, ALCsizei index);
+typedef ALCboolean ALC_APIENTRY (*alcResetDeviceSOFTProcPtr) (ALCdevice* device, const ALCint* attribs);
+
+static alcGetStringiSOFTProcPtr alcGetStringiSOFT = NULL;
+static alcResetDeviceSOFTProcPtr alcResetDeviceSOFT = NULL;
+
+typedef ALCdevice* ALC_APIENTRY (*alcLoopbackOpenDeviceSOFTProcPtr) (const ALCchar* deviceName);
+typedef ALCboolean ALC_APIENTRY (*alcIsRenderFormatSupportedSOFTProcPtr) (ALCdevice* device, ALCsizei frequency, ALCenum channels, ALCenum type);
+typedef ALCvoid ALC_APIENTRY (*alcRenderSamplesSOFTProcPtr) (ALCdevice* device, ALCvoid* buffer, ALCsizei samples);
+
+static alcLoopbackOpenDeviceSOFTProcPtr alcLoopbackOpenDeviceSOFT = NULL;
+static alcIsRenderFormatSupportedSOFTProcPtr alcIsRenderFormatSupportedSOFT = NULL;
+static alcRenderSamplesSOFTProcPtr alcRenderSamplesSOFT = NULL;
+
+typedef ALvoid AL_APIENTRY (*alGenEffectsProcPtr) (ALsizei n, ALuint* effects);
+typedef ALvoid AL_APIENTRY (*alDeleteEffectsProcPtr) (ALsizei n, const ALuint* effects);
+typedef ALvoid AL_APIENTRY (*alEffectiProcPtr) (ALuint effect, ALenum param, ALint value);
+typedef ALvoid AL_APIENTRY (*alEffectfProcPtr) (ALuint effect, ALenum param, ALfloat value);
+typedef ALvoid AL_APIENTRY (*alGenAuxiliaryEffectSlotsProcPtr) (ALsizei n, ALuint* slots);
+typedef ALvoid AL_APIENTRY (*alDeleteAuxiliaryEffectSlotsProcPtr) (ALsizei n, const ALuint* slots);
+typedef ALvoid AL_APIENTRY (*alAuxiliaryEffectSlotiProcPtr) (ALuint slot, ALenum param, ALint value);
+typedef ALvoid AL_APIENTRY (*alAuxiliaryEffectSlotfProcPtr) (ALuint slot, ALenum param, ALfloat value);
+typedef ALvoid AL_APIENTRY (*alGenFiltersProcPtr) (ALsizei n, ALuint* filters);
+typedef ALvoid AL_APIENTRY (*alDeleteFiltersProcPtr) (ALsizei n, const ALuint* filters);
+typedef ALvoid AL_APIENTRY (*alFilteriProcPtr) (ALuint filter, ALenum param, ALint value);
+typedef ALvoid AL_APIENTRY (*alFilterfProcPtr) (ALuint filter, ALenum param, ALfloat value);
+
+static alGenEffectsProcPtr alGenEffectsEFX = NULL;
+static alDeleteEffectsProcPtr alDeleteEffectsEFX = NULL;
+static alEffectiProcPtr alEffectiEFX = NULL;
+static alEffectfProcPtr alEffectfEFX = NULL;
+static alGenAuxiliaryEffectSlotsProcPtr alGenAuxiliaryEffectSlotsEFX = NULL;
+static alDeleteAuxiliaryEffectSlotsProcPtr alDeleteAuxiliaryEffectSlotsEFX = NULL;
+static alAuxiliaryEffectSlotiProcPtr alAuxiliaryEffectSlotiEFX = NULL;
+static alAuxiliaryEffectSlotfProcPtr alAuxiliaryEffectSlotfEFX = NULL;
+static alGenFiltersProcPtr alGenFiltersEFX = NULL;
+static alDeleteFiltersProcPtr alDeleteFiltersEFX = NULL;
+static alFilteriProcPtr alFilteriEFX = NULL;
+static alFilterfProcPtr alFilterfEFX = NULL;
+
 
 #pragma mark -
 #pragma mark Error Handling
@@ -503,6 +561,38 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	}
 }
 
++ (void) beginDeferredUpdates:(ALCcontext*) context
+{
+	@synchronized(self)
+	{
+		if(NULL != alDeferUpdatesSOFT)
+		{
+			alDeferUpdatesSOFT();
+			CHECK_AL_CALL();
+		}
+		else
+		{
+			alcSuspendContext(context);
+		}
+	}
+}
+
++ (void) endDeferredUpdates:(ALCcontext*) context
+{
+	@synchronized(self)
+	{
+		if(NULL != alProcessUpdatesSOFT)
+		{
+			alProcessUpdatesSOFT();
+			CHECK_AL_CALL();
+		}
+		else
+		{
+			alcProcessContext(context);
+		}
+	}
+}
+
 + (void) destroyContext:(ALCcontext*) context
 {
 	@synchronized(self)
@@ -925,6 +1015,25 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	return result;
 }
 
++ (bool) sources3f:(const ALuint*) sourceIds
+			 count:(ALsizei) count
+		 parameter:(ALenum) parameter
+				 x:(const ALfloat*) x
+				 y:(const ALfloat*) y
+				 z:(const ALfloat*) z
+{
+	bool result;
+	@synchronized(self)
+	{
+		for(ALsizei i = 0; i < count; i++)
+		{
+			alSource3f(sourceIds[i], parameter, x[i], y[i], z[i]);
+		}
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
 + (bool) sourcefv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
@@ -1374,6 +1483,35 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
     alSourceAddNotification = (alSourceAddNotificationProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alSourceAddNotification");
     alSourceRemoveNotification = (alSourceRemoveNotificationProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alSourceRemoveNotification");
+
+    alDeferUpdatesSOFT = (alDeferUpdatesSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alDeferUpdatesSOFT");
+    alProcessUpdatesSOFT = (alProcessUpdatesSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alProcessUpdatesSOFT");
+
+    alcGetInteger64vSOFT = (alcGetInteger64vSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcGetInteger64vSOFT");
+    alSourcePlayAtTimeSOFT = (alSourcePlayAtTimeSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alSourcePlayAtTimeSOFT");
+    alSourcePlayAtTimevSOFT = (alSourcePlayAtTimevSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alSourcePlayAtTimevSOFT");
+    alGetSourcedvSOFT = (alGetSourcedvSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alGetSourcedvSOFT");
+
+    alcGetStringiSOFT = (alcGetStringiSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcGetStringiSOFT");
+    alcResetDeviceSOFT = (alcResetDeviceSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcResetDeviceSOFT");
+
+    alcLoopbackOpenDeviceSOFT = (alcLoopbackOpenDeviceSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcLoopbackOpenDeviceSOFT");
+    alcIsRenderFormatSupportedSOFT = (alcIsRenderFormatSupportedSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcIsRenderFormatSupportedSOFT");
+    alcRenderSamplesSOFT = (alcRenderSamplesSOFTProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcRenderSamplesSOFT");
+
+    // The EFX names are suffixed so that they don't clash with OpenAL Soft's efx.h prototypes.
+    alGenEffectsEFX = (alGenEffectsProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alGenEffects");
+    alDeleteEffectsEFX = (alDeleteEffectsProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alDeleteEffects");
+    alEffectiEFX = (alEffectiProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alEffecti");
+    alEffectfEFX = (alEffectfProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alEffectf");
+    alGenAuxiliaryEffectSlotsEFX = (alGenAuxiliaryEffectSlotsProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alGenAuxiliaryEffectSlots");
+    alDeleteAuxiliaryEffectSlotsEFX = (alDeleteAuxiliaryEffectSlotsProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alDeleteAuxiliaryEffectSlots");
+    alAuxiliaryEffectSlotiEFX = (alAuxiliaryEffectSlotiProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alAuxiliaryEffectSloti");
+    alAuxiliaryEffectSlotfEFX = (alAuxiliaryEffectSlotfProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alAuxiliaryEffectSlotf");
+    alGenFiltersEFX = (alGenFiltersProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alGenFilters");
+    alDeleteFiltersEFX = (alDeleteFiltersProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alDeleteFilters");
+    alFilteriEFX = (alFilteriProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alFilteri");
+    alFilterfEFX = (alFilterfProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alFilterf");
 }
 
 + (ALdouble) getMixerOutputDataRate
@@ -1808,4 +1946,406 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
     return result;
 }
 
+
+
+#pragma mark -
+#pragma mark OpenAL Soft Extensions
+
++ (bool) getInteger64v:(ALCdevice*) device
+			 attribute:(ALenum) attribute
+				  size:(ALsizei) size
+				  data:(ALint64SOFT_OAL*) data
+{
+	if(NULL == alcGetInteger64vSOFT)
+	{
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alcGetInteger64vSOFT(device, attribute, size, data);
+		result = CHECK_ALC_CALL(device);
+	}
+	return result;
+}
+
++ (bool) sourceLatencySupported
+{
+	return NULL != alGetSourcedvSOFT;
+}
+
++ (bool) getSourcedv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALdouble*) values
+{
+	if(NULL == alGetSourcedvSOFT)
+	{
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alGetSourcedvSOFT(sourceId, parameter, values);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) canPlayAtTime
+{
+	return NULL != alSourcePlayAtTimeSOFT && NULL != alSourcePlayAtTimevSOFT;
+}
+
++ (bool) sourcePlay:(ALuint) sourceId atTime:(ALint64SOFT_OAL) deviceTime
+{
+	if(NULL == alSourcePlayAtTimeSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alSourcePlayAtTimeSOFT");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alSourcePlayAtTimeSOFT(sourceId, deviceTime);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) sourcePlayv:(ALuint*) sourceIds numSources:(ALsizei) numSources atTime:(ALint64SOFT_OAL) deviceTime
+{
+	if(NULL == alSourcePlayAtTimevSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alSourcePlayAtTimevSOFT");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alSourcePlayAtTimevSOFT(numSources, sourceIds, deviceTime);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (NSString*) getString:(ALCdevice*) device attribute:(ALenum) attribute index:(ALCsizei) index
+{
+	if(NULL == alcGetStringiSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alcGetStringiSOFT. Returning nil");
+		return nil;
+	}
+
+	const ALCchar* result;
+	@synchronized(self)
+	{
+		result = alcGetStringiSOFT(device, attribute, index);
+		CHECK_ALC_CALL(device);
+	}
+	if(NULL == result)
+	{
+		return nil;
+	}
+	return [NSString stringWithFormat:@"%s", result];
+}
+
++ (bool) resetDevice:(ALCdevice*) device attributes:(const ALCint*) attributes
+{
+	if(NULL == alcResetDeviceSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alcResetDeviceSOFT");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		ALCboolean reset = alcResetDeviceSOFT(device, attributes);
+		result = CHECK_ALC_CALL(device) && ALC_TRUE == reset;
+	}
+	return result;
+}
+
++ (bool) loopbackSupported
+{
+	return NULL != alcLoopbackOpenDeviceSOFT && NULL != alcRenderSamplesSOFT;
+}
+
++ (ALCdevice*) openLoopbackDevice:(NSString*) deviceName
+{
+	if(NULL == alcLoopbackOpenDeviceSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alcLoopbackOpenDeviceSOFT");
+		return NULL;
+	}
+
+	ALCdevice* device;
+	@synchronized(self)
+	{
+		device = alcLoopbackOpenDeviceSOFT([deviceName UTF8String]);
+		if(NULL == device)
+		{
+			OAL_LOG_ERROR(@"Could not open loopback device %@", deviceName);
+		}
+	}
+	return device;
+}
+
++ (bool) isRenderFormatSupported:(ALCdevice*) device
+					   frequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type
+{
+	if(NULL == alcIsRenderFormatSupportedSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alcIsRenderFormatSupportedSOFT");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		ALCboolean supported = alcIsRenderFormatSupportedSOFT(device, frequency, channels, type);
+		result = CHECK_ALC_CALL(device) && ALC_TRUE == supported;
+	}
+	return result;
+}
+
++ (bool) renderSamples:(ALCdevice*) device buffer:(ALCvoid*) buffer frames:(ALCsizei) frames
+{
+	if(NULL == alcRenderSamplesSOFT)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alcRenderSamplesSOFT");
+		return false;
+	}
+
+	// OpenAL Soft locks the device itself while mixing.
+	alcRenderSamplesSOFT(device, buffer, frames);
+	return CHECK_ALC_CALL(device);
+}
+
+
+#pragma mark EFX Extension
+
++ (bool) efxSupported
+{
+	return NULL != alGenEffectsEFX && NULL != alDeleteEffectsEFX &&
+	NULL != alEffectiEFX && NULL != alEffectfEFX &&
+	NULL != alGenAuxiliaryEffectSlotsEFX && NULL != alDeleteAuxiliaryEffectSlotsEFX &&
+	NULL != alAuxiliaryEffectSlotiEFX && NULL != alAuxiliaryEffectSlotfEFX &&
+	NULL != alGenFiltersEFX && NULL != alDeleteFiltersEFX &&
+	NULL != alFilteriEFX && NULL != alFilterfEFX;
+}
+
++ (bool) asaSupported
+{
+	return NULL != alcASASetListener && NULL != alcASASetSource;
+}
+
++ (ALuint) genEffect
+{
+	if(NULL == alGenEffectsEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alGenEffects. Returning AL_INVALID");
+		return (ALuint)AL_INVALID;
+	}
+
+	ALuint effectId;
+	@synchronized(self)
+	{
+		alGenEffectsEFX(1, &effectId);
+		effectId = CHECK_AL_CALL() ? effectId : (ALuint)AL_INVALID;
+	}
+	return effectId;
+}
+
++ (bool) deleteEffect:(ALuint) effectId
+{
+	if(NULL == alDeleteEffectsEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alDeleteEffects");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alDeleteEffectsEFX(1, &effectId);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) effecti:(ALuint) effectId parameter:(ALenum) parameter value:(ALint) value
+{
+	if(NULL == alEffectiEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alEffecti");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alEffectiEFX(effectId, parameter, value);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) effectf:(ALuint) effectId parameter:(ALenum) parameter value:(ALfloat) value
+{
+	if(NULL == alEffectfEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alEffectf");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alEffectfEFX(effectId, parameter, value);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (ALuint) genAuxiliaryEffectSlot
+{
+	if(NULL == alGenAuxiliaryEffectSlotsEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alGenAuxiliaryEffectSlots. Returning AL_INVALID");
+		return (ALuint)AL_INVALID;
+	}
+
+	ALuint slotId;
+	@synchronized(self)
+	{
+		alGenAuxiliaryEffectSlotsEFX(1, &slotId);
+		slotId = CHECK_AL_CALL() ? slotId : (ALuint)AL_INVALID;
+	}
+	return slotId;
+}
+
++ (bool) deleteAuxiliaryEffectSlot:(ALuint) slotId
+{
+	if(NULL == alDeleteAuxiliaryEffectSlotsEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alDeleteAuxiliaryEffectSlots");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alDeleteAuxiliaryEffectSlotsEFX(1, &slotId);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) auxiliaryEffectSloti:(ALuint) slotId parameter:(ALenum) parameter value:(ALint) value
+{
+	if(NULL == alAuxiliaryEffectSlotiEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alAuxiliaryEffectSloti");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alAuxiliaryEffectSlotiEFX(slotId, parameter, value);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) auxiliaryEffectSlotf:(ALuint) slotId parameter:(ALenum) parameter value:(ALfloat) value
+{
+	if(NULL == alAuxiliaryEffectSlotfEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alAuxiliaryEffectSlotf");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alAuxiliaryEffectSlotfEFX(slotId, parameter, value);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (ALuint) genFilter
+{
+	if(NULL == alGenFiltersEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alGenFilters. Returning AL_INVALID");
+		return (ALuint)AL_INVALID;
+	}
+
+	ALuint filterId;
+	@synchronized(self)
+	{
+		alGenFiltersEFX(1, &filterId);
+		filterId = CHECK_AL_CALL() ? filterId : (ALuint)AL_INVALID;
+	}
+	return filterId;
+}
+
++ (bool) deleteFilter:(ALuint) filterId
+{
+	if(NULL == alDeleteFiltersEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alDeleteFilters");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alDeleteFiltersEFX(1, &filterId);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) filteri:(ALuint) filterId parameter:(ALenum) parameter value:(ALint) value
+{
+	if(NULL == alFilteriEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alFilteri");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alFilteriEFX(filterId, parameter, value);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) filterf:(ALuint) filterId parameter:(ALenum) parameter value:(ALfloat) value
+{
+	if(NULL == alFilterfEFX)
+	{
+		OAL_LOG_WARNING(@"No proc ptr for alFilterf");
+		return false;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		alFilterfEFX(filterId, parameter, value);
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
 @end
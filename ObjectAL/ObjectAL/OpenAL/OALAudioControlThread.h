@@ -0,0 +1,145 @@
+//
+//  OALAudioControlThread.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "SynthesizeSingleton.h"
+#import "ObjectALConfig.h"
+#import "OALLock.h"
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+
+@class ALContext;
+@class OALCommandQueue;
+
+
+#pragma mark OALAudioControlThread
+
+/**
+ * An optional thread that owns all OpenAL control calls. <br><br>
+ *
+ * Game threads post commands (play, stop, parameter changes etc) as blocks.
+ * Posting never waits for the control thread: commands go into a lock-free queue,
+ * and the control thread drains it and runs them in order. On every tick, the control thread also
+ * updates source culling (see ALContext.cullingEnabled), occlusion (see
+ * ALContext.occlusionQuery) and software loop points (see ALContext.updateLoopPoints),
+ * and commits any deferred source parameter changes on its context. <br><br>
+ *
+ * Until start is called, posted commands are simply run on the calling thread,
+ * so code written against this class behaves the same with or without it. <br>
+ *
+ * Note: Once all OpenAL access goes through the control thread, you may also
+ * disable OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS in ObjectALConfig.h.
+ */
+@interface OALAudioControlThread : NSObject
+{
+	/** The thread that runs commands. */
+	NSThread* thread;
+
+	/** Commands waiting to be run on the control thread. */
+	OALCommandQueue* commandQueue;
+
+	/** Wakes the control thread when a command is posted. */
+	dispatch_semaphore_t wakeSignal;
+
+	/** Signaled by the control thread once it has finished. */
+	dispatch_semaphore_t stoppedSignal;
+
+	/** The context whose deferred updates get committed on each tick. */
+	ALContext* context;
+
+	/** Maximum time between ticks, in seconds. */
+	NSTimeInterval tickInterval;
+
+	/** Whether the control thread should keep running. */
+	volatile bool running;
+
+	/** Whether posted commands go into the queue. Stays set until the control
+	 * thread's last drain, so that nothing is queued after it.
+	 */
+	bool acceptingCommands;
+
+	/** Protects acceptingCommands, and pushing onto the queue while it is set. */
+	OALLock postLock;
+}
+
+
+#pragma mark Properties
+
+/** The context whose deferred source updates get committed on each tick.
+ * While the control thread is running, this context has deferUpdates enabled. <br>
+ * Default value: The current context at the time start is called.
+ */
+@property(nonatomic,readwrite,retain) ALContext* context;
+
+/** Maximum time between ticks, in seconds. The control thread wakes up
+ * early whenever a command is posted. <br>
+ * Default value: kActionStepInterval
+ */
+@property(nonatomic,readwrite,assign) NSTimeInterval tickInterval;
+
+/** If true, the control thread is running. */
+@property(nonatomic,readonly,assign) bool running;
+
+/** If true, the caller is running on the control thread. */
+@property(nonatomic,readonly,assign) bool isControlThread;
+
+
+#pragma mark Object Management
+
+/** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
+ *
+ * <b>- (OALAudioControlThread*) sharedInstance</b>: Get the shared singleton instance. <br>
+ * <b>- (void) purgeSharedInstance</b>: Purge (deallocate) the shared instance.
+ */
+SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALAudioControlThread);
+
+
+#pragma mark Thread Control
+
+/** Start the control thread. From now on, posted commands run on it.
+ */
+- (void) start;
+
+/** Stop the control thread. Any commands still queued are run before
+ * this method returns.
+ */
+- (void) stop;
+
+
+#pragma mark Commands
+
+/** Post a command to be run on the control thread.
+ * If the control thread isn't running (or has already run its last commands
+ * while stopping), the command is run immediately on the calling thread.
+ *
+ * @param command The command to run.
+ */
+- (void) post:(dispatch_block_t) command;
+
+@end
+
+#endif /* NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS */
@@ -0,0 +1,245 @@
+//
+//  OALAudioControlThread.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALAudioControlThread.h"
+#import "OALCommandQueue.h"
+#import "ALContext.h"
+#import "OpenALManager.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+
+SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OALAudioControlThread);
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALAudioControlThread.
+ */
+@interface OALAudioControlThread (Private)
+
+/** (INTERNAL USE) Main loop of the control thread.
+ */
+- (void) threadMain:(id) object;
+
+@end
+/** \endcond */
+
+
+#pragma mark OALAudioControlThread
+
+@implementation OALAudioControlThread
+
+
+#pragma mark Object Management
+
+SYNTHESIZE_SINGLETON_FOR_CLASS(OALAudioControlThread);
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init", self);
+
+		commandQueue = [[OALCommandQueue alloc] init];
+		wakeSignal = dispatch_semaphore_create(0);
+		stoppedSignal = dispatch_semaphore_create(0);
+		tickInterval = kActionStepInterval;
+		OALLockInit(&postLock);
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+
+	[self stop];
+
+	as_release(thread);
+	as_release(commandQueue);
+	as_release(context);
+#if !__has_feature(objc_arc)
+	dispatch_release(wakeSignal);
+	dispatch_release(stoppedSignal);
+#endif
+	OALLockDestroy(&postLock);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize tickInterval;
+
+- (ALContext*) context
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return as_autorelease(as_retain(context));
+	}
+}
+
+- (void) setContext:(ALContext*) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value == context)
+		{
+			return;
+		}
+		if(running)
+		{
+			context.deferUpdates = NO;
+			value.deferUpdates = YES;
+		}
+		as_release(context);
+		context = as_retain(value);
+	}
+}
+
+- (bool) running
+{
+	return running;
+}
+
+- (bool) isControlThread
+{
+	return running && [NSThread currentThread] == thread;
+}
+
+
+#pragma mark Thread Control
+
+- (void) start
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(running)
+		{
+			return;
+		}
+
+		if(nil == context)
+		{
+			context = as_retain([OpenALManager sharedInstance].currentContext);
+		}
+		context.deferUpdates = YES;
+
+		ALWAYS_LOCKED(commandQueue, &postLock)
+		{
+			acceptingCommands = YES;
+		}
+		running = YES;
+		as_release(thread);
+		thread = [[NSThread alloc] initWithTarget:self selector:@selector(threadMain:) object:nil];
+		[thread setName:@"ObjectAL Audio Control"];
+		[thread start];
+		OAL_LOG_DEBUG(@"%@: Started control thread", self);
+	}
+}
+
+- (void) stop
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(!running)
+		{
+			return;
+		}
+
+		running = NO;
+		dispatch_semaphore_signal(wakeSignal);
+		if([NSThread currentThread] != thread)
+		{
+			dispatch_semaphore_wait(stoppedSignal, DISPATCH_TIME_FOREVER);
+		}
+		context.deferUpdates = NO;
+		OAL_LOG_DEBUG(@"%@: Stopped control thread", self);
+	}
+}
+
+- (void) threadMain:(id) object
+{
+	#pragma unused(object)
+	while(running)
+	{
+		as_autoreleasepool_start(pool);
+
+		int64_t timeout = (int64_t)(tickInterval * NSEC_PER_SEC);
+		dispatch_semaphore_wait(wakeSignal, dispatch_time(DISPATCH_TIME_NOW, timeout));
+		[commandQueue drain];
+		[context updateCulling];
+		[context updateOcclusion];
+		[context updateLoopPoints];
+		[context commitDeferredUpdates];
+
+		as_autoreleasepool_end(pool);
+	}
+
+	as_autoreleasepool_start(pool);
+	// Anything posted from here on runs on the posting thread, but only once
+	// what was already queued has run.
+	ALWAYS_LOCKED(commandQueue, &postLock)
+	{
+		acceptingCommands = NO;
+		[commandQueue drain];
+	}
+	[context commitDeferredUpdates];
+	as_autoreleasepool_end(pool);
+
+	dispatch_semaphore_signal(stoppedSignal);
+}
+
+
+#pragma mark Commands
+
+- (void) post:(dispatch_block_t) command
+{
+	bool queued = NO;
+	ALWAYS_LOCKED(commandQueue, &postLock)
+	{
+		if(acceptingCommands)
+		{
+			[commandQueue push:command];
+			queued = YES;
+		}
+	}
+
+	if(queued)
+	{
+		dispatch_semaphore_signal(wakeSignal);
+	}
+	else
+	{
+		command();
+	}
+}
+
+@end
+
+#endif /* NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS */
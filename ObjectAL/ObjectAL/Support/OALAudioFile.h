@@ -50,6 +50,9 @@
 
 	/** The actual number of channels in the audio data if not reducing to mono */
 	UInt32 originalChannelsPerFrame;
+
+	SInt64 loopStart;
+	SInt64 loopEnd;
 }
 
 /** The URL of the audio file */
@@ -61,6 +64,15 @@
 /** The total number of audio frames in this file */
 @property(nonatomic,readonly,assign) SInt64 totalFrames;
 
+/** The frame where looping restarts, from the file's metadata (a WAV smpl chunk,
+ * or LOOPSTART in an Ogg file's comments), or -1 if the file has no loop points.
+ * Buffers made by bufferNamed:startFrame:numFrames: get these loop points.
+ */
+@property(nonatomic,readonly,assign) SInt64 loopStart;
+
+/** The frame just past the end of the looped part, or -1 for the end of the file. */
+@property(nonatomic,readonly,assign) SInt64 loopEnd;
+
 /** If YES, reduce any stereo data to mono (stereo samples don't support panning or positional audio). */
 @property(nonatomic,readwrite,assign) bool reduceToMono;
 
@@ -95,6 +107,29 @@
 						numFrames:(SInt64) numFrames
 					   bufferSize:(UInt32*) bufferSize;
 
+/** Convert the audio to this channel count and sample rate as it gets read,
+ * so that audio from different files can be mixed together.
+ *
+ * @param channels The number of channels (1 or 2).
+ * @param sampleRate The sample rate in Hz.
+ * @return TRUE if the conversion was set up.
+ */
+- (bool) convertToChannels:(UInt32) channels sampleRate:(Float64) sampleRate;
+
+/** Read audio data carrying on from where the last read left off, for streaming.
+ *
+ * @param numFrames The maximum number of frames to read.
+ * @param data Receives the audio data (numFrames * streamDescription->mBytesPerFrame bytes).
+ * @return The number of frames read, which is 0 at the end of the file or on error.
+ */
+- (UInt32) readFrames:(UInt32) numFrames into:(void*) data;
+
+/** Move the streaming read position back to the start of the file.
+ *
+ * @return TRUE if the operation was successful.
+ */
+- (bool) rewind;
+
 /** Create a new ALBuffer with the contents of this file.
  *
  * @param name The name to be given to this ALBuffer.
@@ -30,6 +30,7 @@
 #import "OALAudioFile.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
+#import "OALLoopPoints.h"
 
 
 @implementation OALAudioFile
@@ -48,6 +49,8 @@
 	{
 		url = as_retain(urlIn);
 		reduceToMono = reduceToMonoIn;
+		loopStart = -1;
+		loopEnd = -1;
 
 		OSStatus error = 0;
 		UInt32 size;
@@ -110,6 +113,11 @@
 			streamDescription.mChannelsPerFrame = 2;
 		}
 
+		if([url isFileURL] && !OALLoopPointsRead([[url path] fileSystemRepresentation], &loopStart, &loopEnd))
+		{
+			loopStart = loopEnd = -1;
+		}
+
 		streamDescription.mBytesPerFrame = streamDescription.mChannelsPerFrame * streamDescription.mBitsPerChannel / 8;
 		streamDescription.mFramesPerPacket = 1;
 		streamDescription.mBytesPerPacket = streamDescription.mBytesPerFrame * 1 /* streamDescription.mFramesPerPacket */;
@@ -161,6 +169,10 @@
 
 @synthesize totalFrames;
 
+@synthesize loopStart;
+
+@synthesize loopEnd;
+
 - (bool) reduceToMono
 {
 	return reduceToMono;
@@ -269,6 +281,69 @@
 	}
 }
 
+- (bool) convertToChannels:(UInt32) channels sampleRate:(Float64) sampleRate
+{
+	@synchronized(self)
+	{
+		OSStatus error;
+		streamDescription.mChannelsPerFrame = channels > 2 ? 2 : channels;
+		streamDescription.mSampleRate = sampleRate;
+		streamDescription.mBytesPerFrame = streamDescription.mChannelsPerFrame * streamDescription.mBitsPerChannel / 8;
+		streamDescription.mBytesPerPacket = streamDescription.mBytesPerFrame;
+		reduceToMono = 1 == streamDescription.mChannelsPerFrame;
+		if(noErr != (error = ExtAudioFileSetProperty(fileHandle,
+													 kExtAudioFileProperty_ClientDataFormat,
+													 sizeof(AudioStreamBasicDescription),
+													 &streamDescription)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not set new audio format for file (url = %@)", url);
+			return NO;
+		}
+		return YES;
+	}
+}
+
+- (UInt32) readFrames:(UInt32) numFrames into:(void*) data
+{
+	@synchronized(self)
+	{
+		if(nil == fileHandle)
+		{
+			OAL_LOG_ERROR(@"Attempted to read from closed file (url = %@)", url);
+			return 0;
+		}
+
+		OSStatus error;
+		AudioBufferList bufferList;
+		bufferList.mNumberBuffers = 1;
+		bufferList.mBuffers[0].mNumberChannels = streamDescription.mChannelsPerFrame;
+		bufferList.mBuffers[0].mDataByteSize = streamDescription.mBytesPerFrame * numFrames;
+		bufferList.mBuffers[0].mData = data;
+
+		UInt32 numFramesRead = numFrames;
+		if(noErr != (error = ExtAudioFileRead(fileHandle, &numFramesRead, &bufferList)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not read audio data in file (url = %@)", url);
+			return 0;
+		}
+		return numFramesRead;
+	}
+}
+
+- (bool) rewind
+{
+	@synchronized(self)
+	{
+		OSStatus error;
+		if(noErr != (error = ExtAudioFileSeek(fileHandle, 0)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not seek to start of file (url = %@)", url);
+			return NO;
+		}
+		return YES;
+	}
+}
+
 
 - (ALBuffer*) bufferNamed:(NSString*) name
 			   startFrame:(SInt64) startFrame
@@ -313,11 +388,29 @@
 			}
 		}
 		
-		return [ALBuffer bufferWithName:name
-								   data:streamData
-								   size:(ALsizei)bufferSize
-								 format:audioFormat
-							  frequency:(ALsizei)streamDescription.mSampleRate];
+		ALBuffer* buffer = [ALBuffer bufferWithName:name
+											   data:streamData
+											   size:(ALsizei)bufferSize
+											 format:audioFormat
+										  frequency:(ALsizei)streamDescription.mSampleRate];
+
+		// Loop points are relative to the start of the file, so only apply them
+		// if they fall within what was read.
+		if(loopStart >= 0 && nil != buffer)
+		{
+			SInt64 frames = buffer.frames;
+			SInt64 start = loopStart - startFrame;
+			SInt64 end = loopEnd < 0 ? frames : loopEnd - startFrame;
+			if(start >= 0 && end > start && end <= frames)
+			{
+				[buffer setLoopStart:(ALint)start end:end == frames ? -1 : (ALint)end];
+			}
+			else
+			{
+				OAL_LOG_DEBUG(@"Loop points %lld - %lld are outside of the frames read (url = %@)", loopStart, loopEnd, url);
+			}
+		}
+		return buffer;
 	}
 }
 
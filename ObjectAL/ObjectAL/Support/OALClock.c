@@ -0,0 +1,135 @@
+/*
+ *  OALClock.c
+ *  ObjectAL
+ *
+ *  The scaled time is kept as a base (the scaled time at the last change of
+ *  source or scale) plus the raw time since then multiplied by the scale, so
+ *  changes apply from that moment on and the clock never jumps.
+ */
+
+#include "OALClock.h"
+#include "OALLock.h"
+
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+static pthread_once_t g_clockOnce = PTHREAD_ONCE_INIT;
+static OALLock g_clockLock;
+static OALClockSource g_clockSource = kOALClockSourceMonotonic;
+static double g_virtualTime = 0;
+static double g_timeScale = 1.0;
+static double g_baseRawTime = 0;
+static double g_baseScaledTime = 0;
+
+
+/* Backend */
+
+double OALClockMonotonicSeconds(void)
+{
+#if defined(__APPLE__)
+	static double conversion = 0.0;
+	if(0 == conversion)
+	{
+		mach_timebase_info_data_t info;
+		if(0 == mach_timebase_info(&info))
+		{
+			conversion = 1e-9 * (double)info.numer / (double)info.denom;
+		}
+	}
+	return conversion * (double)mach_absolute_time();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+
+/* Scaled Clock */
+
+static void clockInit(void)
+{
+	OALLockInit(&g_clockLock);
+	g_baseRawTime = OALClockMonotonicSeconds();
+}
+
+/* Must be called with the lock held. */
+static double rawTime(void)
+{
+	return kOALClockSourceVirtual == g_clockSource ? g_virtualTime : OALClockMonotonicSeconds();
+}
+
+/* Must be called with the lock held. */
+static void rebase(void)
+{
+	double raw = rawTime();
+	g_baseScaledTime += (raw - g_baseRawTime) * g_timeScale;
+	g_baseRawTime = raw;
+}
+
+double OALClockNow(void)
+{
+	double result = 0;
+	pthread_once(&g_clockOnce, clockInit);
+	OAL_LOCK_SCOPE(&g_clockLock)
+	{
+		result = g_baseScaledTime + (rawTime() - g_baseRawTime) * g_timeScale;
+	}
+	return result;
+}
+
+OALClockSource OALClockGetSource(void)
+{
+	return g_clockSource;
+}
+
+void OALClockSetSource(OALClockSource source)
+{
+	pthread_once(&g_clockOnce, clockInit);
+	OAL_LOCK_SCOPE(&g_clockLock)
+	{
+		rebase();
+		g_clockSource = source;
+		g_baseRawTime = rawTime();
+	}
+}
+
+void OALClockSetVirtualTime(double seconds)
+{
+	pthread_once(&g_clockOnce, clockInit);
+	OAL_LOCK_SCOPE(&g_clockLock)
+	{
+		g_virtualTime = seconds;
+	}
+}
+
+void OALClockAdvanceVirtualTime(double seconds)
+{
+	pthread_once(&g_clockOnce, clockInit);
+	OAL_LOCK_SCOPE(&g_clockLock)
+	{
+		g_virtualTime += seconds;
+	}
+}
+
+double OALClockGetTimeScale(void)
+{
+	return g_timeScale;
+}
+
+void OALClockSetTimeScale(double scale)
+{
+	if(scale < 0)
+	{
+		scale = 0;
+	}
+	pthread_once(&g_clockOnce, clockInit);
+	OAL_LOCK_SCOPE(&g_clockLock)
+	{
+		rebase();
+		g_timeScale = scale;
+	}
+}
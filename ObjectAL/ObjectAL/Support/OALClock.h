@@ -0,0 +1,113 @@
+//
+//  OALClock.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#ifndef HDR_OALClock_h
+#define HDR_OALClock_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The clock that ObjectAL's timing runs on.
+ *
+ * OALClockNow() is what actions are timed against. It normally follows the
+ * system's monotonic clock, but can be switched to a virtual clock that only
+ * moves when told to, for deterministic tests and faster than realtime
+ * rendering. A time scale is applied here, once, so slow motion and pausing
+ * affect everything timed by the clock without touching individual actions.
+ *
+ * The monotonic backend is mach_absolute_time() on Apple platforms and
+ * clock_gettime(CLOCK_MONOTONIC) everywhere else.
+ *
+ * This header is plain C so that it can also be used outside of Objective-C.
+ */
+
+/** Where OALClockNow() gets its time from. */
+typedef enum
+{
+	/** The system's monotonic clock (default). */
+	kOALClockSourceMonotonic,
+	/** A virtual clock, moved by OALClockSetVirtualTime() and OALClockAdvanceVirtualTime(). */
+	kOALClockSourceVirtual,
+} OALClockSource;
+
+/** Get the time on the system's monotonic clock, in seconds.
+ * Not affected by the clock source or time scale.
+ *
+ * @return The monotonic time, in seconds from an arbitrary point.
+ */
+double OALClockMonotonicSeconds(void);
+
+/** Get the current clock time, in seconds. Only differences between two
+ * readings are meaningful. Switching sources or changing the time scale
+ * never makes the clock jump.
+ *
+ * @return The scaled time, in seconds.
+ */
+double OALClockNow(void);
+
+/** Get the clock source.
+ *
+ * @return The clock source.
+ */
+OALClockSource OALClockGetSource(void);
+
+/** Set the clock source.
+ *
+ * @param source The clock source.
+ */
+void OALClockSetSource(OALClockSource source);
+
+/** Set the time on the virtual clock. It should only ever move forward.
+ *
+ * @param seconds The new virtual time, in seconds.
+ */
+void OALClockSetVirtualTime(double seconds);
+
+/** Move the virtual clock forward.
+ *
+ * @param seconds How far to move, in seconds.
+ */
+void OALClockAdvanceVirtualTime(double seconds);
+
+/** Get the time scale.
+ *
+ * @return The time scale.
+ */
+double OALClockGetTimeScale(void);
+
+/** Set the time scale. 1.0 is normal speed, 0.5 is half speed, and 0.0 pauses the clock.
+ *
+ * @param scale The time scale (must not be negative).
+ */
+void OALClockSetTimeScale(double scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDR_OALClock_h */
@@ -0,0 +1,85 @@
+//
+//  OALCommandQueue.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ObjectALConfig.h"
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+
+/** \cond */
+struct OALCommandNode;
+/** \endcond */
+
+
+#pragma mark OALCommandQueue
+
+/**
+ * A lock-free multiple producer, single consumer queue of commands (blocks).
+ *
+ * Any number of threads may push commands concurrently without ever blocking
+ * on a lock. Only one thread (the consumer) may drain the queue.
+ */
+@interface OALCommandQueue : NSObject
+{
+	/** The most recently pushed node. Swapped atomically by producers. */
+	struct OALCommandNode* volatile head;
+
+	/** The oldest node that hasn't been consumed. Only touched by the consumer. */
+	struct OALCommandNode* tail;
+
+	/** Placeholder node that keeps the queue from ever being completely empty. */
+	struct OALCommandNode* stub;
+}
+
+
+#pragma mark Object Management
+
+/** Create a new command queue.
+ *
+ * @return A new command queue.
+ */
++ (id) queue;
+
+
+#pragma mark Queue Operations
+
+/** Push a command onto the queue. Safe to call from any thread, never blocks.
+ *
+ * @param command The command to push.
+ */
+- (void) push:(dispatch_block_t) command;
+
+/** Run all queued commands in the order they were pushed.
+ * Must only be called from the consumer thread.
+ *
+ * @return The number of commands that were run.
+ */
+- (NSUInteger) drain;
+
+@end
+
+#endif /* NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS */
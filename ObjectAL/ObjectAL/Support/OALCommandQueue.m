@@ -0,0 +1,172 @@
+//
+//  OALCommandQueue.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALCommandQueue.h"
+#import "ARCSafe_MemMgmt.h"
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+
+/** \cond */
+/** (INTERNAL USE) A single link in the command queue. */
+typedef struct OALCommandNode
+{
+	struct OALCommandNode* volatile next;
+	void* command;
+} OALCommandNode;
+/** \endcond */
+
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALCommandQueue.
+ */
+@interface OALCommandQueue (Private)
+
+/** (INTERNAL USE) Link a node onto the head of the queue.
+ *
+ * @param node The node to link.
+ */
+- (void) pushNode:(OALCommandNode*) node;
+
+/** (INTERNAL USE) Unlink the node at the tail of the queue.
+ *
+ * @return The oldest node, or NULL if the queue is empty (or a producer
+ *         is still in the middle of linking its node).
+ */
+- (OALCommandNode*) popNode;
+
+@end
+/** \endcond */
+
+
+@implementation OALCommandQueue
+
+#pragma mark Object Management
+
++ (id) queue
+{
+	return as_autorelease([[self alloc] init]);
+}
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		stub = calloc(1, sizeof(*stub));
+		head = stub;
+		tail = stub;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	OALCommandNode* node;
+	while(NULL != (node = [self popNode]))
+	{
+		dispatch_block_t command = (as_bridge_transfer dispatch_block_t) node->command;
+		as_release(command);
+		free(node);
+	}
+	free(stub);
+	as_superdealloc();
+}
+
+
+#pragma mark Queue Operations
+
+- (void) pushNode:(OALCommandNode*) node
+{
+	__atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+	OALCommandNode* prev = __atomic_exchange_n(&head, node, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+- (OALCommandNode*) popNode
+{
+	OALCommandNode* node = tail;
+	OALCommandNode* next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+	if(node == stub)
+	{
+		if(NULL == next)
+		{
+			return NULL;
+		}
+		tail = next;
+		node = next;
+		next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+	}
+
+	if(NULL != next)
+	{
+		tail = next;
+		return node;
+	}
+
+	if(node != __atomic_load_n(&head, __ATOMIC_ACQUIRE))
+	{
+		// A producer has swapped the head but not linked it yet.
+		return NULL;
+	}
+
+	// Put the stub back behind the last node so that it can be unlinked.
+	[self pushNode:stub];
+	next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+	if(NULL != next)
+	{
+		tail = next;
+		return node;
+	}
+	return NULL;
+}
+
+- (void) push:(dispatch_block_t) command
+{
+	OALCommandNode* node = malloc(sizeof(*node));
+	node->command = (as_bridge_retained void*)[command copy];
+	[self pushNode:node];
+}
+
+- (NSUInteger) drain
+{
+	NSUInteger count = 0;
+	OALCommandNode* node;
+	while(NULL != (node = [self popNode]))
+	{
+		dispatch_block_t command = (as_bridge_transfer dispatch_block_t) node->command;
+		free(node);
+		command();
+		as_release(command);
+		count++;
+	}
+	return count;
+}
+
+@end
+
+#endif /* NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS */
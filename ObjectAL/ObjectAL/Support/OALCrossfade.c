@@ -0,0 +1,123 @@
+/*
+ *  OALCrossfade.c
+ *  ObjectAL
+ *
+ *  Ramp segments are aligned to the start of the fade rather than to the
+ *  blocks being mixed, so the output is the same however the caller splits
+ *  the audio up.
+ */
+
+#include "OALCrossfade.h"
+#include <math.h>
+#include <string.h>
+
+static int16_t clampSample(float value)
+{
+	if(value >= 32767.0f)
+	{
+		return 32767;
+	}
+	if(value <= -32768.0f)
+	{
+		return -32768;
+	}
+	return (int16_t)lrintf(value);
+}
+
+
+/* API */
+
+void OALCrossfadeInit(OALCrossfade* fade, int64_t length)
+{
+	fade->position = 0;
+	fade->length = length > 0 ? length : 0;
+}
+
+void OALCrossfadeGains(const OALCrossfade* fade, int64_t position, float* outgoingGain, float* incomingGain)
+{
+	if(position >= fade->length)
+	{
+		*outgoingGain = 0;
+		*incomingGain = 1;
+		return;
+	}
+	if(position <= 0)
+	{
+		*outgoingGain = 1;
+		*incomingGain = 0;
+		return;
+	}
+	double angle = M_PI_2 * (double)position / (double)fade->length;
+	*outgoingGain = (float)cos(angle);
+	*incomingGain = (float)sin(angle);
+}
+
+void OALCrossfadeMixInt16(OALCrossfade* fade,
+						  const int16_t* outgoing,
+						  const int16_t* incoming,
+						  int16_t* output,
+						  int frames,
+						  int channels)
+{
+	int frame = 0;
+	while(frame < frames && fade->position < fade->length)
+	{
+		int64_t segmentStart = fade->position - fade->position % kOALCrossfadeRampFrames;
+		int64_t segmentEnd = segmentStart + kOALCrossfadeRampFrames;
+		if(segmentEnd > fade->length)
+		{
+			segmentEnd = fade->length;
+		}
+		int count = frames - frame;
+		if(count > segmentEnd - fade->position)
+		{
+			count = (int)(segmentEnd - fade->position);
+		}
+
+		float outStart, inStart, outEnd, inEnd;
+		OALCrossfadeGains(fade, segmentStart, &outStart, &inStart);
+		OALCrossfadeGains(fade, segmentEnd, &outEnd, &inEnd);
+		float outStep = (outEnd - outStart) / (float)(segmentEnd - segmentStart);
+		float inStep = (inEnd - inStart) / (float)(segmentEnd - segmentStart);
+		int offset = (int)(fade->position - segmentStart);
+
+		for(int i = 0; i < count; i++)
+		{
+			/* Worked out from the segment start each time, rather than accumulated,
+			 * so that a fade resumed mid-segment gets exactly the same gains. */
+			float outGain = outStart + outStep * (float)(offset + i);
+			float inGain = inStart + inStep * (float)(offset + i);
+			int base = (frame + i) * channels;
+			for(int channel = 0; channel < channels; channel++)
+			{
+				float outSample = NULL != outgoing ? (float)outgoing[base + channel] : 0.0f;
+				float inSample = NULL != incoming ? (float)incoming[base + channel] : 0.0f;
+				output[base + channel] = clampSample(outSample * outGain + inSample * inGain);
+			}
+		}
+
+		fade->position += count;
+		frame += count;
+	}
+
+	/* Past the end of the fade, only the incoming audio is left. */
+	if(frame < frames)
+	{
+		size_t offset = (size_t)frame * (size_t)channels;
+		size_t size = (size_t)(frames - frame) * (size_t)channels * sizeof(*output);
+		if(NULL == incoming)
+		{
+			memset(output + offset, 0, size);
+		}
+		else if(incoming != output)
+		{
+			memmove(output + offset, incoming + offset, size);
+		}
+		fade->position += frames - frame;
+	}
+}
+
+bool OALCrossfadeFinished(const OALCrossfade* fade)
+{
+	return fade->position >= fade->length;
+}
@@ -0,0 +1,107 @@
+//
+//  OALCrossfade.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#ifndef HDR_OALCrossfade_h
+#define HDR_OALCrossfade_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An equal-power crossfade between two blocks of 16 bit PCM, computed on the
+ * samples themselves rather than by stepping a source's gain.
+ *
+ * At frame p of a fade that lasts n frames, the outgoing audio is scaled by
+ * cos(pi/2 * p/n) and the incoming audio by sin(pi/2 * p/n), so the combined
+ * power stays constant the whole way through. The exact gains are computed
+ * every kOALCrossfadeRampFrames frames and ramped linearly in between, so the
+ * gain changes smoothly on every frame and the fade ends on an exact frame no
+ * matter how the audio is split into blocks.
+ */
+
+/** Frames between exactly computed gains. */
+#define kOALCrossfadeRampFrames 32
+
+/** The progress of a crossfade. */
+typedef struct
+{
+	/** Frames mixed so far. */
+	int64_t position;
+
+	/** Frames in the whole fade. */
+	int64_t length;
+} OALCrossfade;
+
+/** Start a crossfade.
+ *
+ * @param fade The crossfade.
+ * @param length The length of the fade in frames. 0 switches to the incoming audio at once.
+ */
+void OALCrossfadeInit(OALCrossfade* fade, int64_t length);
+
+/** Get the gains at a point in a crossfade.
+ *
+ * @param fade The crossfade.
+ * @param position The frame to get the gains for.
+ * @param outgoingGain Receives the gain for the outgoing audio.
+ * @param incomingGain Receives the gain for the incoming audio.
+ */
+void OALCrossfadeGains(const OALCrossfade* fade, int64_t position, float* outgoingGain, float* incomingGain);
+
+/** Mix the next block of a crossfade. Frames after the end of the fade are the
+ * incoming audio unchanged. The output may be the same memory as either input.
+ *
+ * @param fade The crossfade.
+ * @param outgoing The outgoing audio, or NULL if it has run out (it is then silent).
+ * @param incoming The incoming audio, or NULL if it has run out.
+ * @param output Receives the mixed audio.
+ * @param frames The number of frames to mix.
+ * @param channels The number of interleaved channels.
+ */
+void OALCrossfadeMixInt16(OALCrossfade* fade,
+						  const int16_t* outgoing,
+						  const int16_t* incoming,
+						  int16_t* output,
+						  int frames,
+						  int channels);
+
+/** Check if a crossfade has reached its end, after which the outgoing audio
+ * is no longer needed.
+ *
+ * @param fade The crossfade.
+ * @return true if the fade is complete.
+ */
+bool OALCrossfadeFinished(const OALCrossfade* fade);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDR_OALCrossfade_h */
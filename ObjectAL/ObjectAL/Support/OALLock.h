@@ -0,0 +1,201 @@
+//
+//  OALLock.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#ifndef HDR_OALLock_h
+#define HDR_OALLock_h
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#if defined(__APPLE__)
+#include <Availability.h>
+#endif
+
+/* Lightweight recursive locks used by the OpenAL layer when
+ * OBJECTAL_CFG_LOCK_POLICY is OBJECTAL_LOCK_POLICY_LIGHTWEIGHT.
+ *
+ * Each lock lives inside the object it protects, so taking it costs one
+ * uncontended atomic operation, unlike @synchronized which has to look the
+ * object up in a global table first. On Apple platforms the underlying lock
+ * is os_unfair_lock when the deployment target allows it. Everywhere else it
+ * is a plain pthread mutex, which is futex based on Linux.
+ *
+ * This header is plain C so that it can also be used outside of Objective-C.
+ */
+
+#if defined(__IPHONE_OS_VERSION_MIN_REQUIRED) && __IPHONE_OS_VERSION_MIN_REQUIRED >= 100000
+#define OAL_LOCK_USE_UNFAIR_LOCK 1
+#elif defined(__TV_OS_VERSION_MIN_REQUIRED) && __TV_OS_VERSION_MIN_REQUIRED >= 100000
+#define OAL_LOCK_USE_UNFAIR_LOCK 1
+#elif defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 101200
+#define OAL_LOCK_USE_UNFAIR_LOCK 1
+#else
+#define OAL_LOCK_USE_UNFAIR_LOCK 0
+#endif
+
+#if OAL_LOCK_USE_UNFAIR_LOCK
+#include <os/lock.h>
+#endif
+
+
+/* Atomics */
+
+/** Read a simple flag or state value that other threads may write without a lock. */
+#define OAL_ATOMIC_LOAD(PTR) __atomic_load_n((PTR), __ATOMIC_ACQUIRE)
+
+/** Write a simple flag or state value that other threads may read without a lock. */
+#define OAL_ATOMIC_STORE(PTR, VALUE) __atomic_store_n((PTR), (VALUE), __ATOMIC_RELEASE)
+
+/** Add to a counter that other threads may read or change without a lock.
+ * Evaluates to the new value.
+ */
+#define OAL_ATOMIC_ADD(PTR, DELTA) __atomic_add_fetch((PTR), (DELTA), __ATOMIC_ACQ_REL)
+
+
+/* OALLock */
+
+/** A recursive lock that can be embedded directly in an object. */
+typedef struct
+{
+#if OAL_LOCK_USE_UNFAIR_LOCK
+	os_unfair_lock mutex;
+#else
+	pthread_mutex_t mutex;
+#endif
+	/** The thread holding the lock, or 0 if it is free. */
+	pthread_t owner;
+	/** How many times the owner has acquired the lock. */
+	unsigned int depth;
+} OALLock;
+
+/** Initialize a lock. Must be called before the lock is used.
+ *
+ * @param lock The lock to initialize.
+ */
+static inline void OALLockInit(OALLock* lock)
+{
+#if OAL_LOCK_USE_UNFAIR_LOCK
+	lock->mutex = OS_UNFAIR_LOCK_INIT;
+#else
+	pthread_mutex_init(&lock->mutex, NULL);
+#endif
+	lock->owner = (pthread_t)0;
+	lock->depth = 0;
+}
+
+/** Release any resources held by a lock.
+ *
+ * @param lock The lock to destroy.
+ */
+static inline void OALLockDestroy(OALLock* lock)
+{
+#if !OAL_LOCK_USE_UNFAIR_LOCK
+	pthread_mutex_destroy(&lock->mutex);
+#else
+	(void)lock;
+#endif
+}
+
+/** Acquire a lock, blocking until it is available.
+ * A thread that already holds the lock may acquire it again.
+ *
+ * @param lock The lock to acquire.
+ */
+static inline void OALLockAcquire(OALLock* lock)
+{
+	pthread_t self = pthread_self();
+	// Only the owning thread can ever see its own id here, so a racy read is safe.
+	if(pthread_equal(__atomic_load_n(&lock->owner, __ATOMIC_RELAXED), self))
+	{
+		lock->depth++;
+		return;
+	}
+#if OAL_LOCK_USE_UNFAIR_LOCK
+	os_unfair_lock_lock(&lock->mutex);
+#else
+	pthread_mutex_lock(&lock->mutex);
+#endif
+	__atomic_store_n(&lock->owner, self, __ATOMIC_RELAXED);
+	lock->depth = 1;
+}
+
+/** Release a lock that was acquired by the calling thread.
+ *
+ * @param lock The lock to release.
+ */
+static inline void OALLockRelease(OALLock* lock)
+{
+	if(--lock->depth > 0)
+	{
+		return;
+	}
+	__atomic_store_n(&lock->owner, (pthread_t)0, __ATOMIC_RELAXED);
+#if OAL_LOCK_USE_UNFAIR_LOCK
+	os_unfair_lock_unlock(&lock->mutex);
+#else
+	pthread_mutex_unlock(&lock->mutex);
+#endif
+}
+
+
+/* Scoped Locking */
+
+/** \cond */
+/** (INTERNAL USE) Used by OAL_LOCK_SCOPE to take the lock on scope entry. */
+static inline OALLock* OALLockScopeEnter(OALLock* lock)
+{
+	if(NULL != lock)
+	{
+		OALLockAcquire(lock);
+	}
+	return lock;
+}
+
+/** (INTERNAL USE) Used by OAL_LOCK_SCOPE to release the lock on scope exit. */
+static inline void OALLockScopeExit(OALLock** lock)
+{
+	if(NULL != *lock)
+	{
+		OALLockRelease(*lock);
+	}
+}
+/** \endcond */
+
+/** Hold a lock for the duration of the following statement or block.
+ * The lock is released however the block is left, including via return.
+ * Note: break and continue inside the block apply to the scope itself,
+ * not to an enclosing loop.
+ *
+ * @param LOCK Pointer to the OALLock to hold (NULL is allowed and does nothing).
+ */
+#define OAL_LOCK_SCOPE(LOCK) \
+	for(OALLock* oal_scopedLock __attribute__((cleanup(OALLockScopeExit))) = OALLockScopeEnter(LOCK), \
+		*oal_scopeOnce = (OALLock*)1; \
+		NULL != oal_scopeOnce; \
+		oal_scopeOnce = NULL)
+
+#endif /* HDR_OALLock_h */
@@ -0,0 +1,293 @@
+/*
+ *  OALLoopPoints.c
+ *  ObjectAL
+ *
+ *  Walks RIFF chunks or Ogg pages with stdio, skipping over anything that
+ *  isn't needed, so only the headers ever get read.
+ */
+
+#include "OALLoopPoints.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The Ogg comment header gets assembled in memory. Cover art can make it
+ * big, so give up past this. */
+#define kMaxCommentHeaderSize (4 * 1024 * 1024)
+
+/* The comment header is the second packet, so it's always near the start. */
+#define kMaxOggPages 16
+
+/* Bytes in a smpl chunk before its first loop, and in each loop. */
+#define kSmplHeaderSize 36
+#define kSmplLoopSize 24
+
+static uint32_t readLE32(const uint8_t* src)
+{
+	return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+
+/* WAV */
+
+static bool readWAVLoopPoints(FILE* file, int64_t* loopStart, int64_t* loopEnd)
+{
+	/* The file is positioned just after "RIFF", size, "WAVE". */
+	uint8_t chunkHeader[8];
+	while(1 == fread(chunkHeader, sizeof(chunkHeader), 1, file))
+	{
+		uint32_t size = readLE32(chunkHeader + 4);
+		if(0 == memcmp(chunkHeader, "smpl", 4))
+		{
+			uint8_t smpl[kSmplHeaderSize + kSmplLoopSize];
+			if(size < sizeof(smpl) || 1 != fread(smpl, sizeof(smpl), 1, file))
+			{
+				return false;
+			}
+			if(0 == readLE32(smpl + 28))
+			{
+				/* No loops. */
+				return false;
+			}
+			uint32_t start = readLE32(smpl + kSmplHeaderSize + 8);
+			uint32_t end = readLE32(smpl + kSmplHeaderSize + 12);
+			if(end < start)
+			{
+				return false;
+			}
+			*loopStart = start;
+			*loopEnd = (int64_t)end + 1;
+			return true;
+		}
+
+		/* Chunks are padded to an even size. */
+		if(0 != fseek(file, (long)size + (long)(size & 1), SEEK_CUR))
+		{
+			return false;
+		}
+	}
+	return false;
+}
+
+
+/* Ogg */
+
+/* If comment is NAME=number (NAME in any case), store the number in value. */
+static void readTag(const char* comment, size_t length, const char* name, int64_t* value)
+{
+	size_t nameLength = strlen(name);
+	if(length <= nameLength + 1 || '=' != comment[nameLength])
+	{
+		return;
+	}
+	for(size_t i = 0; i < nameLength; i++)
+	{
+		if(toupper((unsigned char)comment[i]) != name[i])
+		{
+			return;
+		}
+	}
+
+	int64_t result = 0;
+	for(size_t i = nameLength + 1; i < length; i++)
+	{
+		if(comment[i] < '0' || comment[i] > '9' || result > (INT64_MAX - 9) / 10)
+		{
+			return;
+		}
+		result = result * 10 + (comment[i] - '0');
+	}
+	*value = result;
+}
+
+static bool parseComments(const uint8_t* packet, size_t size, int64_t* loopStart, int64_t* loopEnd)
+{
+	size_t pos;
+	if(size >= 7 && 0 == memcmp(packet, "\x03vorbis", 7))
+	{
+		pos = 7;
+	}
+	else if(size >= 8 && 0 == memcmp(packet, "OpusTags", 8))
+	{
+		pos = 8;
+	}
+	else
+	{
+		return false;
+	}
+
+	/* A vendor string, then a count of comments, each a length and "NAME=value". */
+	if(size - pos < 4)
+	{
+		return false;
+	}
+	uint32_t vendorLength = readLE32(packet + pos);
+	pos += 4;
+	if(size - pos < (size_t)vendorLength + 4)
+	{
+		return false;
+	}
+	pos += vendorLength;
+	uint32_t count = readLE32(packet + pos);
+	pos += 4;
+
+	int64_t start = -1;
+	int64_t length = -1;
+	int64_t end = -1;
+	for(uint32_t i = 0; i < count && size - pos >= 4; i++)
+	{
+		uint32_t commentLength = readLE32(packet + pos);
+		pos += 4;
+		if(size - pos < commentLength)
+		{
+			break;
+		}
+		const char* comment = (const char*)packet + pos;
+		pos += commentLength;
+
+		readTag(comment, commentLength, "LOOPSTART", &start);
+		readTag(comment, commentLength, "LOOPLENGTH", &length);
+		readTag(comment, commentLength, "LOOPEND", &end);
+	}
+
+	if(start < 0)
+	{
+		return false;
+	}
+	*loopStart = start;
+	if(length > 0)
+	{
+		*loopEnd = start + length;
+	}
+	else if(end > start)
+	{
+		*loopEnd = end;
+	}
+	else
+	{
+		*loopEnd = kOALLoopPointsEndOfFile;
+	}
+	return true;
+}
+
+static bool readOggLoopPoints(FILE* file, int64_t* loopStart, int64_t* loopEnd)
+{
+	uint8_t header[27];
+	uint8_t lacing[255];
+	uint8_t* packet = NULL;
+	size_t packetSize = 0;
+	size_t capacity = 0;
+	int packetIndex = 0;
+	uint32_t serial = 0;
+	bool found = false;
+	bool done = false;
+
+	for(int page = 0; page < kMaxOggPages && !done && 1 == fread(header, sizeof(header), 1, file); page++)
+	{
+		if(0 != memcmp(header, "OggS", 4))
+		{
+			break;
+		}
+		int segmentCount = header[26];
+		if(segmentCount > 0 && 1 != fread(lacing, (size_t)segmentCount, 1, file))
+		{
+			break;
+		}
+
+		/* Only follow the first logical stream. */
+		uint32_t pageSerial = readLE32(header + 14);
+		if(0 == page)
+		{
+			serial = pageSerial;
+		}
+		if(pageSerial != serial)
+		{
+			long bodySize = 0;
+			for(int i = 0; i < segmentCount; i++)
+			{
+				bodySize += lacing[i];
+			}
+			if(0 != fseek(file, bodySize, SEEK_CUR))
+			{
+				break;
+			}
+			continue;
+		}
+
+		/* Packets are split into segments of 255 bytes, ending with a shorter one,
+		 * and can carry on over several pages. */
+		for(int i = 0; i < segmentCount && !done; i++)
+		{
+			size_t length = lacing[i];
+			if(1 == packetIndex)
+			{
+				if(packetSize + length > capacity)
+				{
+					size_t newCapacity = capacity > 0 ? capacity * 2 : 4096;
+					uint8_t* newPacket = newCapacity <= kMaxCommentHeaderSize ? realloc(packet, newCapacity) : NULL;
+					if(NULL == newPacket)
+					{
+						done = true;
+						break;
+					}
+					packet = newPacket;
+					capacity = newCapacity;
+				}
+				if(length > 0 && 1 != fread(packet + packetSize, length, 1, file))
+				{
+					done = true;
+					break;
+				}
+				packetSize += length;
+			}
+			else if(0 != fseek(file, (long)length, SEEK_CUR))
+			{
+				done = true;
+				break;
+			}
+
+			if(length < 255)
+			{
+				if(1 == packetIndex)
+				{
+					found = parseComments(packet, packetSize, loopStart, loopEnd);
+					done = true;
+				}
+				packetIndex++;
+			}
+		}
+	}
+
+	free(packet);
+	return found;
+}
+
+
+/* API */
+
+bool OALLoopPointsRead(const char* path, int64_t* loopStart, int64_t* loopEnd)
+{
+	FILE* file = fopen(path, "rb");
+	if(NULL == file)
+	{
+		return false;
+	}
+
+	bool result = false;
+	uint8_t magic[12];
+	if(1 == fread(magic, sizeof(magic), 1, file))
+	{
+		if(0 == memcmp(magic, "RIFF", 4) && 0 == memcmp(magic + 8, "WAVE", 4))
+		{
+			result = readWAVLoopPoints(file, loopStart, loopEnd);
+		}
+		else if(0 == memcmp(magic, "OggS", 4) && 0 == fseek(file, 0, SEEK_SET))
+		{
+			result = readOggLoopPoints(file, loopStart, loopEnd);
+		}
+	}
+
+	fclose(file);
+	return result;
+}
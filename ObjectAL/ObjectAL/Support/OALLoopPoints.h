@@ -0,0 +1,67 @@
+//
+//  OALLoopPoints.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#ifndef HDR_OALLoopPoints_h
+#define HDR_OALLoopPoints_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Reads loop points from audio file metadata, which the system decoders
+ * don't expose. Two conventions are understood:
+ *
+ * - WAV: The first loop of the "smpl" chunk. Its end is inclusive there,
+ *   and is converted to an exclusive end here.
+ * - Ogg Vorbis and Opus: The LOOPSTART comment, plus LOOPLENGTH or LOOPEND
+ *   (as written by RPG Maker and most game music tools). Without either,
+ *   the loop runs to the end of the file.
+ *
+ * Only the file's headers are read, never the audio data, and memory use is
+ * bounded no matter how big the file is.
+ */
+
+/** Marks a loop end that runs to the end of the audio. */
+#define kOALLoopPointsEndOfFile (-1)
+
+/** Read the loop points from an audio file's metadata.
+ *
+ * @param path The file's path.
+ * @param loopStart Receives the first frame of the loop.
+ * @param loopEnd Receives the frame just after the loop, or kOALLoopPointsEndOfFile.
+ * @return true if the file has loop points.
+ */
+bool OALLoopPointsRead(const char* path, int64_t* loopStart, int64_t* loopEnd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDR_OALLoopPoints_h */
@@ -0,0 +1,835 @@
+/*
+ *  OALSoftwareMixer.c
+ *  ObjectAL
+ *
+ *  Output is mixed in blocks of kBlockFrames into two planar float buses,
+ *  then interleaved. For each playing voice and block:
+ *  - Its samples are resampled (linear interpolation, 16.16 fixed point
+ *    position) into planar scratch buffers. Unpitched mono data is copied.
+ *  - Its gains are worked out once, and ramped from the previous block's
+ *    gains across the block, so that gain and pan changes don't click.
+ *  - The scratch buffers are added into the buses by a SIMD kernel.
+ *
+ *  A buffer's last frame interpolates toward the frame that plays after it:
+ *  the first frame of the next queued buffer, of the first buffer when
+ *  looping, or silence when the voice is about to stop.
+ */
+
+#include "OALSoftwareMixer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define MIX_WIDTH 8
+	typedef __m256 vfloat;
+	#define v_set1(X)        _mm256_set1_ps(X)
+	#define v_load(P)        _mm256_loadu_ps(P)
+	#define v_store(P, V)    _mm256_storeu_ps(P, V)
+	#define v_add(A, B)      _mm256_add_ps(A, B)
+	#define v_mul(A, B)      _mm256_mul_ps(A, B)
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define MIX_WIDTH 4
+	typedef __m128 vfloat;
+	#define v_set1(X)        _mm_set1_ps(X)
+	#define v_load(P)        _mm_loadu_ps(P)
+	#define v_store(P, V)    _mm_storeu_ps(P, V)
+	#define v_add(A, B)      _mm_add_ps(A, B)
+	#define v_mul(A, B)      _mm_mul_ps(A, B)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define MIX_WIDTH 4
+	typedef float32x4_t vfloat;
+	#define v_set1(X)        vdupq_n_f32(X)
+	#define v_load(P)        vld1q_f32(P)
+	#define v_store(P, V)    vst1q_f32(P, V)
+	#define v_add(A, B)      vaddq_f32(A, B)
+	#define v_mul(A, B)      vmulq_f32(A, B)
+#else
+	#define MIX_WIDTH 1
+#endif
+
+#define kBlockFrames 256
+
+#define kFracBits 16
+#define kFracOne (1u << kFracBits)
+#define kFracMask (kFracOne - 1)
+
+/* Same limit as OpenAL Soft, so a voice never skips more than 255 frames per output frame. */
+#define kMaxIncrement (255u << kFracBits)
+
+#define kQuarterPi 0.785398163f
+
+struct OALMixerBuffer
+{
+	/* Interleaved. */
+	float* samples;
+	size_t frames;
+	int channels;
+	int frequency;
+};
+
+typedef struct
+{
+	bool used;
+	int state;
+
+	float gain;
+	float pitch;
+	float position[3];
+	bool relative;
+	float referenceDistance;
+	float maxDistance;
+	float rolloffFactor;
+	bool looping;
+
+	const OALMixerBuffer* queue[kOALMixerMaxQueuedBuffers];
+	size_t queued;
+	/* The buffer playing now. Equal to queued once the voice has run off the end. */
+	size_t current;
+	size_t index;
+	uint32_t frac;
+
+	/* Gains the last block ended on, left and right. */
+	float lastGains[2];
+	/* False until the first block after play, which starts on its target gains. */
+	bool hasLastGains;
+} MixerVoice;
+
+struct OALSoftwareMixer
+{
+	int frequency;
+	int distanceModel;
+
+	float listenerPosition[3];
+	float listenerRight[3];
+	float listenerGain;
+
+	MixerVoice* voices;
+	size_t maxVoices;
+
+	float busLeft[kBlockFrames];
+	float busRight[kBlockFrames];
+	float scratchLeft[kBlockFrames];
+	float scratchRight[kBlockFrames];
+};
+
+
+/* Kernels */
+
+/* dst[i] += src[i] * (gain + step * i) */
+static void mixRamped(float* restrict dst, const float* restrict src, size_t count, float gain, float step)
+{
+	size_t i = 0;
+#if MIX_WIDTH > 1
+	float lanes[MIX_WIDTH];
+	for(int lane = 0; lane < MIX_WIDTH; lane++)
+	{
+		lanes[lane] = gain + step * (float)lane;
+	}
+	vfloat gains = v_load(lanes);
+	vfloat gainStep = v_set1(step * MIX_WIDTH);
+	for(; i + MIX_WIDTH <= count; i += MIX_WIDTH)
+	{
+		v_store(dst + i, v_add(v_load(dst + i), v_mul(v_load(src + i), gains)));
+		gains = v_add(gains, gainStep);
+	}
+#endif
+	for(; i < count; i++)
+	{
+		dst[i] += src[i] * (gain + step * (float)i);
+	}
+}
+
+/* Resample count frames starting at index + frac into planar buffers
+ * (right is untouched for mono). next is the frame that follows the buffer's
+ * last one. The caller makes sure no frame starts past the last one. */
+static void resample(const OALMixerBuffer* buffer,
+					 const float* next,
+					 size_t index,
+					 uint32_t frac,
+					 uint32_t increment,
+					 float* restrict left,
+					 float* restrict right,
+					 size_t count)
+{
+	const float* samples = buffer->samples;
+	const float scale = 1.0f / kFracOne;
+	size_t last = buffer->frames - 1;
+
+	/* Frames that start before the last one interpolate within the buffer. */
+	size_t inside = 0;
+	if(index < last)
+	{
+		uint64_t distance = ((uint64_t)(last - index) << kFracBits) - frac;
+		uint64_t frames = (distance + increment - 1) / increment;
+		inside = frames < count ? (size_t)frames : count;
+	}
+
+	size_t i = 0;
+	if(1 == buffer->channels)
+	{
+		if(kFracOne == increment && 0 == frac)
+		{
+			memcpy(left, samples + index, inside * sizeof(*left));
+			i = inside;
+			index += inside;
+		}
+		for(; i < inside; i++)
+		{
+			float s0 = samples[index];
+			float s1 = samples[index + 1];
+			left[i] = s0 + (s1 - s0) * ((float)frac * scale);
+			frac += increment;
+			index += frac >> kFracBits;
+			frac &= kFracMask;
+		}
+		for(; i < count; i++)
+		{
+			float s0 = samples[last];
+			left[i] = s0 + (next[0] - s0) * ((float)frac * scale);
+			frac += increment;
+		}
+		return;
+	}
+
+	for(; i < inside; i++)
+	{
+		const float* s = samples + index * 2;
+		float f = (float)frac * scale;
+		left[i] = s[0] + (s[2] - s[0]) * f;
+		right[i] = s[1] + (s[3] - s[1]) * f;
+		frac += increment;
+		index += frac >> kFracBits;
+		frac &= kFracMask;
+	}
+	for(; i < count; i++)
+	{
+		const float* s = samples + last * 2;
+		float f = (float)frac * scale;
+		left[i] = s[0] + (next[0] - s[0]) * f;
+		right[i] = s[1] + (next[1] - s[1]) * f;
+		frac += increment;
+	}
+}
+
+
+/* Voices */
+
+static MixerVoice* getVoice(const OALSoftwareMixer* mixer, int32_t voice)
+{
+	if(voice < 0 || (size_t)voice >= mixer->maxVoices || !mixer->voices[voice].used)
+	{
+		return NULL;
+	}
+	return &mixer->voices[voice];
+}
+
+static float distanceAttenuation(int model, float distance, const MixerVoice* v)
+{
+	float ref = v->referenceDistance;
+	float rolloff = v->rolloffFactor;
+	float maxDistance = v->maxDistance;
+	float attenuation = 1.0f;
+	switch(model)
+	{
+		case kOALMixerDistanceInverseClamped:
+		case kOALMixerDistanceLinearClamped:
+		case kOALMixerDistanceExponentClamped:
+			distance = fminf(fmaxf(distance, ref), maxDistance);
+			break;
+		default:
+			break;
+	}
+	switch(model)
+	{
+		case kOALMixerDistanceInverse:
+		case kOALMixerDistanceInverseClamped:
+		{
+			float denominator = ref + rolloff * (distance - ref);
+			if(denominator > 0)
+			{
+				attenuation = ref / denominator;
+			}
+			break;
+		}
+		case kOALMixerDistanceLinear:
+		case kOALMixerDistanceLinearClamped:
+			if(maxDistance > ref)
+			{
+				attenuation = 1.0f - rolloff * (distance - ref) / (maxDistance - ref);
+			}
+			break;
+		case kOALMixerDistanceExponent:
+		case kOALMixerDistanceExponentClamped:
+			if(distance > 0 && ref > 0)
+			{
+				attenuation = powf(distance / ref, -rolloff);
+			}
+			break;
+		default:
+			break;
+	}
+	return fmaxf(attenuation, 0);
+}
+
+/* Left and right gains for the voice's current settings. */
+static void voiceGains(const OALSoftwareMixer* mixer, const MixerVoice* v, int channels, float gains[2])
+{
+	float gain = v->gain * mixer->listenerGain;
+	if(2 == channels)
+	{
+		gains[0] = gains[1] = gain;
+		return;
+	}
+
+	float d[3];
+	for(int i = 0; i < 3; i++)
+	{
+		d[i] = v->relative ? v->position[i] : v->position[i] - mixer->listenerPosition[i];
+	}
+	float distance = sqrtf(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+	gain *= distanceAttenuation(mixer->distanceModel, distance, v);
+
+	/* Equal power pan on how far to the right of the listener the voice is. */
+	float pan = 0;
+	if(distance > 1e-6f)
+	{
+		const float* right = mixer->listenerRight;
+		pan = (d[0]*right[0] + d[1]*right[1] + d[2]*right[2]) / distance;
+	}
+	float angle = (pan + 1.0f) * kQuarterPi;
+	gains[0] = gain * cosf(angle);
+	gains[1] = gain * sinf(angle);
+}
+
+static uint32_t voiceIncrement(const OALSoftwareMixer* mixer, const MixerVoice* v, const OALMixerBuffer* buffer)
+{
+	double step = (double)v->pitch * buffer->frequency / mixer->frequency;
+	double increment = step * kFracOne + 0.5;
+	if(increment < 1)
+	{
+		return 1;
+	}
+	return increment > kMaxIncrement ? kMaxIncrement : (uint32_t)increment;
+}
+
+/* The first frame of whatever plays after the voice's current buffer. */
+static const float* nextFrame(const MixerVoice* v)
+{
+	static const float silence[2] = {0, 0};
+	if(v->current + 1 < v->queued)
+	{
+		return v->queue[v->current + 1]->samples;
+	}
+	if(v->looping)
+	{
+		return v->queue[0]->samples;
+	}
+	return silence;
+}
+
+/* Resample up to count frames of a voice into the scratch buffers, moving through
+ * its queue. Returns the number of frames produced, which is less than count if the
+ * voice stopped. */
+static size_t renderVoice(OALSoftwareMixer* mixer, MixerVoice* v, size_t count)
+{
+	size_t produced = 0;
+	while(produced < count)
+	{
+		const OALMixerBuffer* buffer = v->queue[v->current];
+		if(v->index < buffer->frames)
+		{
+			uint32_t increment = voiceIncrement(mixer, v, buffer);
+			uint64_t remaining = ((uint64_t)(buffer->frames - v->index) << kFracBits) - v->frac;
+			uint64_t available = (remaining + increment - 1) / increment;
+			size_t frames = count - produced;
+			if(available < frames)
+			{
+				frames = (size_t)available;
+			}
+			resample(buffer, nextFrame(v), v->index, v->frac, increment,
+					 mixer->scratchLeft + produced, mixer->scratchRight + produced, frames);
+
+			uint64_t position = ((uint64_t)v->index << kFracBits) + v->frac + (uint64_t)frames * increment;
+			v->index = (size_t)(position >> kFracBits);
+			v->frac = (uint32_t)(position & kFracMask);
+			produced += frames;
+			if(v->index < buffer->frames)
+			{
+				continue;
+			}
+		}
+
+		/* Ran off the end of this buffer. Carry the overshoot into the next one. */
+		v->index -= buffer->frames;
+		if(v->current + 1 < v->queued)
+		{
+			v->current++;
+		}
+		else if(v->looping)
+		{
+			v->current = 0;
+		}
+		else
+		{
+			v->state = kOALMixerStateStopped;
+			v->current = v->queued;
+			v->index = 0;
+			v->frac = 0;
+			break;
+		}
+	}
+	return produced;
+}
+
+static void mixVoice(OALSoftwareMixer* mixer, MixerVoice* v, size_t count)
+{
+	/* All buffers in a queue have the same format. */
+	int channels = v->queue[0]->channels;
+	float gains[2];
+	voiceGains(mixer, v, channels, gains);
+	if(!v->hasLastGains)
+	{
+		v->lastGains[0] = gains[0];
+		v->lastGains[1] = gains[1];
+		v->hasLastGains = true;
+	}
+
+	size_t produced = renderVoice(mixer, v, count);
+	float stepLeft = (gains[0] - v->lastGains[0]) / (float)count;
+	float stepRight = (gains[1] - v->lastGains[1]) / (float)count;
+	const float* right = 1 == channels ? mixer->scratchLeft : mixer->scratchRight;
+	if(0 != v->lastGains[0] || 0 != gains[0])
+	{
+		mixRamped(mixer->busLeft, mixer->scratchLeft, produced, v->lastGains[0], stepLeft);
+	}
+	if(0 != v->lastGains[1] || 0 != gains[1])
+	{
+		mixRamped(mixer->busRight, right, produced, v->lastGains[1], stepRight);
+	}
+	v->lastGains[0] = gains[0];
+	v->lastGains[1] = gains[1];
+}
+
+static void resetVoice(MixerVoice* v)
+{
+	memset(v, 0, sizeof(*v));
+	v->used = true;
+	v->state = kOALMixerStateInitial;
+	v->gain = 1.0f;
+	v->pitch = 1.0f;
+	v->referenceDistance = 1.0f;
+	v->maxDistance = INFINITY;
+	v->rolloffFactor = 1.0f;
+}
+
+
+/* Buffers */
+
+OALMixerBuffer* OALMixerBufferCreate(const void* data,
+									 size_t frames,
+									 int channels,
+									 int sampleFormat,
+									 int frequency)
+{
+	if(NULL == data || 0 == frames || frequency <= 0 || (1 != channels && 2 != channels) ||
+	   (kOALMixerSampleInt16 != sampleFormat && kOALMixerSampleFloat32 != sampleFormat))
+	{
+		return NULL;
+	}
+
+	OALMixerBuffer* buffer = calloc(1, sizeof(*buffer));
+	if(NULL == buffer)
+	{
+		return NULL;
+	}
+	size_t count = frames * (size_t)channels;
+	buffer->samples = malloc(count * sizeof(*buffer->samples));
+	if(NULL == buffer->samples)
+	{
+		free(buffer);
+		return NULL;
+	}
+	buffer->frames = frames;
+	buffer->channels = channels;
+	buffer->frequency = frequency;
+
+	if(kOALMixerSampleFloat32 == sampleFormat)
+	{
+		memcpy(buffer->samples, data, count * sizeof(float));
+	}
+	else
+	{
+		const int16_t* source = data;
+		for(size_t i = 0; i < count; i++)
+		{
+			buffer->samples[i] = (float)source[i] * (1.0f / 32768.0f);
+		}
+	}
+	return buffer;
+}
+
+void OALMixerBufferDestroy(OALMixerBuffer* buffer)
+{
+	if(NULL != buffer)
+	{
+		free(buffer->samples);
+		free(buffer);
+	}
+}
+
+size_t OALMixerBufferFrames(const OALMixerBuffer* buffer)
+{
+	return buffer->frames;
+}
+
+
+/* Mixer */
+
+OALSoftwareMixer* OALSoftwareMixerCreate(int frequency, size_t maxVoices)
+{
+	if(frequency <= 0)
+	{
+		return NULL;
+	}
+	OALSoftwareMixer* mixer = calloc(1, sizeof(*mixer));
+	if(NULL == mixer)
+	{
+		return NULL;
+	}
+	mixer->voices = calloc(maxVoices > 0 ? maxVoices : 1, sizeof(*mixer->voices));
+	if(NULL == mixer->voices)
+	{
+		free(mixer);
+		return NULL;
+	}
+	mixer->frequency = frequency;
+	mixer->maxVoices = maxVoices;
+	mixer->distanceModel = kOALMixerDistanceInverseClamped;
+	mixer->listenerRight[0] = 1.0f;
+	mixer->listenerGain = 1.0f;
+	return mixer;
+}
+
+void OALSoftwareMixerDestroy(OALSoftwareMixer* mixer)
+{
+	if(NULL != mixer)
+	{
+		free(mixer->voices);
+		free(mixer);
+	}
+}
+
+void OALSoftwareMixerSetListener(OALSoftwareMixer* mixer,
+								 const float position[3],
+								 const float at[3],
+								 const float up[3],
+								 float gain)
+{
+	memcpy(mixer->listenerPosition, position, sizeof(mixer->listenerPosition));
+	mixer->listenerGain = gain;
+
+	/* Right is at x up. */
+	float right[3] =
+	{
+		at[1]*up[2] - at[2]*up[1],
+		at[2]*up[0] - at[0]*up[2],
+		at[0]*up[1] - at[1]*up[0],
+	};
+	float length = sqrtf(right[0]*right[0] + right[1]*right[1] + right[2]*right[2]);
+	if(length > 0)
+	{
+		for(int i = 0; i < 3; i++)
+		{
+			mixer->listenerRight[i] = right[i] / length;
+		}
+	}
+}
+
+void OALSoftwareMixerSetDistanceModel(OALSoftwareMixer* mixer, int model)
+{
+	mixer->distanceModel = model;
+}
+
+void OALSoftwareMixerRender(OALSoftwareMixer* mixer, float* output, size_t frames)
+{
+	while(frames > 0)
+	{
+		size_t count = frames < kBlockFrames ? frames : kBlockFrames;
+		memset(mixer->busLeft, 0, count * sizeof(*mixer->busLeft));
+		memset(mixer->busRight, 0, count * sizeof(*mixer->busRight));
+
+		for(size_t i = 0; i < mixer->maxVoices; i++)
+		{
+			MixerVoice* v = &mixer->voices[i];
+			if(v->used && kOALMixerStatePlaying == v->state)
+			{
+				mixVoice(mixer, v, count);
+			}
+		}
+
+		for(size_t i = 0; i < count; i++)
+		{
+			output[i * 2] = mixer->busLeft[i];
+			output[i * 2 + 1] = mixer->busRight[i];
+		}
+		output += count * 2;
+		frames -= count;
+	}
+}
+
+
+/* Voice API */
+
+int32_t OALSoftwareMixerCreateVoice(OALSoftwareMixer* mixer)
+{
+	for(size_t i = 0; i < mixer->maxVoices; i++)
+	{
+		if(!mixer->voices[i].used)
+		{
+			resetVoice(&mixer->voices[i]);
+			return (int32_t)i;
+		}
+	}
+	return kOALMixerNoVoice;
+}
+
+void OALSoftwareMixerDestroyVoice(OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->used = false;
+	}
+}
+
+void OALSoftwareMixerSetGain(OALSoftwareMixer* mixer, int32_t voice, float gain)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->gain = fmaxf(gain, 0);
+	}
+}
+
+void OALSoftwareMixerSetPitch(OALSoftwareMixer* mixer, int32_t voice, float pitch)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v && pitch > 0)
+	{
+		v->pitch = pitch;
+	}
+}
+
+void OALSoftwareMixerSetPosition(OALSoftwareMixer* mixer, int32_t voice, float x, float y, float z)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->position[0] = x;
+		v->position[1] = y;
+		v->position[2] = z;
+	}
+}
+
+void OALSoftwareMixerSetRelative(OALSoftwareMixer* mixer, int32_t voice, bool relative)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->relative = relative;
+	}
+}
+
+void OALSoftwareMixerSetDistance(OALSoftwareMixer* mixer,
+								 int32_t voice,
+								 float referenceDistance,
+								 float maxDistance,
+								 float rolloffFactor)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->referenceDistance = fmaxf(referenceDistance, 0);
+		v->maxDistance = fmaxf(maxDistance, 0);
+		v->rolloffFactor = fmaxf(rolloffFactor, 0);
+	}
+}
+
+void OALSoftwareMixerSetLooping(OALSoftwareMixer* mixer, int32_t voice, bool looping)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->looping = looping;
+	}
+}
+
+bool OALSoftwareMixerSetBuffer(OALSoftwareMixer* mixer, int32_t voice, const OALMixerBuffer* buffer)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL == v || kOALMixerStatePlaying == v->state || kOALMixerStatePaused == v->state)
+	{
+		return false;
+	}
+	v->queued = 0;
+	v->current = 0;
+	v->index = 0;
+	v->frac = 0;
+	if(NULL != buffer)
+	{
+		v->queue[v->queued++] = buffer;
+	}
+	return true;
+}
+
+bool OALSoftwareMixerQueueBuffer(OALSoftwareMixer* mixer, int32_t voice, const OALMixerBuffer* buffer)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL == v || NULL == buffer || v->queued >= kOALMixerMaxQueuedBuffers)
+	{
+		return false;
+	}
+	if(v->queued > 0 &&
+	   (v->queue[0]->channels != buffer->channels || v->queue[0]->frequency != buffer->frequency))
+	{
+		return false;
+	}
+	v->queue[v->queued++] = buffer;
+	return true;
+}
+
+size_t OALSoftwareMixerBuffersProcessed(const OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL == v)
+	{
+		return 0;
+	}
+	if(kOALMixerStateStopped == v->state)
+	{
+		return v->queued;
+	}
+	return v->looping ? 0 : v->current;
+}
+
+size_t OALSoftwareMixerUnqueueBuffers(OALSoftwareMixer* mixer,
+									  int32_t voice,
+									  const OALMixerBuffer** buffers,
+									  size_t maxBuffers)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	size_t processed = OALSoftwareMixerBuffersProcessed(mixer, voice);
+	size_t count = processed < maxBuffers ? processed : maxBuffers;
+	if(NULL == v || 0 == count)
+	{
+		return 0;
+	}
+	if(NULL != buffers)
+	{
+		memcpy(buffers, v->queue, count * sizeof(*buffers));
+	}
+	memmove(v->queue, v->queue + count, (v->queued - count) * sizeof(*v->queue));
+	v->queued -= count;
+	v->current = v->current > count ? v->current - count : 0;
+	return count;
+}
+
+void OALSoftwareMixerPlay(OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL == v)
+	{
+		return;
+	}
+	if(0 == v->queued)
+	{
+		v->state = kOALMixerStateStopped;
+		return;
+	}
+	if(kOALMixerStatePaused != v->state)
+	{
+		v->current = 0;
+		v->index = 0;
+		v->frac = 0;
+		v->hasLastGains = false;
+	}
+	v->state = kOALMixerStatePlaying;
+}
+
+void OALSoftwareMixerPause(OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v && kOALMixerStatePlaying == v->state)
+	{
+		v->state = kOALMixerStatePaused;
+	}
+}
+
+void OALSoftwareMixerStop(OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v && kOALMixerStateInitial != v->state)
+	{
+		v->state = kOALMixerStateStopped;
+		v->current = v->queued;
+		v->index = 0;
+		v->frac = 0;
+	}
+}
+
+void OALSoftwareMixerRewind(OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL != v)
+	{
+		v->state = kOALMixerStateInitial;
+		v->current = 0;
+		v->index = 0;
+		v->frac = 0;
+	}
+}
+
+int OALSoftwareMixerGetState(const OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	return NULL == v ? kOALMixerStateInitial : v->state;
+}
+
+double OALSoftwareMixerGetOffset(const OALSoftwareMixer* mixer, int32_t voice)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL == v || (kOALMixerStatePlaying != v->state && kOALMixerStatePaused != v->state))
+	{
+		return 0;
+	}
+	double offset = (double)v->index + (double)v->frac / kFracOne;
+	for(size_t i = 0; i < v->current; i++)
+	{
+		offset += (double)v->queue[i]->frames;
+	}
+	return offset;
+}
+
+void OALSoftwareMixerSetOffset(OALSoftwareMixer* mixer, int32_t voice, double frames)
+{
+	MixerVoice* v = getVoice(mixer, voice);
+	if(NULL == v || frames < 0)
+	{
+		return;
+	}
+	for(size_t i = 0; i < v->queued; i++)
+	{
+		if(frames < (double)v->queue[i]->frames)
+		{
+			v->current = i;
+			v->index = (size_t)frames;
+			v->frac = (uint32_t)((frames - (double)v->index) * kFracOne);
+			return;
+		}
+		frames -= (double)v->queue[i]->frames;
+	}
+}
@@ -0,0 +1,272 @@
+//
+//  OALSoftwareMixer.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#ifndef HDR_OALSoftwareMixer_h
+#define HDR_OALSoftwareMixer_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A software mixer with the same voice semantics as an OpenAL source: gain,
+ * pitch, 3D panning with the OpenAL distance models, looping and buffer queues.
+ *
+ * Nothing is rendered until the caller asks for it: OALSoftwareMixerRender()
+ * mixes the requested number of frames into a float buffer. This makes it
+ * usable headless (tests, servers, offline rendering) or from inside another
+ * engine's audio callback, with a mixing cost that doesn't depend on the
+ * platform's OpenAL. Mixing uses AVX, SSE2 or NEON when the compiler targets
+ * them, and plain C otherwise.
+ *
+ * Mono buffers are panned and attenuated by distance. Stereo buffers are
+ * played as is (only gain and pitch apply), as in OpenAL.
+ *
+ * This is a standalone mixer, not a backend for the rest of ObjectAL:
+ * ALWrapper, ALSource and friends always go through OpenAL. Use it directly
+ * where you want to own the mixing (for example to feed another engine), and
+ * map your sources onto its voices yourself.
+ *
+ * Not thread safe: the owner does the locking. Buffers must outlive any voice
+ * they are queued on.
+ */
+
+typedef struct OALSoftwareMixer OALSoftwareMixer;
+typedef struct OALMixerBuffer OALMixerBuffer;
+
+/** Marks a voice that couldn't be created. */
+#define kOALMixerNoVoice (-1)
+
+/** The most buffers a voice can have queued at once. */
+#define kOALMixerMaxQueuedBuffers 32
+
+/** Sample formats for OALMixerBufferCreate(). */
+enum
+{
+	kOALMixerSampleInt16,
+	kOALMixerSampleFloat32,
+};
+
+/** Distance models. Same behavior as the OpenAL models of the same names. */
+enum
+{
+	kOALMixerDistanceNone,
+	kOALMixerDistanceInverse,
+	kOALMixerDistanceInverseClamped,
+	kOALMixerDistanceLinear,
+	kOALMixerDistanceLinearClamped,
+	kOALMixerDistanceExponent,
+	kOALMixerDistanceExponentClamped,
+};
+
+/** Voice states. Same meaning as AL_INITIAL, AL_PLAYING, AL_PAUSED and AL_STOPPED. */
+enum
+{
+	kOALMixerStateInitial,
+	kOALMixerStatePlaying,
+	kOALMixerStatePaused,
+	kOALMixerStateStopped,
+};
+
+
+/* Buffers */
+
+/** Create a buffer from interleaved sample data. The data is copied.
+ *
+ * @param data The samples.
+ * @param frames The number of sample frames.
+ * @param channels 1 (mono) or 2 (stereo).
+ * @param sampleFormat kOALMixerSampleInt16 or kOALMixerSampleFloat32.
+ * @param frequency The sample rate of the data.
+ * @return A new buffer, or NULL if out of memory or the format is not supported.
+ */
+OALMixerBuffer* OALMixerBufferCreate(const void* data,
+									 size_t frames,
+									 int channels,
+									 int sampleFormat,
+									 int frequency);
+
+/** Destroy a buffer. It must not be queued on any voice.
+ *
+ * @param buffer The buffer to destroy.
+ */
+void OALMixerBufferDestroy(OALMixerBuffer* buffer);
+
+/** Get the number of sample frames in a buffer.
+ *
+ * @param buffer The buffer.
+ * @return The number of frames.
+ */
+size_t OALMixerBufferFrames(const OALMixerBuffer* buffer);
+
+
+/* Mixer */
+
+/** Create a mixer.
+ *
+ * @param frequency The output sample rate.
+ * @param maxVoices The most voices that can exist at once.
+ * @return A new mixer, or NULL if out of memory.
+ */
+OALSoftwareMixer* OALSoftwareMixerCreate(int frequency, size_t maxVoices);
+
+/** Destroy a mixer and all of its voices. Buffers are left alone.
+ *
+ * @param mixer The mixer to destroy.
+ */
+void OALSoftwareMixerDestroy(OALSoftwareMixer* mixer);
+
+/** Set the listener. at and up don't need to be normalized.
+ *
+ * @param mixer The mixer.
+ * @param position The listener's position (x, y, z).
+ * @param at The direction the listener faces.
+ * @param up The listener's up direction.
+ * @param gain The listener's gain (master volume).
+ */
+void OALSoftwareMixerSetListener(OALSoftwareMixer* mixer,
+								 const float position[3],
+								 const float at[3],
+								 const float up[3],
+								 float gain);
+
+/** Set the distance model (kOALMixerDistanceXYZ). Default: kOALMixerDistanceInverseClamped.
+ *
+ * @param mixer The mixer.
+ * @param model The distance model.
+ */
+void OALSoftwareMixerSetDistanceModel(OALSoftwareMixer* mixer, int model);
+
+/** Mix the next frames of all playing voices.
+ *
+ * @param mixer The mixer.
+ * @param output Receives interleaved stereo floats (2 * frames values). Overwritten, not added to.
+ * @param frames The number of frames to render.
+ */
+void OALSoftwareMixerRender(OALSoftwareMixer* mixer, float* output, size_t frames);
+
+
+/* Voices */
+
+/** Create a voice, with the same defaults as a new OpenAL source.
+ *
+ * @param mixer The mixer.
+ * @return The voice's handle, or kOALMixerNoVoice if maxVoices are in use.
+ */
+int32_t OALSoftwareMixerCreateVoice(OALSoftwareMixer* mixer);
+
+/** Destroy a voice. Its handle may be reused by a later create.
+ *
+ * @param mixer The mixer.
+ * @param voice The voice.
+ */
+void OALSoftwareMixerDestroyVoice(OALSoftwareMixer* mixer, int32_t voice);
+
+/** Set a voice's gain (AL_GAIN). */
+void OALSoftwareMixerSetGain(OALSoftwareMixer* mixer, int32_t voice, float gain);
+
+/** Set a voice's pitch (AL_PITCH). */
+void OALSoftwareMixerSetPitch(OALSoftwareMixer* mixer, int32_t voice, float pitch);
+
+/** Set a voice's position (AL_POSITION). */
+void OALSoftwareMixerSetPosition(OALSoftwareMixer* mixer, int32_t voice, float x, float y, float z);
+
+/** Set whether a voice's position is relative to the listener (AL_SOURCE_RELATIVE). */
+void OALSoftwareMixerSetRelative(OALSoftwareMixer* mixer, int32_t voice, bool relative);
+
+/** Set a voice's distance attenuation parameters
+ * (AL_REFERENCE_DISTANCE, AL_MAX_DISTANCE, AL_ROLLOFF_FACTOR).
+ */
+void OALSoftwareMixerSetDistance(OALSoftwareMixer* mixer,
+								 int32_t voice,
+								 float referenceDistance,
+								 float maxDistance,
+								 float rolloffFactor);
+
+/** Set whether a voice loops (AL_LOOPING). A looping voice with several
+ * buffers queued loops over the whole queue.
+ */
+void OALSoftwareMixerSetLooping(OALSoftwareMixer* mixer, int32_t voice, bool looping);
+
+/** Replace a voice's queue with a single buffer, or clear it with NULL (AL_BUFFER).
+ * Only allowed while the voice is initial or stopped.
+ *
+ * @return true if the buffer was set.
+ */
+bool OALSoftwareMixerSetBuffer(OALSoftwareMixer* mixer, int32_t voice, const OALMixerBuffer* buffer);
+
+/** Add a buffer to the end of a voice's queue (alSourceQueueBuffers).
+ * All buffers in a queue must have the same channel count and frequency.
+ *
+ * @return true if the buffer was queued.
+ */
+bool OALSoftwareMixerQueueBuffer(OALSoftwareMixer* mixer, int32_t voice, const OALMixerBuffer* buffer);
+
+/** Remove the buffers a voice has finished with from the front of its queue
+ * (alSourceUnqueueBuffers).
+ *
+ * @param buffers Receives the removed buffers (may be NULL if maxBuffers is 0).
+ * @param maxBuffers The most buffers to remove.
+ * @return The number of buffers removed.
+ */
+size_t OALSoftwareMixerUnqueueBuffers(OALSoftwareMixer* mixer,
+									  int32_t voice,
+									  const OALMixerBuffer** buffers,
+									  size_t maxBuffers);
+
+/** Get the number of buffers a voice has finished with (AL_BUFFERS_PROCESSED). */
+size_t OALSoftwareMixerBuffersProcessed(const OALSoftwareMixer* mixer, int32_t voice);
+
+/** Start or resume a voice (alSourcePlay). Playing a playing voice restarts it. */
+void OALSoftwareMixerPlay(OALSoftwareMixer* mixer, int32_t voice);
+
+/** Pause a voice (alSourcePause). */
+void OALSoftwareMixerPause(OALSoftwareMixer* mixer, int32_t voice);
+
+/** Stop a voice (alSourceStop). All queued buffers count as processed. */
+void OALSoftwareMixerStop(OALSoftwareMixer* mixer, int32_t voice);
+
+/** Return a voice to the initial state at the start of its queue (alSourceRewind). */
+void OALSoftwareMixerRewind(OALSoftwareMixer* mixer, int32_t voice);
+
+/** Get a voice's state (kOALMixerStateXYZ). */
+int OALSoftwareMixerGetState(const OALSoftwareMixer* mixer, int32_t voice);
+
+/** Get a voice's playback offset in frames from the start of its queue (AL_SAMPLE_OFFSET). */
+double OALSoftwareMixerGetOffset(const OALSoftwareMixer* mixer, int32_t voice);
+
+/** Move a voice's playback position (AL_SAMPLE_OFFSET). */
+void OALSoftwareMixerSetOffset(OALSoftwareMixer* mixer, int32_t voice, double frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDR_OALSoftwareMixer_h */
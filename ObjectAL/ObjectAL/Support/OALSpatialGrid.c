@@ -0,0 +1,646 @@
+/*
+ *  OALSpatialGrid.c
+ *  ObjectAL
+ *
+ *  Items live in one array, with a free list so that handles stay stable.
+ *  Each occupied cell is an entry in an open addressed hash table, keyed by
+ *  its integer coordinates, and heads a doubly linked list of its items.
+ *  Cells that empty out stay in the table until the next rehash.
+ */
+
+#include "OALSpatialGrid.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Cell coordinates are clamped to this, so that far away or broken positions
+ * still land in a cell. */
+#define kMaxCellCoordinate 1000000000.0f
+
+#define kNoIndex (-1)
+
+typedef struct
+{
+	void* item;
+	float x, y, z;
+	int32_t cell;
+	int32_t next;
+	int32_t prev;
+} GridEntry;
+
+typedef struct
+{
+	int32_t cx, cy, cz;
+	int32_t head;
+	int32_t used;
+} GridCell;
+
+struct OALSpatialGrid
+{
+	float cellSize;
+	float invCellSize;
+
+	GridEntry* entries;
+	int32_t entryCapacity;
+	int32_t entryCount;
+	int32_t freeHead;
+	size_t itemCount;
+
+	GridCell* cells;
+	int32_t cellCapacity;
+	/* Cells holding at least one item. Empty cells are removed straight away. */
+	int32_t cellsUsed;
+};
+
+
+/* Cells */
+
+static int32_t cellCoordinate(const OALSpatialGrid* grid, float value)
+{
+	float scaled = floorf(value * grid->invCellSize);
+	if(!(scaled > -kMaxCellCoordinate))
+	{
+		/* Also catches NaN. */
+		scaled = -kMaxCellCoordinate;
+	}
+	if(scaled > kMaxCellCoordinate)
+	{
+		scaled = kMaxCellCoordinate;
+	}
+	return (int32_t)scaled;
+}
+
+static uint32_t cellHash(int32_t cx, int32_t cy, int32_t cz)
+{
+	return ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u) ^ ((uint32_t)cz * 83492791u);
+}
+
+static int32_t findCell(const OALSpatialGrid* grid, int32_t cx, int32_t cy, int32_t cz)
+{
+	if(0 == grid->cellCapacity)
+	{
+		return kNoIndex;
+	}
+	uint32_t mask = (uint32_t)grid->cellCapacity - 1;
+	for(uint32_t index = cellHash(cx, cy, cz) & mask;; index = (index + 1) & mask)
+	{
+		const GridCell* cell = &grid->cells[index];
+		if(!cell->used)
+		{
+			return kNoIndex;
+		}
+		if(cell->cx == cx && cell->cy == cy && cell->cz == cz)
+		{
+			return (int32_t)index;
+		}
+	}
+}
+
+static int rehashCells(OALSpatialGrid* grid, int32_t capacity)
+{
+	GridCell* cells = calloc((size_t)capacity, sizeof(*cells));
+	if(NULL == cells)
+	{
+		return 0;
+	}
+
+	GridCell* oldCells = grid->cells;
+	int32_t oldCapacity = grid->cellCapacity;
+	grid->cells = cells;
+	grid->cellCapacity = capacity;
+	grid->cellsUsed = 0;
+
+	/* Carry over the occupied cells only, and point their items at the new slots. */
+	uint32_t mask = (uint32_t)capacity - 1;
+	for(int32_t i = 0; i < oldCapacity; i++)
+	{
+		GridCell* old = &oldCells[i];
+		if(!old->used)
+		{
+			continue;
+		}
+		uint32_t index = cellHash(old->cx, old->cy, old->cz) & mask;
+		while(cells[index].used)
+		{
+			index = (index + 1) & mask;
+		}
+		cells[index] = *old;
+		grid->cellsUsed++;
+		for(int32_t entry = old->head; kNoIndex != entry; entry = grid->entries[entry].next)
+		{
+			grid->entries[entry].cell = (int32_t)index;
+		}
+	}
+	free(oldCells);
+	return 1;
+}
+
+static int32_t findOrAddCell(OALSpatialGrid* grid, int32_t cx, int32_t cy, int32_t cz)
+{
+	int32_t index = findCell(grid, cx, cy, cz);
+	if(kNoIndex != index)
+	{
+		return index;
+	}
+
+	/* Keep the table at most half full. */
+	if((grid->cellsUsed + 1) * 2 > grid->cellCapacity)
+	{
+		int32_t capacity = grid->cellCapacity > 0 ? grid->cellCapacity : 32;
+		while((grid->cellsUsed + 1) * 2 > capacity)
+		{
+			capacity *= 2;
+		}
+		if(!rehashCells(grid, capacity))
+		{
+			return kNoIndex;
+		}
+	}
+
+	uint32_t mask = (uint32_t)grid->cellCapacity - 1;
+	uint32_t slot = cellHash(cx, cy, cz) & mask;
+	while(grid->cells[slot].used)
+	{
+		slot = (slot + 1) & mask;
+	}
+	GridCell* cell = &grid->cells[slot];
+	cell->cx = cx;
+	cell->cy = cy;
+	cell->cz = cz;
+	cell->head = kNoIndex;
+	cell->used = 1;
+	grid->cellsUsed++;
+	return (int32_t)slot;
+}
+
+/* Remove a cell that has become empty. Later cells in its probe run are
+ * shifted back into the gap, so that lookups never stop early. */
+static void removeCell(OALSpatialGrid* grid, int32_t cellIndex)
+{
+	uint32_t mask = (uint32_t)grid->cellCapacity - 1;
+	uint32_t hole = (uint32_t)cellIndex;
+	grid->cells[hole].used = 0;
+	grid->cellsUsed--;
+
+	for(uint32_t index = (hole + 1) & mask; grid->cells[index].used; index = (index + 1) & mask)
+	{
+		/* A cell can fill the hole if its home slot isn't between the hole and itself. */
+		uint32_t home = cellHash(grid->cells[index].cx, grid->cells[index].cy, grid->cells[index].cz) & mask;
+		if(((index - home) & mask) < ((index - hole) & mask))
+		{
+			continue;
+		}
+		grid->cells[hole] = grid->cells[index];
+		grid->cells[index].used = 0;
+		for(int32_t entry = grid->cells[hole].head; kNoIndex != entry; entry = grid->entries[entry].next)
+		{
+			grid->entries[entry].cell = (int32_t)hole;
+		}
+		hole = index;
+	}
+}
+
+static void linkEntry(OALSpatialGrid* grid, int32_t handle, int32_t cellIndex)
+{
+	GridEntry* entry = &grid->entries[handle];
+	GridCell* cell = &grid->cells[cellIndex];
+	entry->cell = cellIndex;
+	entry->prev = kNoIndex;
+	entry->next = cell->head;
+	if(kNoIndex != cell->head)
+	{
+		grid->entries[cell->head].prev = handle;
+	}
+	cell->head = handle;
+}
+
+static void unlinkEntry(OALSpatialGrid* grid, int32_t handle)
+{
+	GridEntry* entry = &grid->entries[handle];
+	if(kNoIndex != entry->prev)
+	{
+		grid->entries[entry->prev].next = entry->next;
+	}
+	else
+	{
+		grid->cells[entry->cell].head = entry->next;
+	}
+	if(kNoIndex != entry->next)
+	{
+		grid->entries[entry->next].prev = entry->prev;
+	}
+	entry->next = entry->prev = kNoIndex;
+}
+
+
+/* Interface */
+
+OALSpatialGrid* OALSpatialGridCreate(float cellSize)
+{
+	OALSpatialGrid* grid = calloc(1, sizeof(*grid));
+	if(NULL == grid)
+	{
+		return NULL;
+	}
+	grid->cellSize = cellSize > 0 ? cellSize : 1.0f;
+	grid->invCellSize = 1.0f / grid->cellSize;
+	grid->freeHead = kNoIndex;
+	return grid;
+}
+
+void OALSpatialGridDestroy(OALSpatialGrid* grid)
+{
+	if(NULL != grid)
+	{
+		free(grid->entries);
+		free(grid->cells);
+		free(grid);
+	}
+}
+
+int32_t OALSpatialGridInsert(OALSpatialGrid* grid, void* item, float x, float y, float z)
+{
+	int32_t handle = grid->freeHead;
+	bool reused = kNoIndex != handle;
+	if(!reused)
+	{
+		if(grid->entryCount == grid->entryCapacity)
+		{
+			int32_t capacity = grid->entryCapacity > 0 ? grid->entryCapacity * 2 : 64;
+			GridEntry* entries = realloc(grid->entries, (size_t)capacity * sizeof(*entries));
+			if(NULL == entries)
+			{
+				return kOALSpatialGridNoHandle;
+			}
+			grid->entries = entries;
+			grid->entryCapacity = capacity;
+		}
+		handle = grid->entryCount;
+	}
+
+	int32_t cellIndex = findOrAddCell(grid, cellCoordinate(grid, x), cellCoordinate(grid, y), cellCoordinate(grid, z));
+	if(kNoIndex == cellIndex)
+	{
+		return kOALSpatialGridNoHandle;
+	}
+
+	if(reused)
+	{
+		grid->freeHead = grid->entries[handle].next;
+	}
+	else
+	{
+		grid->entryCount++;
+	}
+
+	GridEntry* entry = &grid->entries[handle];
+	entry->item = item;
+	entry->x = x;
+	entry->y = y;
+	entry->z = z;
+	linkEntry(grid, handle, cellIndex);
+	grid->itemCount++;
+	return handle;
+}
+
+void OALSpatialGridMove(OALSpatialGrid* grid, int32_t handle, float x, float y, float z)
+{
+	if(handle < 0 || handle >= grid->entryCount || kNoIndex == grid->entries[handle].cell)
+	{
+		return;
+	}
+	GridEntry* entry = &grid->entries[handle];
+	entry->x = x;
+	entry->y = y;
+	entry->z = z;
+
+	int32_t cx = cellCoordinate(grid, x);
+	int32_t cy = cellCoordinate(grid, y);
+	int32_t cz = cellCoordinate(grid, z);
+	const GridCell* current = &grid->cells[entry->cell];
+	if(current->cx == cx && current->cy == cy && current->cz == cz)
+	{
+		return;
+	}
+
+	/* Find the new cell before leaving the old one, which keeps the old one
+	 * occupied (and so carried over) if this rehashes. */
+	int32_t cellIndex = findOrAddCell(grid, cx, cy, cz);
+	if(kNoIndex == cellIndex)
+	{
+		/* Out of memory. Leave it in its old cell. */
+		return;
+	}
+	int32_t oldCellIndex = entry->cell;
+	unlinkEntry(grid, handle);
+	linkEntry(grid, handle, cellIndex);
+	if(kNoIndex == grid->cells[oldCellIndex].head)
+	{
+		removeCell(grid, oldCellIndex);
+	}
+}
+
+void OALSpatialGridRemove(OALSpatialGrid* grid, int32_t handle)
+{
+	if(handle < 0 || handle >= grid->entryCount || kNoIndex == grid->entries[handle].cell)
+	{
+		return;
+	}
+	int32_t cellIndex = grid->entries[handle].cell;
+	unlinkEntry(grid, handle);
+	if(kNoIndex == grid->cells[cellIndex].head)
+	{
+		removeCell(grid, cellIndex);
+	}
+	GridEntry* entry = &grid->entries[handle];
+	entry->item = NULL;
+	entry->cell = kNoIndex;
+	entry->next = grid->freeHead;
+	grid->freeHead = handle;
+	grid->itemCount--;
+}
+
+size_t OALSpatialGridCount(const OALSpatialGrid* grid)
+{
+	return grid->itemCount;
+}
+
+size_t OALSpatialGridQueryRadius(const OALSpatialGrid* grid,
+								 float x, float y, float z,
+								 float radius,
+								 void** items,
+								 size_t maxItems)
+{
+	size_t found = 0;
+	float radiusSquared = radius * radius;
+
+	int32_t minX = cellCoordinate(grid, x - radius);
+	int32_t maxX = cellCoordinate(grid, x + radius);
+	int32_t minY = cellCoordinate(grid, y - radius);
+	int32_t maxY = cellCoordinate(grid, y + radius);
+	int32_t minZ = cellCoordinate(grid, z - radius);
+	int32_t maxZ = cellCoordinate(grid, z + radius);
+	double volume = ((double)maxX - minX + 1) * ((double)maxY - minY + 1) * ((double)maxZ - minZ + 1);
+
+	if(volume <= (double)grid->cellsUsed)
+	{
+		/* Look up each cell the sphere's bounding box covers. */
+		for(int32_t cx = minX; cx <= maxX; cx++)
+		{
+			for(int32_t cy = minY; cy <= maxY; cy++)
+			{
+				for(int32_t cz = minZ; cz <= maxZ; cz++)
+				{
+					int32_t cellIndex = findCell(grid, cx, cy, cz);
+					if(kNoIndex == cellIndex)
+					{
+						continue;
+					}
+					for(int32_t i = grid->cells[cellIndex].head; kNoIndex != i; i = grid->entries[i].next)
+					{
+						const GridEntry* entry = &grid->entries[i];
+						float dx = entry->x - x;
+						float dy = entry->y - y;
+						float dz = entry->z - z;
+						if(dx*dx + dy*dy + dz*dz <= radiusSquared)
+						{
+							if(found < maxItems)
+							{
+								items[found] = entry->item;
+							}
+							found++;
+						}
+					}
+				}
+			}
+		}
+		return found;
+	}
+
+	/* The box covers more cells than are occupied, so walk the occupied ones instead. */
+	for(int32_t c = 0; c < grid->cellCapacity; c++)
+	{
+		const GridCell* cell = &grid->cells[c];
+		if(!cell->used ||
+		   cell->cx < minX || cell->cx > maxX ||
+		   cell->cy < minY || cell->cy > maxY ||
+		   cell->cz < minZ || cell->cz > maxZ)
+		{
+			continue;
+		}
+		for(int32_t i = cell->head; kNoIndex != i; i = grid->entries[i].next)
+		{
+			const GridEntry* entry = &grid->entries[i];
+			float dx = entry->x - x;
+			float dy = entry->y - y;
+			float dz = entry->z - z;
+			if(dx*dx + dy*dy + dz*dz <= radiusSquared)
+			{
+				if(found < maxItems)
+				{
+					items[found] = entry->item;
+				}
+				found++;
+			}
+		}
+	}
+	return found;
+}
+
+
+/* Nearest Query */
+
+/* A max-heap on distance, holding the best candidates so far. */
+typedef struct
+{
+	void** items;
+	float* distances;
+	size_t count;
+	size_t capacity;
+} NearestHeap;
+
+static void heapOffer(NearestHeap* heap, void* item, float distance)
+{
+	size_t i;
+	if(heap->count < heap->capacity)
+	{
+		/* Sift up. */
+		i = heap->count++;
+		while(i > 0)
+		{
+			size_t parent = (i - 1) / 2;
+			if(heap->distances[parent] >= distance)
+			{
+				break;
+			}
+			heap->items[i] = heap->items[parent];
+			heap->distances[i] = heap->distances[parent];
+			i = parent;
+		}
+	}
+	else
+	{
+		if(distance >= heap->distances[0])
+		{
+			return;
+		}
+		/* Replace the furthest and sift down. */
+		i = 0;
+		for(;;)
+		{
+			size_t child = i * 2 + 1;
+			if(child >= heap->count)
+			{
+				break;
+			}
+			if(child + 1 < heap->count && heap->distances[child + 1] > heap->distances[child])
+			{
+				child++;
+			}
+			if(heap->distances[child] <= distance)
+			{
+				break;
+			}
+			heap->items[i] = heap->items[child];
+			heap->distances[i] = heap->distances[child];
+			i = child;
+		}
+	}
+	heap->items[i] = item;
+	heap->distances[i] = distance;
+}
+
+static void offerCell(const OALSpatialGrid* grid,
+					  int32_t cellIndex,
+					  float x, float y, float z,
+					  float maxRadiusSquared,
+					  NearestHeap* heap,
+					  size_t* visited)
+{
+	for(int32_t i = grid->cells[cellIndex].head; kNoIndex != i; i = grid->entries[i].next)
+	{
+		const GridEntry* entry = &grid->entries[i];
+		float dx = entry->x - x;
+		float dy = entry->y - y;
+		float dz = entry->z - z;
+		float distance = dx*dx + dy*dy + dz*dz;
+		(*visited)++;
+		if(distance <= maxRadiusSquared)
+		{
+			heapOffer(heap, entry->item, distance);
+		}
+	}
+}
+
+size_t OALSpatialGridQueryNearest(const OALSpatialGrid* grid,
+								  float x, float y, float z,
+								  float maxRadius,
+								  void** items,
+								  size_t maxItems)
+{
+	if(0 == maxItems || 0 == grid->itemCount)
+	{
+		return 0;
+	}
+
+	NearestHeap heap = {items, malloc(maxItems * sizeof(float)), 0, maxItems};
+	if(NULL == heap.distances)
+	{
+		return 0;
+	}
+
+	float maxRadiusSquared = maxRadius * maxRadius;
+	int32_t centerX = cellCoordinate(grid, x);
+	int32_t centerY = cellCoordinate(grid, y);
+	int32_t centerZ = cellCoordinate(grid, z);
+	int32_t maxRing = (int32_t)fminf(ceilf(maxRadius * grid->invCellSize) + 1, kMaxCellCoordinate);
+	size_t visited = 0;
+
+	/* Search outward in shells of cells. Everything in shell k + 1 is at least
+	 * k cells away, so we can stop once the heap is full of closer items. */
+	for(int32_t ring = 0; ring <= maxRing && visited < grid->itemCount; ring++)
+	{
+		double shellCells = ring == 0 ? 1 : 24.0 * ring * ring + 2;
+		if(shellCells > (double)grid->cellsUsed)
+		{
+			/* The shells are now bigger than the occupied part of the grid.
+			 * Finish with a pass over the occupied cells we haven't seen. */
+			for(int32_t c = 0; c < grid->cellCapacity; c++)
+			{
+				const GridCell* cell = &grid->cells[c];
+				if(cell->used &&
+				   (abs(cell->cx - centerX) >= ring ||
+					abs(cell->cy - centerY) >= ring ||
+					abs(cell->cz - centerZ) >= ring))
+				{
+					offerCell(grid, c, x, y, z, maxRadiusSquared, &heap, &visited);
+				}
+			}
+			break;
+		}
+
+		for(int32_t dx = -ring; dx <= ring; dx++)
+		{
+			for(int32_t dy = -ring; dy <= ring; dy++)
+			{
+				bool onFace = dx == -ring || dx == ring || dy == -ring || dy == ring;
+				int32_t step = onFace ? 1 : (ring > 0 ? 2 * ring : 1);
+				for(int32_t dz = -ring; dz <= ring; dz += step)
+				{
+					int32_t cellIndex = findCell(grid, centerX + dx, centerY + dy, centerZ + dz);
+					if(kNoIndex != cellIndex)
+					{
+						offerCell(grid, cellIndex, x, y, z, maxRadiusSquared, &heap, &visited);
+					}
+				}
+			}
+		}
+
+		float reach = (float)ring * grid->cellSize;
+		if(heap.count == heap.capacity && heap.distances[0] <= reach * reach)
+		{
+			break;
+		}
+	}
+
+	/* Heap sort into closest-first order. */
+	size_t count = heap.count;
+	while(heap.count > 1)
+	{
+		void* item = heap.items[0];
+		float distance = heap.distances[0];
+		size_t last = heap.count - 1;
+		void* lastItem = heap.items[last];
+		float lastDistance = heap.distances[last];
+		heap.count = last;
+		heap.items[last] = item;
+		heap.distances[last] = distance;
+
+		size_t i = 0;
+		for(;;)
+		{
+			size_t child = i * 2 + 1;
+			if(child >= heap.count)
+			{
+				break;
+			}
+			if(child + 1 < heap.count && heap.distances[child + 1] > heap.distances[child])
+			{
+				child++;
+			}
+			if(heap.distances[child] <= lastDistance)
+			{
+				break;
+			}
+			heap.items[i] = heap.items[child];
+			heap.distances[i] = heap.distances[child];
+			i = child;
+		}
+		heap.items[i] = lastItem;
+		heap.distances[i] = lastDistance;
+	}
+
+	free(heap.distances);
+	return count;
+}
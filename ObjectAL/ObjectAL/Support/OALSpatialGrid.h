@@ -0,0 +1,140 @@
+//
+//  OALSpatialGrid.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#ifndef HDR_OALSpatialGrid_h
+#define HDR_OALSpatialGrid_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A uniform grid over 3D points, hashed so that only occupied cells use memory.
+ *
+ * ALContext keeps its sources in one of these so that "what's near the
+ * listener" doesn't have to look at every source. Moving an item is O(1),
+ * and a radius query only visits the cells the sphere overlaps.
+ *
+ * Items are opaque pointers. Each item gets a handle when inserted, which
+ * stays valid until it's removed. Not thread safe: the owner does the locking.
+ */
+
+typedef struct OALSpatialGrid OALSpatialGrid;
+
+/** Marks an item that isn't in a grid. */
+#define kOALSpatialGridNoHandle (-1)
+
+/** Create a grid.
+ *
+ * @param cellSize The length of each cell's side. Pick something close to the radius of
+ *                 typical queries.
+ * @return A new grid, or NULL if out of memory.
+ */
+OALSpatialGrid* OALSpatialGridCreate(float cellSize);
+
+/** Destroy a grid.
+ *
+ * @param grid The grid to destroy.
+ */
+void OALSpatialGridDestroy(OALSpatialGrid* grid);
+
+/** Add an item.
+ *
+ * @param grid The grid.
+ * @param item The item to add.
+ * @param x The item's X coordinate.
+ * @param y The item's Y coordinate.
+ * @param z The item's Z coordinate.
+ * @return The item's handle, or kOALSpatialGridNoHandle if out of memory.
+ */
+int32_t OALSpatialGridInsert(OALSpatialGrid* grid, void* item, float x, float y, float z);
+
+/** Move an item. Only touches the grid's cells if the item changes cells.
+ *
+ * @param grid The grid.
+ * @param handle The item's handle.
+ * @param x The item's new X coordinate.
+ * @param y The item's new Y coordinate.
+ * @param z The item's new Z coordinate.
+ */
+void OALSpatialGridMove(OALSpatialGrid* grid, int32_t handle, float x, float y, float z);
+
+/** Remove an item. Its handle may be reused by a later insert.
+ *
+ * @param grid The grid.
+ * @param handle The item's handle.
+ */
+void OALSpatialGridRemove(OALSpatialGrid* grid, int32_t handle);
+
+/** Get the number of items in the grid.
+ *
+ * @param grid The grid.
+ * @return The number of items.
+ */
+size_t OALSpatialGridCount(const OALSpatialGrid* grid);
+
+/** Find all items within a radius of a point.
+ *
+ * @param grid The grid.
+ * @param x The X coordinate of the center.
+ * @param y The Y coordinate of the center.
+ * @param z The Z coordinate of the center.
+ * @param radius The radius.
+ * @param items Receives the items found (may be NULL if maxItems is 0).
+ * @param maxItems The capacity of items.
+ * @return The number of items found, which may be more than maxItems.
+ */
+size_t OALSpatialGridQueryRadius(const OALSpatialGrid* grid,
+								 float x, float y, float z,
+								 float radius,
+								 void** items,
+								 size_t maxItems);
+
+/** Find the items nearest to a point, closest first.
+ *
+ * @param grid The grid.
+ * @param x The X coordinate of the point.
+ * @param y The Y coordinate of the point.
+ * @param z The Z coordinate of the point.
+ * @param maxRadius Ignore items further away than this.
+ * @param items Receives the items found.
+ * @param maxItems How many items to find.
+ * @return The number of items found (at most maxItems).
+ */
+size_t OALSpatialGridQueryNearest(const OALSpatialGrid* grid,
+								  float x, float y, float z,
+								  float maxRadius,
+								  void** items,
+								  size_t maxItems);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDR_OALSpatialGrid_h */
@@ -0,0 +1,69 @@
+//
+//  OALWeakReference.h
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ARCSafe_MemMgmt.h"
+
+
+#pragma mark OALWeakReference
+
+/**
+ * A zeroing weak reference to an object, for work scheduled to run later
+ * (blocks, timers) that shouldn't keep its object alive.
+ *
+ * target reads as nil once the object has started deallocating, under ARC
+ * and manual reference counting alike.
+ */
+@interface OALWeakReference : NSObject
+{
+	as_weak id target;
+}
+
+
+#pragma mark Properties
+
+/** The referenced object (autoreleased), or nil if it has gone away. */
+@property(nonatomic,readonly,assign) id target;
+
+
+#pragma mark Object Management
+
+/** Make a new weak reference.
+ *
+ * @param target The object to reference.
+ * @return A new weak reference.
+ */
++ (id) referenceWithTarget:(id) target;
+
+/** Initialize a weak reference.
+ *
+ * @param target The object to reference.
+ * @return The initialized weak reference.
+ */
+- (id) initWithTarget:(id) target;
+
+@end
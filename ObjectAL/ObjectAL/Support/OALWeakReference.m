@@ -0,0 +1,74 @@
+//
+//  OALWeakReference.m
+//  ObjectAL
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALWeakReference.h"
+#import <objc/runtime.h>
+
+
+@implementation OALWeakReference
+
+#pragma mark Object Management
+
++ (id) referenceWithTarget:(id) target
+{
+	return as_autorelease([[self alloc] initWithTarget:target]);
+}
+
+- (id) initWithTarget:(id) targetIn
+{
+	if(nil != (self = [super init]))
+	{
+#if __has_feature(objc_arc)
+		target = targetIn;
+#else
+		objc_storeWeak(&target, targetIn);
+#endif
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+#if !__has_feature(objc_arc)
+	objc_storeWeak(&target, nil);
+#endif
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+- (id) target
+{
+#if __has_feature(objc_arc)
+	return target;
+#else
+	return objc_loadWeak(&target);
+#endif
+}
+
+@end
@@ -29,6 +29,7 @@
 
 #import "ObjectALConfig.h"
 #import "OALTools.h"
+#import "OALLock.h"
 
 
 /* Don't clobber any existing defines by the same name */
@@ -80,6 +81,41 @@
 #endif /* OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS */
 
 
+/** Protects the following block according to OBJECTAL_CFG_LOCK_POLICY.
+ *
+ * @param OBJ The object being protected (used by the @synchronized policy).
+ * @param LOCK Pointer to the object's OALLock (used by the lightweight policy).
+ */
+#if OBJECTAL_CFG_LOCK_POLICY == OBJECTAL_LOCK_POLICY_LIGHTWEIGHT
+
+#define OPTIONALLY_LOCKED(OBJ, LOCK) OAL_LOCK_SCOPE(LOCK)
+
+#elif OBJECTAL_CFG_LOCK_POLICY == OBJECTAL_LOCK_POLICY_SYNCHRONIZED
+
+#define OPTIONALLY_LOCKED(OBJ, LOCK) @synchronized(OBJ)
+
+#else
+
+#define OPTIONALLY_LOCKED(OBJ, LOCK)
+
+#endif /* OBJECTAL_CFG_LOCK_POLICY */
+
+/** Protects the following block even in single threaded mode (OBJECTAL_LOCK_POLICY_NONE).
+ *
+ * @param OBJ The object being protected (used when the lightweight policy is off).
+ * @param LOCK Pointer to the object's OALLock (used by the lightweight policy).
+ */
+#if OBJECTAL_CFG_LOCK_POLICY == OBJECTAL_LOCK_POLICY_LIGHTWEIGHT
+
+#define ALWAYS_LOCKED(OBJ, LOCK) OAL_LOCK_SCOPE(LOCK)
+
+#else
+
+#define ALWAYS_LOCKED(OBJ, LOCK) @synchronized(OBJ)
+
+#endif /* OBJECTAL_CFG_LOCK_POLICY */
+
+
 #pragma mark -
 #pragma mark Logging
 
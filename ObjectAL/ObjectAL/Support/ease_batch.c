@@ -0,0 +1,214 @@
+/*
+ *  ease_batch.c
+ *  ObjectAL
+ *
+ *  Curves (x is the proportion complete, clamped to 0.0 - 1.0):
+ *  - sine in:      1 - sin((1-x) * pi/2)        (== 1 - cos(x * pi/2))
+ *  - sine out:     sin(x * pi/2)
+ *  - sine in-out:  sin(x * pi/2)^2              (== 0.5 - 0.5 * cos(x * pi))
+ *  - expo in:      2^(10(x-1)), 0 at x == 0
+ *  - expo out:     1 - 2^(-10x), 1 at x == 1
+ *  - expo in-out:  10 * 2^(12(x-0.86)) below 0.5, 1 - 2^(-12(x-0.4165)) above, 0 and 1 at the ends
+ *
+ *  sin(t * pi/2) on [0, 1] is a degree 9 odd polynomial (max error 4e-9).
+ *  2^y is split into 2^floor(y), built directly as float bits, and 2^frac(y),
+ *  a degree 5 polynomial on [0, 1) (max relative error 8e-8).
+ */
+
+#include "ease_batch.h"
+#include <string.h>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define EASE_WIDTH 8
+	typedef __m256 vfloat;
+	typedef __m256 vmask;
+	#define v_set1(X)        _mm256_set1_ps(X)
+	#define v_load(P)        _mm256_loadu_ps(P)
+	#define v_store(P, V)    _mm256_storeu_ps(P, V)
+	#define v_add(A, B)      _mm256_add_ps(A, B)
+	#define v_sub(A, B)      _mm256_sub_ps(A, B)
+	#define v_mul(A, B)      _mm256_mul_ps(A, B)
+	#define v_min(A, B)      _mm256_min_ps(A, B)
+	#define v_max(A, B)      _mm256_max_ps(A, B)
+	#define v_lt(A, B)       _mm256_cmp_ps(A, B, _CMP_LT_OQ)
+	#define v_le(A, B)       _mm256_cmp_ps(A, B, _CMP_LE_OQ)
+	#define v_select(M, A, B) _mm256_blendv_ps(B, A, M)
+	#define v_floor(A)       _mm256_floor_ps(A)
+	#define v_int_bits(A)    _mm256_castsi256_ps(_mm256_cvttps_epi32(A))
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define EASE_WIDTH 4
+	typedef __m128 vfloat;
+	typedef __m128 vmask;
+	#define v_set1(X)        _mm_set1_ps(X)
+	#define v_load(P)        _mm_loadu_ps(P)
+	#define v_store(P, V)    _mm_storeu_ps(P, V)
+	#define v_add(A, B)      _mm_add_ps(A, B)
+	#define v_sub(A, B)      _mm_sub_ps(A, B)
+	#define v_mul(A, B)      _mm_mul_ps(A, B)
+	#define v_min(A, B)      _mm_min_ps(A, B)
+	#define v_max(A, B)      _mm_max_ps(A, B)
+	#define v_lt(A, B)       _mm_cmplt_ps(A, B)
+	#define v_le(A, B)       _mm_cmple_ps(A, B)
+	#define v_select(M, A, B) _mm_or_ps(_mm_and_ps(M, A), _mm_andnot_ps(M, B))
+	#define v_int_bits(A)    _mm_castsi128_ps(_mm_cvttps_epi32(A))
+	/* SSE2 has no floor: truncate, then step down where that rounded up. */
+	static inline vfloat v_floor(vfloat a)
+	{
+		vfloat t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+		return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+	}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define EASE_WIDTH 4
+	typedef float32x4_t vfloat;
+	typedef uint32x4_t vmask;
+	#define v_set1(X)        vdupq_n_f32(X)
+	#define v_load(P)        vld1q_f32(P)
+	#define v_store(P, V)    vst1q_f32(P, V)
+	#define v_add(A, B)      vaddq_f32(A, B)
+	#define v_sub(A, B)      vsubq_f32(A, B)
+	#define v_mul(A, B)      vmulq_f32(A, B)
+	#define v_min(A, B)      vminq_f32(A, B)
+	#define v_max(A, B)      vmaxq_f32(A, B)
+	#define v_lt(A, B)       vcltq_f32(A, B)
+	#define v_le(A, B)       vcleq_f32(A, B)
+	#define v_select(M, A, B) vbslq_f32(M, A, B)
+	#define v_int_bits(A)    vreinterpretq_f32_s32(vcvtq_s32_f32(A))
+	/* ARMv7 NEON has no floor: truncate, then step down where that rounded up. */
+	static inline vfloat v_floor(vfloat a)
+	{
+		vfloat t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+		uint32x4_t stepDown = vandq_u32(vcgtq_f32(t, a), vreinterpretq_u32_f32(vdupq_n_f32(1.0f)));
+		return vsubq_f32(t, vreinterpretq_f32_u32(stepDown));
+	}
+#else
+	#include <math.h>
+	#define EASE_WIDTH 1
+	typedef float vfloat;
+	typedef int vmask;
+	#define v_set1(X)        (X)
+	#define v_load(P)        (*(P))
+	#define v_store(P, V)    (*(P) = (V))
+	#define v_add(A, B)      ((A) + (B))
+	#define v_sub(A, B)      ((A) - (B))
+	#define v_mul(A, B)      ((A) * (B))
+	#define v_min(A, B)      ((A) < (B) ? (A) : (B))
+	#define v_max(A, B)      ((A) > (B) ? (A) : (B))
+	#define v_lt(A, B)       ((A) < (B))
+	#define v_le(A, B)       ((A) <= (B))
+	#define v_select(M, A, B) ((M) ? (A) : (B))
+	#define v_floor(A)       floorf(A)
+	static inline vfloat v_int_bits(vfloat a)
+	{
+		int bits = (int)a;
+		float result;
+		memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+#endif
+
+
+/* Kernels */
+
+/* sin(t * pi/2) for t in [0, 1]. */
+static inline vfloat v_sin_half_pi(vfloat t)
+{
+	vfloat t2 = v_mul(t, t);
+	vfloat p = v_set1(0.000150820522f);
+	p = v_add(v_mul(p, t2), v_set1(-0.00467222783f));
+	p = v_add(v_mul(p, t2), v_set1(0.0796884805f));
+	p = v_add(v_mul(p, t2), v_set1(-0.64596336f));
+	p = v_add(v_mul(p, t2), v_set1(1.57079629f));
+	return v_mul(p, t);
+}
+
+/* 2^y for y in about [-126, 127]. */
+static inline vfloat v_exp2(vfloat y)
+{
+	vfloat n = v_floor(y);
+	vfloat f = v_sub(y, n);
+
+	vfloat p = v_set1(0.00187757689f);
+	p = v_add(v_mul(p, f), v_set1(0.00898933957f));
+	p = v_add(v_mul(p, f), v_set1(0.0558263185f));
+	p = v_add(v_mul(p, f), v_set1(0.240153617f));
+	p = v_add(v_mul(p, f), v_set1(0.693153073f));
+	p = v_add(v_mul(p, f), v_set1(0.999999925f));
+
+	/* (n + 127) << 23 is 2^n as float bits. Multiplying by 2^23 instead of
+	 * shifting keeps this to float ops, which AVX1 and NEON both have. */
+	vfloat scale = v_int_bits(v_mul(v_add(n, v_set1(127.0f)), v_set1(8388608.0f)));
+	return v_mul(p, scale);
+}
+
+static inline vfloat v_ease(int shape, int phase, vfloat x)
+{
+	vfloat zero = v_set1(0.0f);
+	vfloat one = v_set1(1.0f);
+	x = v_min(v_max(x, zero), one);
+
+	if(kEaseBatchShapeSine == shape)
+	{
+		switch(phase)
+		{
+			case kEaseBatchPhaseIn:
+				return v_sub(one, v_sin_half_pi(v_sub(one, x)));
+			case kEaseBatchPhaseOut:
+				return v_sin_half_pi(x);
+			default:
+			{
+				vfloat s = v_sin_half_pi(x);
+				return v_mul(s, s);
+			}
+		}
+	}
+
+	switch(phase)
+	{
+		case kEaseBatchPhaseIn:
+		{
+			vfloat r = v_exp2(v_mul(v_set1(10.0f), v_sub(x, one)));
+			return v_select(v_le(x, zero), zero, r);
+		}
+		case kEaseBatchPhaseOut:
+		{
+			vfloat r = v_sub(one, v_exp2(v_mul(v_set1(-10.0f), x)));
+			return v_select(v_lt(x, one), r, one);
+		}
+		default:
+		{
+			vmask firstHalf = v_lt(x, v_set1(0.5f));
+			vfloat y = v_select(firstHalf,
+								v_mul(v_set1(12.0f), v_sub(x, v_set1(0.86f))),
+								v_mul(v_set1(-12.0f), v_sub(x, v_set1(0.4165f))));
+			vfloat e = v_exp2(y);
+			vfloat r = v_select(firstHalf, v_mul(v_set1(10.0f), e), v_sub(one, e));
+			r = v_select(v_le(x, zero), zero, r);
+			return v_select(v_lt(x, one), r, one);
+		}
+	}
+}
+
+
+/* Interface */
+
+void ease_batch_evaluate(int shape, int phase, const float* input, float* output, size_t count)
+{
+	size_t i = 0;
+	for(; i + EASE_WIDTH <= count; i += EASE_WIDTH)
+	{
+		v_store(output + i, v_ease(shape, phase, v_load(input + i)));
+	}
+
+	/* Run the leftovers through the same kernel via a padded buffer,
+	 * so that every value gets exactly the same approximation. */
+	if(i < count)
+	{
+		float buffer[EASE_WIDTH] = {0};
+		memcpy(buffer, input + i, (count - i) * sizeof(float));
+		v_store(buffer, v_ease(shape, phase, v_load(buffer)));
+		memcpy(output + i, buffer, (count - i) * sizeof(float));
+	}
+}
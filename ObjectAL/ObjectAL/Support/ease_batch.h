@@ -0,0 +1,54 @@
+/*
+ *  ease_batch.h
+ *  ObjectAL
+ *
+ *  Evaluates ease curves for many actions at once, using SIMD polynomial
+ *  approximations instead of sinf/cosf/powf. Uses AVX, SSE2 or NEON when
+ *  the compiler targets them, and plain C otherwise.
+ *
+ *  Error bound (checked by Benchmarks/ease_batch.c): Absolute error below
+ *  5e-7 compared to the exact curves, which is about what the float math in
+ *  sinf/cosf/powf gets. That's far below anything audible in a gain or pitch ramp.
+ */
+
+#ifndef OBJECTAL_EASE_BATCH_H
+#define OBJECTAL_EASE_BATCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Ease curve shapes. Matches OALEaseShape. */
+enum
+{
+	kEaseBatchShapeSine,
+	kEaseBatchShapeExponential,
+	kEaseBatchShapeCount,
+};
+
+/** Ease curve phases. Matches OALEasePhase. */
+enum
+{
+	kEaseBatchPhaseIn,
+	kEaseBatchPhaseOut,
+	kEaseBatchPhaseInOut,
+	kEaseBatchPhaseCount,
+};
+
+/** Apply one ease curve to an array of values.
+ *
+ * @param shape The curve shape (kEaseBatchShapeXYZ).
+ * @param phase The curve phase (kEaseBatchPhaseXYZ).
+ * @param input Proportions complete. Values are clamped to 0.0 - 1.0.
+ * @param output Receives the eased values. May be the same as input.
+ * @param count The number of values.
+ */
+void ease_batch_evaluate(int shape, int phase, const float* input, float* output, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OBJECTAL_EASE_BATCH_H */